@@ -0,0 +1,325 @@
+// =============================================================================
+// ClothReplay — offline runner for BF2GameExt_cloth_<n>.txt captures
+//
+// Replays every captured solve twice, once with the engine's vanilla cylinder
+// collision and once with the fix (cloth_collision_fix.cpp), and reports for
+// each: penetration depth left after the collision pass, energy drift over
+// the run, and ns per particle-iteration.
+//
+// Each scenario starts from the solve's "pre" buffers and is stepped
+// deterministically: Verlet integrate (pos += pos - old, plus optional
+// gravity), one collision pass against the captured cylinders, then — fixed
+// only — the old_pos correction.  Fixed (pinned) particles don't move.
+// EntityCloth's stick constraints aren't mapped, so relaxation isn't
+// replayed; the numbers isolate what the collision step does to the cloth.
+//
+// Energy is per unit mass in capture units per step: 0.5 |pos - old|^2 plus
+// gravity * height.  Collision should never add energy, so drift is the
+// change from the first step to the last, relative to the first.
+//
+// The captured "post" buffers (the live result, with constraints and
+// whichever collision was active) are measured for penetration too, as a
+// reference line.
+//
+// Usage: ClothReplay <capture.txt> [steps] [gravity]
+//   steps   — steps per solve, default 60
+//   gravity — downward acceleration per step^2 along world Y, default 0
+//
+// No engine or Windows dependencies, so it builds anywhere the kernels do:
+//   g++ -O2 -std=c++20 -I PatcherDLL/src ClothReplay/src/main.cpp -o cloth_replay
+// =============================================================================
+
+#include "entity/cloth_kernels.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+struct Cylinder {
+   float mat[16];
+   float halfHeight;
+   float radius;
+};
+
+struct Solve {
+   unsigned           frame = 0;
+   uint32_t           total = 0;
+   uint32_t           fixed = 0;
+   std::vector<float> pos, oldPos;         // pre
+   std::vector<float> postPos, postOldPos; // post
+   std::vector<Cylinder> cylinders;
+};
+
+// ---------------------------------------------------------------------------
+// Capture parsing
+// ---------------------------------------------------------------------------
+
+static bool read_buffers(const char* line, std::vector<float>& pos, std::vector<float>& oldPos)
+{
+   float v[6];
+   if (sscanf(line, "%*s %f %f %f %f %f %f", &v[0], &v[1], &v[2], &v[3], &v[4], &v[5]) != 6)
+      return false;
+   pos.insert(pos.end(), v, v + 3);
+   oldPos.insert(oldPos.end(), v + 3, v + 6);
+   return true;
+}
+
+static bool read_cylinder(const char* line, Cylinder& cyl)
+{
+   const char* p = line + 3;
+   char* end = nullptr;
+   for (int i = 0; i < 18; i++) {
+      float f = strtof(p, &end);
+      if (end == p) return false;
+      if (i < 16)       cyl.mat[i] = f;
+      else if (i == 16) cyl.halfHeight = f;
+      else              cyl.radius = f;
+      p = end;
+   }
+   return true;
+}
+
+static bool load_capture(const char* path, std::vector<Solve>& solves)
+{
+   FILE* f = fopen(path, "r");
+   if (!f) {
+      fprintf(stderr, "ClothReplay: can't open %s\n", path);
+      return false;
+   }
+
+   char  line[1024];
+   int   lineNo = 0;
+   Solve cur;
+   bool  open = false;
+
+   while (fgets(line, sizeof(line), f)) {
+      lineNo++;
+      if (line[0] == '#' || line[0] == '\n' || line[0] == '\r') continue;
+
+      if (strncmp(line, "solve ", 6) == 0) {
+         cur = Solve{};
+         void* cloth = nullptr;
+         open = sscanf(line, "solve %p %u %u %u", &cloth, &cur.frame, &cur.total, &cur.fixed) == 4;
+      }
+      else if (!open) {
+         continue;
+      }
+      else if (strncmp(line, "pre ", 4) == 0) {
+         open = read_buffers(line, cur.pos, cur.oldPos);
+      }
+      else if (strncmp(line, "post ", 5) == 0) {
+         open = read_buffers(line, cur.postPos, cur.postOldPos);
+      }
+      else if (strncmp(line, "cyl ", 4) == 0) {
+         Cylinder cyl;
+         open = read_cylinder(line, cyl);
+         if (open) cur.cylinders.push_back(cyl);
+      }
+      else if (strncmp(line, "end", 3) == 0) {
+         // Solves cut short by a level change have no (or a partial) post
+         if (cur.pos.size() == (size_t)cur.total * 3 && cur.fixed <= cur.total)
+            solves.push_back(std::move(cur));
+         open = false;
+      }
+
+      if (!open && strncmp(line, "end", 3) != 0)
+         fprintf(stderr, "ClothReplay: %s:%d: malformed line, skipping solve\n", path, lineNo);
+   }
+
+   fclose(f);
+   return true;
+}
+
+// ---------------------------------------------------------------------------
+// Metrics
+// ---------------------------------------------------------------------------
+
+// Depth of pos inside the cylinder (0 outside), measured against the true
+// shape — halfHeight from the center, as the fixed kernel uses.  Particles
+// the kernel left on the surface read as ~1e-8 from rounding, so anything
+// under kSurfaceEps counts as outside.
+static constexpr float kSurfaceEps = 1e-5f;
+
+static float penetration(const float* p, const Cylinder& c)
+{
+   const float* m = c.mat;
+   float dx = p[0] - m[12], dy = p[1] - m[13], dz = p[2] - m[14];
+
+   float heightPen = c.halfHeight - fabsf(dx * m[4] + dy * m[5] + dz * m[6]);
+   if (heightPen <= 0.0f) return 0.0f;
+
+   float rx = dx * m[0] + dy * m[1] + dz * m[2];
+   float rz = dx * m[8] + dy * m[9] + dz * m[10];
+   float radialPen = c.radius - sqrtf(rx * rx + rz * rz);
+   if (radialPen <= 0.0f) return 0.0f;
+
+   return heightPen < radialPen ? heightPen : radialPen;
+}
+
+struct Penetration {
+   double   sum = 0.0;
+   float    max = 0.0f;
+   uint64_t inside = 0;
+   uint64_t samples = 0;
+
+   void measure(const float* pos, uint32_t first, uint32_t total, const std::vector<Cylinder>& cyls)
+   {
+      for (uint32_t i = first; i < total; i++) {
+         float depth = 0.0f;
+         for (const Cylinder& c : cyls) {
+            float d = penetration(pos + i * 3, c);
+            if (d > depth) depth = d;
+         }
+         if (depth > kSurfaceEps) {
+            inside++;
+            sum += depth;
+            if (depth > max) max = depth;
+         }
+         samples++;
+      }
+   }
+};
+
+static double energy(const float* pos, const float* oldPos, uint32_t first, uint32_t total, float gravity)
+{
+   double e = 0.0;
+   for (uint32_t i = first; i < total; i++) {
+      const float* p = pos + i * 3;
+      const float* o = oldPos + i * 3;
+      double vx = p[0] - o[0], vy = p[1] - o[1], vz = p[2] - o[2];
+      e += 0.5 * (vx * vx + vy * vy + vz * vz) + (double)gravity * p[1];
+   }
+   return e;
+}
+
+// ---------------------------------------------------------------------------
+// Replay
+// ---------------------------------------------------------------------------
+
+struct ModeResult {
+   Penetration pen;
+   double      driftSum = 0.0;
+   double      driftMax = 0.0;
+   int         driftSamples = 0;
+   double      ns = 0.0;
+   uint64_t    particleIterations = 0;
+   uint64_t    corrected = 0;
+};
+
+static void replay(const Solve& s, bool fixedMode, int steps, float gravity, ModeResult& r)
+{
+   const uint32_t first = s.fixed;
+   const uint32_t moving = s.total - first;
+   if (!moving || s.cylinders.empty()) return;
+
+   std::vector<float> pos(s.pos), oldPos(s.oldPos), before(pos.size());
+   float* p = pos.data() + first * 3;
+   float* o = oldPos.data() + first * 3;
+   float* b = before.data() + first * 3;
+
+   double e0 = 0.0, e1 = 0.0;
+   std::chrono::steady_clock::duration elapsed{};
+
+   for (int step = 0; step < steps; step++) {
+      auto t0 = std::chrono::steady_clock::now();
+
+      for (uint32_t i = 0; i < moving * 3; i += 3) {
+         for (int k = 0; k < 3; k++) {
+            float cur = p[i + k];
+            p[i + k] += cur - o[i + k];
+            o[i + k] = cur;
+         }
+         p[i + 1] -= gravity;
+      }
+
+      if (fixedMode) {
+         memcpy(b, p, moving * 3 * sizeof(float));
+         for (const Cylinder& c : s.cylinders)
+            cloth_collide_cylinder(p, moving, c.mat, c.halfHeight, c.radius);
+         r.corrected += cloth_correct_old_pos(p, b, o, moving);
+      }
+      else {
+         for (const Cylinder& c : s.cylinders)
+            for (uint32_t i = 0; i < moving; i++)
+               cloth_cylinder_vanilla_scalar(p + i * 3, c.mat, c.halfHeight, c.radius);
+      }
+
+      elapsed += std::chrono::steady_clock::now() - t0;
+
+      r.pen.measure(pos.data(), first, s.total, s.cylinders);
+
+      double e = energy(pos.data(), oldPos.data(), first, s.total, gravity);
+      if (step == 0) e0 = e;
+      e1 = e;
+   }
+
+   r.ns += (double)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+   r.particleIterations += (uint64_t)moving * steps;
+
+   if (e0 > 1e-12 || e0 < -1e-12) {
+      double drift = (e1 - e0) / fabs(e0);
+      r.driftSum += drift;
+      if (fabs(drift) > fabs(r.driftMax)) r.driftMax = drift;
+      r.driftSamples++;
+   }
+}
+
+static void print_mode(const char* name, const ModeResult& r)
+{
+   const Penetration& p = r.pen;
+   printf("%-8s  inside %6.2f%%  depth mean %.6f max %.6f  drift mean %+8.2f%% worst %+8.2f%%  %6.2f ns/particle-iter",
+          name,
+          p.samples ? 100.0 * p.inside / p.samples : 0.0,
+          p.inside ? p.sum / p.inside : 0.0, p.max,
+          r.driftSamples ? 100.0 * r.driftSum / r.driftSamples : 0.0, 100.0 * r.driftMax,
+          r.particleIterations ? r.ns / r.particleIterations : 0.0);
+   if (r.corrected) printf("  %llu old_pos corrections", (unsigned long long)r.corrected);
+   printf("\n");
+}
+
+int main(int argc, char** argv)
+{
+   if (argc < 2) {
+      fprintf(stderr, "usage: ClothReplay <capture.txt> [steps] [gravity]\n");
+      return 2;
+   }
+
+   int   steps   = argc > 2 ? atoi(argv[2]) : 60;
+   float gravity = argc > 3 ? strtof(argv[3], nullptr) : 0.0f;
+   if (steps < 1) steps = 1;
+
+   std::vector<Solve> solves;
+   if (!load_capture(argv[1], solves)) return 1;
+   if (solves.empty()) {
+      fprintf(stderr, "ClothReplay: no complete solves in %s\n", argv[1]);
+      return 1;
+   }
+
+   uint64_t particles = 0, cylinders = 0;
+   Penetration captured;
+   for (const Solve& s : solves) {
+      particles += s.total - s.fixed;
+      cylinders += s.cylinders.size();
+      if (s.postPos.size() == s.pos.size())
+         captured.measure(s.postPos.data(), s.fixed, s.total, s.cylinders);
+   }
+
+   printf("%s: %zu solves, %llu moving particles, %llu cylinders, %d steps, gravity %g\n",
+          argv[1], solves.size(), (unsigned long long)particles, (unsigned long long)cylinders,
+          steps, gravity);
+
+   ModeResult vanilla, fixed;
+   for (const Solve& s : solves) {
+      replay(s, false, steps, gravity, vanilla);
+      replay(s, true, steps, gravity, fixed);
+   }
+
+   print_mode("vanilla", vanilla);
+   print_mode("fixed", fixed);
+   printf("%-8s  inside %6.2f%%  depth mean %.6f max %.6f\n", "captured",
+          captured.samples ? 100.0 * captured.inside / captured.samples : 0.0,
+          captured.inside ? captured.sum / captured.inside : 0.0, captured.max);
+   return 0;
+}
@@ -1,8 +1,10 @@
 #include "pch.h"
 #include "aim_assist.hpp"
 #include "controller_support.hpp"
+#include "player_controller_update.hpp"
 #include "util/ini_config.hpp"
 #include "core/resolve.hpp"
+#include "debug_commands/ext_perf.hpp"
 
 #include <detours.h>
 #include <cmath>
@@ -74,7 +76,6 @@ void aim_assist_load_config(const char* ini_path)
 // ---------------------------------------------------------------------------
 
 struct AimAssistAddrs {
-    uintptr_t player_controller_update;
     uintptr_t apply_damage;
     uintptr_t lockon_mgr_array;
     uintptr_t get_cur_wpn;
@@ -87,7 +88,6 @@ struct AimAssistAddrs {
 };
 
 static constexpr AimAssistAddrs MODTOOLS_ADDRS = {
-    game_addrs::modtools::player_controller_update,
     game_addrs::modtools::apply_damage,
     game_addrs::modtools::lockon_mgr_array,
     game_addrs::modtools::get_cur_wpn,
@@ -100,7 +100,6 @@ static constexpr AimAssistAddrs MODTOOLS_ADDRS = {
 };
 
 static constexpr AimAssistAddrs STEAM_ADDRS = {
-    game_addrs::steam::player_controller_update,
     game_addrs::steam::apply_damage,
     game_addrs::steam::lockon_mgr_array,
     game_addrs::steam::get_cur_wpn,
@@ -113,7 +112,6 @@ static constexpr AimAssistAddrs STEAM_ADDRS = {
 };
 
 static constexpr AimAssistAddrs GOG_ADDRS = {
-    game_addrs::gog::player_controller_update,
     game_addrs::gog::apply_damage,
     game_addrs::gog::lockon_mgr_array,
     game_addrs::gog::get_cur_wpn,
@@ -373,18 +371,14 @@ static bool __fastcall hooked_ApplyDamage6(void* thisPtr, void* /*edx*/,
 }
 
 // ---------------------------------------------------------------------------
-// Hook: PlayerController::Update
+// After PlayerController::Update
 // ---------------------------------------------------------------------------
 
-// __thiscall, float dt param, RET 4
-using fn_PlayerControllerUpdate = void(__thiscall*)(void* thisPtr, float dt);
-static fn_PlayerControllerUpdate original_PCUpdate = nullptr;
+static bool s_installed = false;
 
-static void __fastcall hooked_PCUpdate(void* thisPtr, void* /*edx*/, float dt)
+// Runs after the engine's update, which writes mControlTurn/mControlPitch
+static void update_aim_assist(void* thisPtr, float dt)
 {
-    // Call original — writes mControlTurn/mControlPitch to Controllable
-    original_PCUpdate(thisPtr, dt);
-
     // Base guards
     if (!s_aimAssistEnabled || !g_controllerEnabled || !is_joystick_connected()) {
         s_currentWpnIsMelee = false;
@@ -849,6 +843,11 @@ static void __fastcall hooked_PCUpdate(void* thisPtr, void* /*edx*/, float dt)
     }
 }
 
+static void on_pc_update(void* thisPtr, float dt)
+{
+    ext_perf_call(kExtPerf_AimAssist, [&] { update_aim_assist(thisPtr, dt); });
+}
+
 // ---------------------------------------------------------------------------
 // Install / Uninstall
 // ---------------------------------------------------------------------------
@@ -871,39 +870,39 @@ void aim_assist_install(uintptr_t exe_base)
     s_setTargetLockedObj = (fn_SetTargetLockedObj)resolve(exe_base, s_addrs->set_target_locked_obj);
     s_teamGetObjectsInRange = (fn_TeamGetObjectsInRange)resolve(exe_base, s_addrs->team_get_objects_in_range);
 
-    original_PCUpdate = (fn_PlayerControllerUpdate)resolve(exe_base, s_addrs->player_controller_update);
-
-    DetourTransactionBegin();
-    DetourUpdateThread(GetCurrentThread());
-    DetourAttach(&(PVOID&)original_PCUpdate, hooked_PCUpdate);
+    pc_update_after(on_pc_update);
+    s_installed = true;
 
     // Auto-lock-on-hit
     if (s_autoLockOnHit) {
         original_ApplyDamage6 = (fn_ApplyDamage6)resolve(exe_base, s_addrs->apply_damage);
-        DetourAttach(&(PVOID&)original_ApplyDamage6, hooked_ApplyDamage6);
-    }
 
-    LONG result = DetourTransactionCommit();
+        DetourTransactionBegin();
+        DetourUpdateThread(GetCurrentThread());
+        DetourAttach(&(PVOID&)original_ApplyDamage6, hooked_ApplyDamage6);
+        LONG result = DetourTransactionCommit();
 
-    if (result != NO_ERROR) {
-        if (s_log) s_log("[AimAssist] ERROR: Detours commit failed (%ld)\n", result);
-        original_PCUpdate = nullptr;
-        original_ApplyDamage6 = nullptr;
+        if (result != NO_ERROR) {
+            if (s_log) s_log("[AimAssist] ERROR: Detours commit failed (%ld)\n", result);
+            original_ApplyDamage6 = nullptr;
+        }
     }
 }
 
 void aim_assist_uninstall()
 {
-    if (!original_PCUpdate) return;
+    if (!s_installed) return;
 
-    DetourTransactionBegin();
-    DetourUpdateThread(GetCurrentThread());
-    DetourDetach(&(PVOID&)original_PCUpdate, hooked_PCUpdate);
-    if (original_ApplyDamage6)
+    pc_update_remove(on_pc_update);
+    s_installed = false;
+
+    if (original_ApplyDamage6) {
+        DetourTransactionBegin();
+        DetourUpdateThread(GetCurrentThread());
         DetourDetach(&(PVOID&)original_ApplyDamage6, hooked_ApplyDamage6);
-    DetourTransactionCommit();
+        DetourTransactionCommit();
+    }
 
-    original_PCUpdate = nullptr;
     original_ApplyDamage6 = nullptr;
     s_getCurWpn = nullptr;
     s_setTargetLockedObj = nullptr;
@@ -5,7 +5,7 @@
 // =============================================================================
 // Aim assist — ported from Xbox Controllable::UpdateTargetLockedObjTracking
 //
-// Hooks PlayerController::Update to apply:
+// Runs after PlayerController::Update to apply:
 //   1. Proximity friction — omnidirectional stick slowdown near enemies
 //   2. Auto-tracking — camera pull toward locked target
 //   3. Directional friction — stick resistance when moving away from lock
@@ -0,0 +1,91 @@
+#include "pch.h"
+#include "player_controller_update.hpp"
+#include "core/resolve.hpp"
+
+#include <detours.h>
+
+static constexpr int kMaxCallbacks = 8;
+
+// __thiscall, float dt param, RET 4
+using PCUpdate_t = void(__thiscall*)(void* thisPtr, float dt);
+
+static PCUpdate_t s_origPCUpdate = nullptr;
+
+struct CallbackList {
+   PCUpdateCallback fns[kMaxCallbacks];
+   int              count;
+};
+
+static CallbackList s_before = {};
+static CallbackList s_after  = {};
+
+static void list_add(CallbackList& l, PCUpdateCallback fn)
+{
+   for (int i = 0; i < l.count; i++)
+      if (l.fns[i] == fn) return;
+   if (l.count < kMaxCallbacks) l.fns[l.count++] = fn;
+}
+
+static void list_remove(CallbackList& l, PCUpdateCallback fn)
+{
+   for (int i = 0; i < l.count; i++) {
+      if (l.fns[i] != fn) continue;
+      for (int j = i + 1; j < l.count; j++) l.fns[j - 1] = l.fns[j];
+      l.count--;
+      return;
+   }
+}
+
+void pc_update_before(PCUpdateCallback fn) { list_add(s_before, fn); }
+void pc_update_after(PCUpdateCallback fn)  { list_add(s_after, fn); }
+
+void pc_update_remove(PCUpdateCallback fn)
+{
+   list_remove(s_before, fn);
+   list_remove(s_after, fn);
+}
+
+// ---------------------------------------------------------------------------
+// Hook: PlayerController::Update
+// ---------------------------------------------------------------------------
+
+static void __fastcall hooked_PCUpdate(void* thisPtr, void* /*edx*/, float dt)
+{
+   for (int i = 0; i < s_before.count; i++) s_before.fns[i](thisPtr, dt);
+   s_origPCUpdate(thisPtr, dt);
+   for (int i = 0; i < s_after.count; i++) s_after.fns[i](thisPtr, dt);
+}
+
+// ---------------------------------------------------------------------------
+// Install / Uninstall
+// ---------------------------------------------------------------------------
+
+void player_controller_update_install(uintptr_t exe_base)
+{
+   // TODO: select per build (see aim_assist.cpp) once exe identification exists
+   s_origPCUpdate = (PCUpdate_t)resolve(exe_base, game_addrs::modtools::player_controller_update);
+
+   DetourTransactionBegin();
+   DetourUpdateThread(GetCurrentThread());
+   DetourAttach(&(PVOID&)s_origPCUpdate, hooked_PCUpdate);
+   LONG result = DetourTransactionCommit();
+
+   if (result != NO_ERROR) {
+      get_gamelog()("[PCUpdate] ERROR: Detours commit failed (%ld)\n", result);
+      s_origPCUpdate = nullptr;
+   }
+}
+
+void player_controller_update_uninstall()
+{
+   if (s_origPCUpdate) {
+      DetourTransactionBegin();
+      DetourUpdateThread(GetCurrentThread());
+      DetourDetach(&(PVOID&)s_origPCUpdate, hooked_PCUpdate);
+      DetourTransactionCommit();
+      s_origPCUpdate = nullptr;
+   }
+
+   s_before.count = 0;
+   s_after.count  = 0;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stdint.h>
+
+// =============================================================================
+// PlayerController::Update — one detour, shared by every module that needs
+// the local player's per-frame tick
+//
+// Modules register a callback to run before or after the engine's update
+// instead of each detouring the function themselves:
+//
+//   before — frame clock attach, XInput latency probe
+//   after  — aim assist (reads the engine's mControlTurn/mControlPitch),
+//            ExtPerf overlay
+//
+// Callbacks run in registration order and may be registered or removed at
+// any time on the game thread.  The detour is attached by
+// player_controller_update_install() whether or not anything registered.
+// =============================================================================
+
+using PCUpdateCallback = void(*)(void* controller, float dt);
+
+// Up to 8 per side; registering the same function twice is a no-op.
+void pc_update_before(PCUpdateCallback fn);
+void pc_update_after(PCUpdateCallback fn);
+
+// Drop fn from both sides.
+void pc_update_remove(PCUpdateCallback fn);
+
+void player_controller_update_install(uintptr_t exe_base);
+void player_controller_update_uninstall();
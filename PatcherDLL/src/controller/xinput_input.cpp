@@ -0,0 +1,346 @@
+#include "pch.h"
+#include "xinput_input.hpp"
+#include "controller_support.hpp"
+#include "player_controller_update.hpp"
+#include "core/resolve.hpp"
+
+#include <cmath>
+#include <string.h>
+
+bool g_xinputProbeEnabled = false;
+int  g_xinputPollHz         = 250;
+
+// ---------------------------------------------------------------------------
+// GameLog
+// ---------------------------------------------------------------------------
+
+static GameLog_t g_log = nullptr;
+
+// ---------------------------------------------------------------------------
+// XInput dynamic loading -- same DLL search order as controller_rumble.cpp
+// ---------------------------------------------------------------------------
+
+struct XINPUT_GAMEPAD {
+   WORD  wButtons;
+   BYTE  bLeftTrigger;
+   BYTE  bRightTrigger;
+   SHORT sThumbLX;
+   SHORT sThumbLY;
+   SHORT sThumbRX;
+   SHORT sThumbRY;
+};
+
+struct XINPUT_STATE {
+   DWORD          dwPacketNumber;
+   XINPUT_GAMEPAD Gamepad;
+};
+
+typedef DWORD(WINAPI* PFN_XInputGetState)(DWORD dwUserIndex, XINPUT_STATE* pState);
+
+static HMODULE            s_xinputDll      = nullptr;
+static PFN_XInputGetState s_XInputGetState = nullptr;
+
+static bool load_xinput()
+{
+   const char* dllNames[] = { "xinput1_3.dll", "xinput1_4.dll", "xinput9_1_0.dll" };
+   for (auto name : dllNames) {
+      s_xinputDll = LoadLibraryA(name);
+      if (s_xinputDll) {
+         s_XInputGetState = (PFN_XInputGetState)GetProcAddress(s_xinputDll, "XInputGetState");
+         if (s_XInputGetState) {
+            if (g_log) g_log("[XInput] Loaded %s\n", name);
+            return true;
+         }
+         FreeLibrary(s_xinputDll);
+         s_xinputDll = nullptr;
+      }
+   }
+   if (g_log) g_log("[XInput] No XInput DLL found\n");
+   return false;
+}
+
+static constexpr DWORD kUserIndex = 0;   // local player pad
+
+// ---------------------------------------------------------------------------
+// Latest-sample slot -- single producer (poll thread), single consumer (game
+// thread). Seqlock: writer makes mSeq odd while writing, even when done.
+// ---------------------------------------------------------------------------
+
+struct XInputSample {
+   LONGLONG       qpc;          // when this packet was first seen
+   LONGLONG       pendingQpc;   // first packet change not yet consumed by the game
+   DWORD          packet;
+};
+
+static volatile LONG  s_seq      = 0;
+static XInputSample   s_sample   = {};
+static volatile LONG  s_consumed = 1;   // a frame has seen every change so far
+static volatile LONG  s_connected = 0;
+
+static volatile LONG  s_pollCount = 0;
+
+static void publish_sample(const XINPUT_STATE& st, LONGLONG now)
+{
+   InterlockedIncrement(&s_seq);
+   s_sample.qpc    = now;
+   s_sample.packet = st.dwPacketNumber;
+   if (InterlockedExchange(&s_consumed, 0)) s_sample.pendingQpc = now;
+   InterlockedIncrement(&s_seq);
+}
+
+static bool read_sample(XInputSample* out)
+{
+   for (int tries = 0; tries < 64; ++tries) {
+      const LONG s1 = s_seq;
+      if (s1 & 1) { YieldProcessor(); continue; }
+      MemoryBarrier();
+      *out = s_sample;
+      MemoryBarrier();
+      if (s_seq == s1) return s1 != 0;
+   }
+   return false;
+}
+
+// ---------------------------------------------------------------------------
+// Poll thread
+// ---------------------------------------------------------------------------
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+static HANDLE s_pollThread = nullptr;
+static HANDLE s_stopEvent  = nullptr;
+
+// XInputGetState on an empty slot is expensive -- back off while unplugged.
+static constexpr DWORD kDisconnectedPollMs = 250;
+
+static DWORD WINAPI poll_thread(LPVOID)
+{
+   SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_ABOVE_NORMAL);
+
+   int hz = g_xinputPollHz;
+   if (hz < 60)   hz = 60;
+   if (hz > 8000) hz = 8000;
+   const LONGLONG periodHns = 10000000LL / hz;   // 100 ns units
+
+   // High-resolution waitable timer (Win10 1803+); fall back to a plain
+   // timer, which is limited by the system timer resolution.
+   HANDLE timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION,
+                                         TIMER_ALL_ACCESS);
+   if (!timer) timer = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+   if (!timer) return 1;
+
+   HANDLE waits[2] = { s_stopEvent, timer };
+   DWORD  lastPacket = 0;
+   bool   havePacket = false;
+
+   for (;;) {
+      XINPUT_STATE st = {};
+      const DWORD rc = s_XInputGetState(kUserIndex, &st);
+      InterlockedIncrement(&s_pollCount);
+
+      LONGLONG delay = -periodHns;
+      if (rc == ERROR_SUCCESS) {
+         InterlockedExchange(&s_connected, 1);
+         if (!havePacket || st.dwPacketNumber != lastPacket) {
+            LARGE_INTEGER now;
+            QueryPerformanceCounter(&now);
+            publish_sample(st, now.QuadPart);
+            lastPacket = st.dwPacketNumber;
+            havePacket = true;
+         }
+      } else {
+         InterlockedExchange(&s_connected, 0);
+         havePacket = false;
+         delay = -(LONGLONG)kDisconnectedPollMs * 10000;
+      }
+
+      LARGE_INTEGER due;
+      due.QuadPart = delay;
+      SetWaitableTimer(timer, &due, 0, nullptr, nullptr, FALSE);
+      if (WaitForMultipleObjects(2, waits, FALSE, INFINITE) == WAIT_OBJECT_0) break;
+   }
+
+   CloseHandle(timer);
+   return 0;
+}
+
+// ---------------------------------------------------------------------------
+// Input age statistics -- 0.1 ms histogram buckets, last bucket is overflow
+// ---------------------------------------------------------------------------
+
+static constexpr int   kAgeBuckets     = 512;
+static constexpr float kAgeBucketMs    = 0.1f;
+static constexpr float kReportInterval = 10.0f;  // seconds
+
+static LARGE_INTEGER s_perfFreq;
+
+static unsigned s_ageHist[kAgeBuckets];
+static unsigned s_ageCount   = 0;
+static double   s_ageSumMs   = 0.0;
+static float    s_ageMaxMs   = 0.0f;
+static double   s_frameSumMs = 0.0;
+static unsigned s_frameCount = 0;
+static LONG     s_pollsAtWindowStart = 0;
+
+static LONGLONG s_lastFrameQpc  = 0;
+static LONGLONG s_windowStart   = 0;
+static DWORD    s_lastPacketSeen = 0;
+static bool     s_seenAny        = false;
+
+static inline float qpc_to_ms(LONGLONG ticks)
+{
+   if (s_perfFreq.QuadPart == 0) return 0.0f;
+   return (float)((double)ticks * 1000.0 / (double)s_perfFreq.QuadPart);
+}
+
+static void record_age(float ms)
+{
+   int b = (int)(ms / kAgeBucketMs);
+   if (b < 0) b = 0;
+   if (b >= kAgeBuckets) b = kAgeBuckets - 1;
+   s_ageHist[b]++;
+   s_ageCount++;
+   s_ageSumMs += ms;
+   if (ms > s_ageMaxMs) s_ageMaxMs = ms;
+}
+
+static float age_percentile(float p)
+{
+   if (s_ageCount == 0) return 0.0f;
+   const unsigned target = (unsigned)ceilf(p * (float)s_ageCount);
+   unsigned acc = 0;
+   for (int i = 0; i < kAgeBuckets; ++i) {
+      acc += s_ageHist[i];
+      if (acc >= target) return (float)(i + 1) * kAgeBucketMs;
+   }
+   return (float)kAgeBuckets * kAgeBucketMs;
+}
+
+void xinput_input_get_stats(XInputAgeStats* out)
+{
+   if (!out) return;
+   out->samples    = s_ageCount;
+   out->polls      = (unsigned)(s_pollCount - s_pollsAtWindowStart);
+   out->avgMs      = s_ageCount ? (float)(s_ageSumMs / s_ageCount) : 0.0f;
+   out->p50Ms      = age_percentile(0.50f);
+   out->p95Ms      = age_percentile(0.95f);
+   out->maxMs      = s_ageMaxMs;
+   out->frameAvgMs = s_frameCount ? (float)(s_frameSumMs / s_frameCount) : 0.0f;
+}
+
+static void reset_stats_window(LONGLONG now)
+{
+   memset(s_ageHist, 0, sizeof(s_ageHist));
+   s_ageCount   = 0;
+   s_ageSumMs   = 0.0;
+   s_ageMaxMs   = 0.0f;
+   s_frameSumMs = 0.0;
+   s_frameCount = 0;
+   s_pollsAtWindowStart = s_pollCount;
+   s_windowStart = now;
+}
+
+static void report_stats(LONGLONG now)
+{
+   XInputAgeStats st;
+   xinput_input_get_stats(&st);
+   const float windowSec = qpc_to_ms(now - s_windowStart) / 1000.0f;
+
+   // With once-per-frame DirectInput polling a change waits on average half
+   // a frame before being sampled, so frameAvg/2 is the vanilla baseline.
+   if (g_log && st.samples) {
+      g_log("[XInput] samples=%u poll=%.0fHz age avg=%.2fms p50=%.1fms p95=%.1fms max=%.2fms"
+            " | frame avg=%.2fms (DI baseline ~%.2fms)\n",
+            st.samples, windowSec > 0.0f ? (float)st.polls / windowSec : 0.0f,
+            st.avgMs, st.p50Ms, st.p95Ms, st.maxMs, st.frameAvgMs, st.frameAvgMs * 0.5f);
+   }
+   reset_stats_window(now);
+}
+
+// ---------------------------------------------------------------------------
+// Before PlayerController::Update
+// ---------------------------------------------------------------------------
+
+static bool s_installed = false;
+
+static void on_pc_update(void* /*controller*/, float /*dt*/)
+{
+   LARGE_INTEGER now;
+   QueryPerformanceCounter(&now);
+
+   if (s_lastFrameQpc) {
+      s_frameSumMs += qpc_to_ms(now.QuadPart - s_lastFrameQpc);
+      s_frameCount++;
+   }
+   s_lastFrameQpc = now.QuadPart;
+
+   XInputSample sample;
+   if (g_controllerEnabled && s_connected && read_sample(&sample)) {
+      if (!s_seenAny || sample.packet != s_lastPacketSeen) {
+         record_age(qpc_to_ms(now.QuadPart - sample.pendingQpc));
+         s_lastPacketSeen = sample.packet;
+         s_seenAny = true;
+         InterlockedExchange(&s_consumed, 1);
+      }
+   }
+
+   if (qpc_to_ms(now.QuadPart - s_windowStart) >= kReportInterval * 1000.0f)
+      report_stats(now.QuadPart);
+}
+
+// ---------------------------------------------------------------------------
+// Install / Uninstall
+// ---------------------------------------------------------------------------
+
+void xinput_input_install(uintptr_t /*exe_base*/)
+{
+   if (!g_xinputProbeEnabled) return;
+   if (s_installed) return;
+
+   g_log = get_gamelog();
+
+   if (!load_xinput()) {
+      g_xinputProbeEnabled = false;
+      return;
+   }
+
+   QueryPerformanceFrequency(&s_perfFreq);
+   LARGE_INTEGER now;
+   QueryPerformanceCounter(&now);
+   reset_stats_window(now.QuadPart);
+
+   pc_update_before(on_pc_update);
+   s_installed = true;
+
+   s_stopEvent  = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+   s_pollThread = s_stopEvent ? CreateThread(nullptr, 0, poll_thread, nullptr, 0, nullptr) : nullptr;
+
+   if (g_log) g_log("[XInput] Latency probe installed (poll=%d Hz)\n", g_xinputPollHz);
+}
+
+void xinput_input_uninstall()
+{
+   if (s_installed) {
+      pc_update_remove(on_pc_update);
+      s_installed = false;
+   }
+
+   if (s_pollThread) {
+      SetEvent(s_stopEvent);
+      WaitForSingleObject(s_pollThread, 1000);
+      CloseHandle(s_pollThread);
+      s_pollThread = nullptr;
+   }
+   if (s_stopEvent) {
+      CloseHandle(s_stopEvent);
+      s_stopEvent = nullptr;
+   }
+
+   s_XInputGetState = nullptr;
+   if (s_xinputDll) {
+      FreeLibrary(s_xinputDll);
+      s_xinputDll = nullptr;
+   }
+}
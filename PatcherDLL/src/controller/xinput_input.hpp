@@ -0,0 +1,44 @@
+#pragma once
+
+#include "pch.h"
+
+// =============================================================================
+// XInput Latency Probe -- measures gamepad input age against the frame rate
+// =============================================================================
+// The vanilla gamepad path polls DirectInput once per game frame, so a
+// change waits on average half a frame before the game sees it.  When
+// enabled, this probe polls XInputGetState on a dedicated thread, stamps
+// every packet change with QPC, and at PlayerController::Update records
+// how old the newest change is.  It only reads the pad; the game keeps
+// getting its input from DirectInput.
+//
+// The poll rate defaults to 250 Hz: wired XInput pads report at most every
+// 8 ms (125 Hz), so polling twice per report bounds the added age to ~4 ms.
+//
+// Input age (time from XInput packet change to the frame after it) is
+// logged every 10 s as "[XInput] ..." lines, next to the frame interval.
+
+// Per-sample input age statistics (window since the last report).
+struct XInputAgeStats {
+   unsigned samples;      // new packets seen at a frame
+   unsigned polls;        // XInputGetState calls made by the poll thread
+   float    avgMs;
+   float    p50Ms;
+   float    p95Ms;
+   float    maxMs;
+   float    frameAvgMs;   // mean PlayerController::Update interval
+};
+
+// Start the poll thread and register before PlayerController::Update.
+// No-op unless g_xinputProbeEnabled is set.
+void xinput_input_install(uintptr_t exe_base);
+
+// Stop the poll thread, unregister, and release the XInput library.
+void xinput_input_uninstall();
+
+// Copy the current statistics window (does not reset it).
+void xinput_input_get_stats(XInputAgeStats* out);
+
+// Global config (set from INI before xinput_input_install)
+extern bool g_xinputProbeEnabled;
+extern int  g_xinputPollHz;
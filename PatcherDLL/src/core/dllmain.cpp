@@ -6,7 +6,17 @@
 #include "controller/controller_support.hpp"
 #include "controller/controller_rumble.hpp"
 #include "controller/aim_assist.hpp"
+#include "controller/xinput_input.hpp"
+#include "loading_screen/load_profiler.hpp"
+#include "loading_screen/lvl_prefetch.hpp"
+#include "loading_screen/frame_pacer.hpp"
 #include "entity/soldier_prone.hpp"
+#include "entity/flyer_boost_animation.hpp"
+#include "entity/cloth_lod.hpp"
+#include "entity/cloth_capture.hpp"
+#include "entity/cloth_collision_fix.hpp"
+#include "debug_commands/ext_perf.hpp"
+#include "memory/red_heap_profiler.hpp"
 #include "util/ini_config.hpp"
 #include "util/slim_vector.hpp"
 
@@ -122,6 +132,27 @@ static void install_patches_impl(uintptr_t exe_base, const char* ini_path)
       g_proneEnabled = cfg.get_bool("Features", "Prone", true);
       g_controllerEnabled = cfg.get_bool("Controller", "Enabled", true);
       g_rumbleEnabled = cfg.get_bool("Controller", "Rumble", true);
+      g_loadFrameBudgetMs = cfg.get_float("LoadScreen", "FrameBudgetMs", 33.3f);
+      g_loadPacingMode = cfg.get_int("LoadScreen", "PacingMode", kLoadPacingSmooth);
+      g_loadProfilerEnabled = cfg.get_bool("Profiling", "LoadProfiler", false);
+      g_clothCaptureEnabled = cfg.get_bool("Profiling", "ClothCapture", false);
+      g_clothKernelCheck    = cfg.get_bool("Profiling", "ClothKernelCheck", false);
+      g_extPerfEnabled      = cfg.get_bool("Profiling", "ExtPerf", false);
+      g_extPerfCsv          = cfg.get_bool("Profiling", "ExtPerfCsv", false);
+      g_xinputProbeEnabled  = cfg.get_bool("Profiling", "XInputLatency", false);
+      g_xinputPollHz        = cfg.get_int("Profiling", "XInputPollHz", 250);
+      g_heapProfilerEnabled = cfg.get_bool("Profiling", "HeapProfiler", false);
+      g_lvlPrefetchEnabled = cfg.get_bool("LevelPrefetch", "Enabled", false);
+      g_lvlPrefetchLookahead = cfg.get_int("LevelPrefetch", "Lookahead", 3);
+      g_lvlPrefetchBudgetMB = cfg.get_int("LevelPrefetch", "BudgetMB", 256);
+      g_flyerBoostLodDistance = cfg.get_float("FlyerBoost", "LodDistance", 150.0f);
+      g_flyerBoostFarInterval = cfg.get_int("FlyerBoost", "FarUpdateInterval", 4);
+      g_flyerBoostCullOffscreen = cfg.get_bool("FlyerBoost", "CullOffscreen", true);
+      g_clothLodEnabled = cfg.get_bool("ClothLOD", "Enabled", false);
+      g_clothSleepFrames = cfg.get_int("ClothLOD", "SleepFrames", 30);
+      g_clothLodDistance = cfg.get_float("ClothLOD", "LodDistance", 60.0f);
+      g_clothFarTickInterval = cfg.get_int("ClothLOD", "FarTickInterval", 3);
+      g_clothCullOffscreen = cfg.get_bool("ClothLOD", "CullOffscreen", true);
       controller_set_ini_path(ini_path);
       aim_assist_load_config(ini_path);
    } else {
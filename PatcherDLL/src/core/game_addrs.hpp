@@ -89,6 +89,9 @@ namespace modtools {
    constexpr uintptr_t red_set_current_heap      = 0x007e2c70;
    constexpr uintptr_t runtime_heap_global       = 0x00b30220;
    constexpr uintptr_t s_loadheap_global         = 0x00ba111c;
+   constexpr uintptr_t red_get_heap_free         = 0x007e2d60;  // int __cdecl(int heapIndex)
+   constexpr uintptr_t red_free_list_insert      = 0x007e2e00;  // EDI = heap, (blockHeader)
+   constexpr uintptr_t red_alloc_list_unlink     = 0x007e2e80;  // EAX = blockHeader, (listHead, unused)
 
    // ---- Sound (Snd::*) ------------------------------------------------------
 
@@ -175,6 +178,9 @@ namespace modtools {
 
    constexpr uintptr_t char_exit_vehicle            = 0x0052FC70;
 
+   // Entity::~Entity — __thiscall(Entity*); drops sidecar components
+   constexpr uintptr_t entity_dtor                  = 0; // TODO
+
    // ---- Entity / Vehicle (Carrier/Flyer) ---------------------------------------
 
    constexpr uintptr_t flyer_init_animations         = 0x004F6560;
@@ -196,6 +202,7 @@ namespace modtools {
    constexpr uintptr_t carrier_set_property         = 0x004D7210;
    constexpr uintptr_t carrier_attach_cargo         = 0x004D81F0;
    constexpr uintptr_t carrier_detach_cargo         = 0x004D8350;
+   constexpr uintptr_t carrier_dtor                 = 0x004D7DA0;  // EntityCarrier::~EntityCarrier (docs/EntityCarrierSystem.md)
    constexpr uintptr_t carrier_initiate_landing     = 0x004f1380;
    constexpr uintptr_t carrier_kill                 = 0x004D8400;
    constexpr uintptr_t carrier_update               = 0x004D7FE0;
@@ -2,6 +2,7 @@
 
 #include "patch_table.hpp"
 #include "game_addrs.hpp"
+#include "util/pbl_hash.hpp"
 
 // Matrix/Item Pool Limit Extension: redirect matrixPool to larger static buffer
 // Original pool: 0x2FD80 bytes (0xBF6 entries × 64-byte matrices)
@@ -61,18 +62,6 @@ static const uint32_t modtools_sCaches_va = game_addrs::modtools::s_caches;
 static const uint32_t steam_sCaches_va = game_addrs::steam::s_caches;
 static const uint32_t gog_sCaches_va = game_addrs::gog::s_caches;
 
-// FNV-1a hash with forced lowercase — matches PblHash::calcHash in the game engine.
-static uint32_t pbl_hash(const char* str)
-{
-   if (!str || !*str) return 0;
-   uint32_t hash = 0x811c9dc5;
-   while (*str) {
-      hash = (hash ^ ((uint8_t)*str | 0x20)) * 0x1000193;
-      str++;
-   }
-   return hash;
-}
-
 void init_object_limit_sentinel(const char* rtti_class_name)
 {
    // The game's hash table iterator reads 1 entry past the values array and compares
@@ -0,0 +1,158 @@
+#include "pch.h"
+#include "cloth_bench.hpp"
+#include "command_registry.hpp"
+#include "core/resolve.hpp"
+#include "entity/cloth_kernels.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+static constexpr uint32_t kDefaultParticles = 4096;
+static constexpr uint32_t kMaxParticles     = 65536;
+static constexpr uint32_t kParticleBudget   = 4u << 20;   // particles solved per timed run
+
+static constexpr float kHalfHeight = 1.0f;
+static constexpr float kRadius     = 0.5f;
+
+// Deterministic, so runs are comparable across sessions
+static uint32_t s_rng = 1;
+
+static inline float rand01()
+{
+   s_rng = s_rng * 1664525u + 1013904223u;
+   return (float)(s_rng >> 8) * (1.0f / 16777216.0f);
+}
+
+static inline float rand_range(float lo, float hi)
+{
+   return lo + (hi - lo) * rand01();
+}
+
+// Cylinder tilted 30 degrees about Z, centred away from the origin
+static void make_matrix(float* mat)
+{
+   const float c = 0.8660254f, s = 0.5f;
+   const float m[16] = {
+       c,    s,    0.0f, 0.0f,
+      -s,    c,    0.0f, 0.0f,
+       0.0f, 0.0f, 1.0f, 0.0f,
+       10.0f, 2.0f, -5.0f, 1.0f,
+   };
+   memcpy(mat, m, sizeof(m));
+}
+
+// Local (radial X, axis, radial Z) -> world
+static void place(float* p, const float* mat, float lx, float ly, float lz)
+{
+   for (int k = 0; k < 3; k++)
+      p[k] = mat[12 + k] + lx * mat[k] + ly * mat[4 + k] + lz * mat[8 + k];
+}
+
+// inside: fraction of particles placed inside the cylinder, the rest in a
+// shell up to twice its size around it
+static void fill(float* pos, uint32_t count, const float* mat, float inside)
+{
+   for (uint32_t i = 0; i < count; i++) {
+      float* p = pos + i * 3;
+      if (rand01() < inside) {
+         float a = rand_range(0.0f, 6.2831853f), r = kRadius * sqrtf(rand01());
+         place(p, mat, r * cosf(a), rand_range(-kHalfHeight, kHalfHeight), r * sinf(a));
+      } else {
+         float a = rand_range(0.0f, 6.2831853f), r = rand_range(kRadius * 1.01f, kRadius * 2.0f);
+         place(p, mat, r * cosf(a), rand_range(-kHalfHeight * 2.0f, kHalfHeight * 2.0f), r * sinf(a));
+      }
+   }
+}
+
+static inline double seconds(LONGLONG ticks, LONGLONG freq)
+{
+   return (double)ticks / (double)freq;
+}
+
+// Time `reps` passes over a fresh copy of src; the copy alone is timed
+// separately and subtracted by the caller.
+template <typename Solve>
+static LONGLONG time_runs(float* work, const float* src, uint32_t count, uint32_t reps, Solve solve)
+{
+   LARGE_INTEGER t0, t1;
+   QueryPerformanceCounter(&t0);
+   for (uint32_t r = 0; r < reps; r++) {
+      memcpy(work, src, count * 3 * sizeof(float));
+      solve(work);
+   }
+   QueryPerformanceCounter(&t1);
+   return t1.QuadPart - t0.QuadPart;
+}
+
+static void run_bench(uint32_t count)
+{
+   GameLog_t log = get_gamelog();
+
+   float* src = new (std::nothrow) float[count * 3];
+   float* sse = new (std::nothrow) float[count * 3];
+   float* ref = new (std::nothrow) float[count * 3];
+   if (!src || !sse || !ref) {
+      log("[ClothBench] Out of memory for %u particles\n", count);
+      delete[] src; delete[] sse; delete[] ref;
+      return;
+   }
+
+   float mat[16];
+   make_matrix(mat);
+
+   LARGE_INTEGER freq;
+   QueryPerformanceFrequency(&freq);
+
+   const uint32_t reps = kParticleBudget / count ? kParticleBudget / count : 1;
+   const double   particles = (double)count * reps;
+
+   log("[ClothBench] %u particles x %u runs, cylinder r=%.2f h=%.2f\n", count, reps, kRadius, kHalfHeight);
+
+   const float fractions[] = { 0.0f, 0.25f, 1.0f };
+   for (float inside : fractions) {
+      s_rng = 1;
+      fill(src, count, mat, inside);
+
+      const LONGLONG copy = time_runs(sse, src, count, reps, [](float*) {});
+      const LONGLONG scalar = time_runs(ref, src, count, reps, [&](float* p) {
+         for (uint32_t i = 0; i < count; i++) cloth_cylinder_scalar(p + i * 3, mat, kHalfHeight, kRadius);
+      });
+      const LONGLONG simd = time_runs(sse, src, count, reps, [&](float* p) {
+         cloth_collide_cylinder(p, count, mat, kHalfHeight, kRadius);
+      });
+
+      float maxDiff = 0.0f;
+      for (uint32_t i = 0; i < count * 3; i++) {
+         float d = fabsf(sse[i] - ref[i]);
+         if (d > maxDiff) maxDiff = d;
+      }
+
+      const double scalarNs = seconds(scalar > copy ? scalar - copy : 0, freq.QuadPart) * 1e9 / particles;
+      const double simdNs   = seconds(simd > copy ? simd - copy : 0, freq.QuadPart) * 1e9 / particles;
+
+      log("[ClothBench] %3.0f%% inside: scalar %6.2f ns/particle, SSE %6.2f ns/particle, %.2fx, max diff %g\n",
+          inside * 100.0f, scalarNs, simdNs, simdNs > 0.0 ? scalarNs / simdNs : 0.0, maxDiff);
+   }
+
+   delete[] src;
+   delete[] sse;
+   delete[] ref;
+}
+
+// ClothBench [particles]
+static int __cdecl cloth_bench_cmd(void* /*console*/, unsigned int /*id*/, const char* args)
+{
+   uint32_t count = kDefaultParticles;
+   if (args) {
+      unsigned long n = strtoul(args, nullptr, 10);
+      if (n) count = n < kMaxParticles ? (uint32_t)n : kMaxParticles;
+   }
+   run_bench(count);
+   return 0;
+}
+
+void ClothBench::lateInit()
+{
+   DebugCommandRegistry::addCommand("ClothBench", cloth_bench_cmd);
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "debug_command.hpp"
+
+// =============================================================================
+// ClothBench — console benchmark for the cloth cylinder collision kernel
+//
+// Times the SSE cylinder kernel (entity/cloth_kernels.hpp) against the
+// scalar version of the same math, on a scratch cloth of random particles
+// around a tilted cylinder, at several fractions of particles inside it.
+// Logs ns per particle for both, the speedup, and the largest difference
+// between their outputs to BF2GameExt.log.
+//
+// Usage: "ClothBench [particles]" in the ~ console, default 4096.
+// =============================================================================
+
+class ClothBench : public DebugCommand {
+public:
+   static void lateInit();
+};
@@ -1,6 +1,7 @@
 #include "pch.h"
 #include "command_registry.hpp"
 #include "debug_command.hpp"
+#include "ext_perf.hpp"
 #include "core/game_addrs.hpp"
 
 #include <detours.h>
@@ -8,6 +9,9 @@
 // -- Commands -----------------------------------------------------------------
 #include "hover_springs.hpp"
 #include "weapon_ranges.hpp"
+#include "heap_stats.hpp"
+#include "sidecar_stats.hpp"
+#include "cloth_bench.hpp"
 // Add new command headers here
 // -----------------------------------------------------------------------------
 
@@ -39,6 +43,10 @@ static void __cdecl hooked_EngineConsoleReg()
 
    HoverSprings::lateInit();
    WeaponRanges::lateInit();
+   ExtPerf::lateInit();
+   HeapStats::lateInit();
+   SidecarStats::lateInit();
+   ClothBench::lateInit();
    // Add new command lateInits here
 }
 
@@ -57,6 +65,7 @@ void DebugCommandRegistry::install(uintptr_t exe_base)
    // Install hooks for all commands
    HoverSprings::install(exe_base);
    WeaponRanges::install(exe_base);
+   ExtPerf::install(exe_base);
    // Add new command installs here
 
    // Hook the engine's console registration to piggyback our commands
@@ -75,6 +84,7 @@ void DebugCommandRegistry::uninstall()
 {
    HoverSprings::uninstall();
    WeaponRanges::uninstall();
+   ExtPerf::uninstall();
    // Add new command uninstalls here
 
    DetourTransactionBegin();
@@ -0,0 +1,297 @@
+#include "pch.h"
+#include "ext_perf.hpp"
+#include "command_registry.hpp"
+#include "entity/anim_lookup_cache.hpp"
+#include "render/red_camera.hpp"
+#include "render/frame_clock.hpp"
+#include "controller/player_controller_update.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+bool g_extPerfEnabled = false;
+bool g_extPerfCsv     = false;
+
+// ---------------------------------------------------------------------------
+// Limits
+// ---------------------------------------------------------------------------
+
+static constexpr int   kRingFrames  = 256;       // percentile history
+static constexpr float kWindowSecs  = 1.0f;      // overlay / CSV cadence
+static constexpr float kOverlayDist = 4.0f;      // metres in front of the camera
+static constexpr float kLineStep    = 0.09f;     // metres between overlay lines
+static constexpr int   kLineLen     = 112;
+
+static const char* const kCsvName = "BF2GameExt_perf.csv";
+
+static const char* const kHookNames[kExtPerf_Count] = {
+   "AimAssist",
+   "LoadRender",
+   "CarrierUpdate",
+   "FlyerRender",
+   "FPUpdateSoldier",
+   "GCBeamAdd",
+   "GCParticleAdd",
+   "ClothSolve",
+};
+
+// ---------------------------------------------------------------------------
+// Counters
+// ---------------------------------------------------------------------------
+
+struct HookPerf {
+   // This frame
+   uint32_t calls;
+   LONGLONG ticks;
+   LONGLONG maxTicks;
+   LONGLONG excluded;             // engine time inside the current call
+
+   // This window
+   uint32_t winCalls;
+   LONGLONG winTicks;
+   LONGLONG winMax;
+
+   // Per-frame totals, ms
+   float    ring[kRingFrames];
+
+   // Last finished window
+   float    callsPerFrame, avgMs, maxMs, p50, p95, p99;
+};
+
+static HookPerf s_hooks[kExtPerf_Count];
+static int      s_ringPos   = 0;
+static int      s_ringFill  = 0;
+static int      s_winFrames = 0;
+static LONGLONG s_winStart  = 0;
+static LONGLONG s_runStart  = 0;
+static double   s_msPerTick = 0.0;
+static bool     s_active    = false;   // counters are live (timing was on last frame)
+static FILE*    s_csv       = nullptr;
+
+static char     s_lines[kExtPerf_Count + 2][kLineLen];   // header, hooks, AnimCache
+static int      s_lineCount = 0;
+
+// ---------------------------------------------------------------------------
+// Recording — called through the inline wrappers in ext_perf.hpp
+// ---------------------------------------------------------------------------
+
+void ext_perf_record(int hook, LONGLONG start)
+{
+   LARGE_INTEGER now;
+   QueryPerformanceCounter(&now);
+
+   HookPerf& h = s_hooks[hook];
+   LONGLONG t = now.QuadPart - start - h.excluded;
+   h.excluded = 0;
+   if (t < 0) t = 0;
+
+   h.calls++;
+   h.ticks += t;
+   if (t > h.maxTicks) h.maxTicks = t;
+}
+
+void ext_perf_subtract(int hook, LONGLONG start)
+{
+   LARGE_INTEGER now;
+   QueryPerformanceCounter(&now);
+   s_hooks[hook].excluded += now.QuadPart - start;
+}
+
+// ---------------------------------------------------------------------------
+// Frame / window roll-up
+// ---------------------------------------------------------------------------
+
+static int compare_float(const void* a, const void* b)
+{
+   float fa = *(const float*)a, fb = *(const float*)b;
+   return (fa > fb) - (fa < fb);
+}
+
+static void reset_counters()
+{
+   memset(s_hooks, 0, sizeof(s_hooks));
+   s_ringPos   = 0;
+   s_ringFill  = 0;
+   s_winFrames = 0;
+   s_lineCount = 0;
+
+   LARGE_INTEGER now;
+   QueryPerformanceCounter(&now);
+   s_winStart = now.QuadPart;
+   if (!s_runStart) s_runStart = now.QuadPart;
+}
+
+static void write_csv(double seconds)
+{
+   if (!s_csv) {
+      if (fopen_s(&s_csv, kCsvName, "a") != 0 || !s_csv) {
+         s_csv = nullptr;
+         g_extPerfCsv = false;
+         return;
+      }
+      fseek(s_csv, 0, SEEK_END);
+      if (ftell(s_csv) == 0)
+         fprintf(s_csv, "seconds,hook,calls_per_frame,avg_ms,max_ms,p50_ms,p95_ms,p99_ms\n");
+   }
+
+   for (int i = 0; i < kExtPerf_Count; i++) {
+      const HookPerf& h = s_hooks[i];
+      fprintf(s_csv, "%.2f,%s,%.2f,%.4f,%.4f,%.4f,%.4f,%.4f\n",
+              seconds, kHookNames[i], h.callsPerFrame, h.avgMs, h.maxMs, h.p50, h.p95, h.p99);
+   }
+   fflush(s_csv);
+}
+
+static void close_window(LONGLONG now)
+{
+   static float sorted[kRingFrames];
+   float total = 0.0f;
+
+   for (int i = 0; i < kExtPerf_Count; i++) {
+      HookPerf& h = s_hooks[i];
+      h.callsPerFrame = (float)h.winCalls / (float)s_winFrames;
+      h.avgMs         = (float)(h.winTicks * s_msPerTick / s_winFrames);
+      h.maxMs         = (float)(h.winMax * s_msPerTick);
+
+      memcpy(sorted, h.ring, s_ringFill * sizeof(float));
+      qsort(sorted, s_ringFill, sizeof(float), compare_float);
+      h.p50 = sorted[(s_ringFill - 1) * 50 / 100];
+      h.p95 = sorted[(s_ringFill - 1) * 95 / 100];
+      h.p99 = sorted[(s_ringFill - 1) * 99 / 100];
+
+      h.winCalls = 0;
+      h.winTicks = 0;
+      h.winMax   = 0;
+      total += h.avgMs;
+   }
+
+   // Overlay text is rebuilt once per window, not per frame
+   s_lineCount = 0;
+   sprintf_s(s_lines[s_lineCount++], kLineLen, "BF2GameExt hooks: %.3f ms/frame (%d frames)", total, s_winFrames);
+   for (int i = 0; i < kExtPerf_Count; i++) {
+      const HookPerf& h = s_hooks[i];
+      if (!h.callsPerFrame) continue;
+      sprintf_s(s_lines[s_lineCount++], kLineLen,
+                "%-15s %6.1f/f  avg %.3f  max %.3f  p50 %.3f  p95 %.3f  p99 %.3f",
+                kHookNames[i], h.callsPerFrame, h.avgMs, h.maxMs, h.p50, h.p95, h.p99);
+   }
+
+   AnimCacheStats anim;
+   anim_cache_get_stats(&anim);
+   const uint32_t lookups = anim.hits + anim.negativeHits + anim.misses;
+   if (lookups) {
+      sprintf_s(s_lines[s_lineCount++], kLineLen,
+                "AnimCache       %u entries  %.1f%% hit (%u negative)  %u misses  %u invalidations",
+                anim.entries, (anim.hits + anim.negativeHits) * 100.0 / lookups,
+                anim.negativeHits, anim.misses, anim.invalidations);
+   }
+
+   if (g_extPerfCsv) write_csv((now - s_runStart) * s_msPerTick / 1000.0);
+
+   s_winFrames = 0;
+   s_winStart  = now;
+}
+
+static void end_frame()
+{
+   LARGE_INTEGER now;
+   QueryPerformanceCounter(&now);
+
+   for (int i = 0; i < kExtPerf_Count; i++) {
+      HookPerf& h = s_hooks[i];
+      h.ring[s_ringPos] = (float)(h.ticks * s_msPerTick);
+      h.winCalls += h.calls;
+      h.winTicks += h.ticks;
+      if (h.maxTicks > h.winMax) h.winMax = h.maxTicks;
+      h.calls    = 0;
+      h.ticks    = 0;
+      h.maxTicks = 0;
+   }
+   s_ringPos = (s_ringPos + 1) % kRingFrames;
+   if (s_ringFill < kRingFrames) s_ringFill++;
+   s_winFrames++;
+
+   if ((now.QuadPart - s_winStart) * s_msPerTick >= kWindowSecs * 1000.0)
+      close_window(now.QuadPart);
+}
+
+// Stack the lines on a plane kOverlayDist in front of the camera, upper left
+static void draw_overlay()
+{
+   if (!DebugCommand::printf3D || !s_lineCount) return;
+   const float* m = red_camera_matrix();
+   if (!m) return;
+
+   const float* right = m + 0;
+   const float* up    = m + 4;
+   const float  fwd[3] = { -m[8], -m[9], -m[10] };
+
+   float pos[3];
+   for (int i = 0; i < s_lineCount; i++) {
+      float x = -1.6f, y = 1.0f - kLineStep * i;
+      for (int k = 0; k < 3; k++)
+         pos[k] = m[12 + k] + fwd[k] * kOverlayDist + right[k] * x + up[k] * y;
+      DebugCommand::printf3D(pos, "%s", s_lines[i]);
+   }
+}
+
+// ---------------------------------------------------------------------------
+// Frame tick: frame clock (Present), in play and on the loading screen
+// ---------------------------------------------------------------------------
+
+static void on_frame_end()
+{
+   if (!g_extPerfEnabled) {
+      s_active = false;
+      return;
+   }
+   if (!s_active) {
+      // Just switched on — drop whatever leaked in from before
+      reset_counters();
+      s_active = true;
+      return;
+   }
+   end_frame();
+}
+
+// ---------------------------------------------------------------------------
+// Overlay: after PlayerController::Update — printf_3d text only shows in play
+// ---------------------------------------------------------------------------
+
+static void on_pc_update(void* /*controller*/, float /*dt*/)
+{
+   if (!s_active) return;
+
+   __try { draw_overlay(); }
+   __except (EXCEPTION_EXECUTE_HANDLER) {}
+}
+
+// ---------------------------------------------------------------------------
+// Install / uninstall
+// ---------------------------------------------------------------------------
+
+void ExtPerf::install(uintptr_t /*exe_base*/)
+{
+   LARGE_INTEGER freq;
+   QueryPerformanceFrequency(&freq);
+   s_msPerTick = 1000.0 / (double)freq.QuadPart;
+
+   frame_clock_on_frame_end(on_frame_end);
+   pc_update_after(on_pc_update);
+}
+
+void ExtPerf::lateInit()
+{
+   DebugCommandRegistry::addBool("ShowExtPerf", &g_extPerfEnabled);
+}
+
+void ExtPerf::uninstall()
+{
+   pc_update_remove(on_pc_update);
+
+   if (s_csv) {
+      fclose(s_csv);
+      s_csv = nullptr;
+   }
+}
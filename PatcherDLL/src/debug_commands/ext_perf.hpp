@@ -0,0 +1,93 @@
+#pragma once
+
+#include "debug_command.hpp"
+
+#include <type_traits>
+
+// =============================================================================
+// ExtPerf — CPU cost of BF2GameExt's own hooks
+//
+// The hot hooks run their work through QPC-timed wrappers:
+//
+//   static R __fastcall hooked_X(...)
+//   {
+//      return ext_perf_call(kExtPerf_X, [&] { return x(...); });
+//   }
+//
+//   static R x(...)                              // our work
+//   {
+//      ...
+//      ext_perf_engine(kExtPerf_X, [&] { original_X(...); });   // engine work, not ours
+//      ...
+//   }
+//
+// Per hook and per frame this keeps a call count, total time and the
+// slowest single call, plus a 256-frame history for percentiles.  With
+// timing off, each wrapper is one flag test and a direct call.
+//
+// "ShowExtPerf" in the ~ console toggles timing and a printf_3d overlay
+// (1 s averages).  [Profiling] ExtPerf=1 turns it on at startup and
+// ExtPerfCsv=1 appends every 1 s window to BF2GameExt_perf.csv.
+//
+// Frames end at the frame clock (IDirect3DDevice9::Present), so loading
+// screen frames are counted one by one too.  The overlay is drawn from
+// PlayerController::Update and only shows in play; the CSV has every window.
+// =============================================================================
+
+enum ExtPerfHook : int {
+   kExtPerf_AimAssist,          // PlayerController::Update, after the engine
+   kExtPerf_LoadRender,         // LoadDisplay::RenderScreen
+   kExtPerf_CarrierUpdate,      // EntityFlyer carrier Update
+   kExtPerf_FlyerRender,        // EntityFlyer Render (carrier anim override)
+   kExtPerf_FPUpdateSoldier,    // FirstPersonRenderable::UpdateSoldier swap
+   kExtPerf_GCBeamAdd,          // DrawAllBeamBetween::Add
+   kExtPerf_GCParticleAdd,      // DrawAllParticleAt::Add
+   kExtPerf_ClothSolve,         // EntityCloth::SatisfyConstraints extras
+   kExtPerf_Count
+};
+
+extern bool g_extPerfEnabled;
+extern bool g_extPerfCsv;
+
+void ext_perf_record(int hook, LONGLONG start);
+void ext_perf_subtract(int hook, LONGLONG start);
+
+// Timed path of the wrappers below: fn(), then done(hook, start)
+template <typename Fn>
+decltype(auto) ext_perf_timed(int hook, void (*done)(int, LONGLONG), Fn& fn)
+{
+   LARGE_INTEGER start;
+   QueryPerformanceCounter(&start);
+   if constexpr (std::is_void_v<decltype(fn())>) {
+      fn();
+      done(hook, start.QuadPart);
+   }
+   else {
+      auto result = fn();
+      done(hook, start.QuadPart);
+      return result;
+   }
+}
+
+// fn() is one call of `hook`
+template <typename Fn>
+decltype(auto) ext_perf_call(int hook, Fn&& fn)
+{
+   if (!g_extPerfEnabled) return fn();
+   return ext_perf_timed(hook, ext_perf_record, fn);
+}
+
+// fn() runs engine code inside a call of `hook` — take its time off the call
+template <typename Fn>
+decltype(auto) ext_perf_engine(int hook, Fn&& fn)
+{
+   if (!g_extPerfEnabled) return fn();
+   return ext_perf_timed(hook, ext_perf_subtract, fn);
+}
+
+class ExtPerf : public DebugCommand {
+public:
+   static void install(uintptr_t exe_base);
+   static void lateInit();
+   static void uninstall();
+};
@@ -0,0 +1,18 @@
+#include "pch.h"
+#include "heap_stats.hpp"
+#include "command_registry.hpp"
+#include "memory/red_heap_profiler.hpp"
+
+#include <cstring>
+
+static int __cdecl heap_stats_cmd(void* /*console*/, unsigned int /*id*/, const char* args)
+{
+   bool reset = args && _strnicmp(args, "reset", 5) == 0;
+   red_heap_profiler_report(reset);
+   return 0;
+}
+
+void HeapStats::lateInit()
+{
+   DebugCommandRegistry::addCommand("HeapStats", heap_stats_cmd);
+}
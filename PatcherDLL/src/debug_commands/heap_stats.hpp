@@ -0,0 +1,19 @@
+#pragma once
+
+#include "debug_command.hpp"
+
+// =============================================================================
+// HeapStats — console debug command
+//
+// Writes the RedHeap profiler report (live bytes and free-list state per
+// heap, size histograms, top call sites) to BF2GameExt.log.
+// Needs [Profiling] HeapProfiler=1; see memory/red_heap_profiler.hpp.
+//
+// Usage: "HeapStats" in the ~ console; "HeapStats reset" also clears the
+// freed-size histograms and call-site counts.
+// =============================================================================
+
+class HeapStats : public DebugCommand {
+public:
+   static void lateInit();
+};
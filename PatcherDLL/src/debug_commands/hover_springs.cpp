@@ -2,6 +2,7 @@
 #include "hover_springs.hpp"
 #include "weapon_ranges.hpp"
 #include "command_registry.hpp"
+#include "render/debug_draw.hpp"
 
 #include <detours.h>
 
@@ -9,8 +10,8 @@
 // HoverSprings
 //
 // Per-spring-body debug visualization for EntityHover vehicles.
-// Caches spring data during PostCollisionUpdate, draws in both play
-// mode and freecam via separate hooks.
+// Caches spring data during PostCollisionUpdate and draws the whole cache
+// once per frame through render/debug_draw, in play mode and freecam.
 // =============================================================================
 
 
@@ -51,14 +52,16 @@ struct CachedBody {
 
 struct CachedHover {
    bool  active;
+   const void* key;      // EntityHover — seen twice means a new frame
    int   numBodies;
    CachedBody bodies[6];
 };
 
-static constexpr int kMaxHovers = 16;
+static constexpr int kMaxHovers = 64;
 static CachedHover s_cache[kMaxHovers];
-static int s_cacheWrite = 0;       // next write slot (round-robin)
-static DWORD s_lastClearTick = 0;  // for per-frame cache clear
+static int s_cacheWrite = 0;       // next write slot
+
+static void draw_all_cached();
 
 static uint32_t compression_color(float c) {
    if (c < 0.f) c = 0.f;
@@ -83,21 +86,23 @@ static void cache_hover(char* hover)
 
    const float* entMat = (const float*)(hover + kOff_EntMatrix);
 
-   // Clear cache once per frame (coarse tick-based)
-   DWORD now = GetTickCount();
-   if (now != s_lastClearTick) {
-      s_lastClearTick = now;
-      for (int i = 0; i < kMaxHovers; ++i) s_cache[i].active = false;
-      s_cacheWrite = 0;
+   // Same hover again — last frame's cache is complete: draw it, start over
+   for (int i = 0; i < s_cacheWrite; ++i) {
+      if (s_cache[i].key == hover) {
+         draw_all_cached();
+         for (int j = 0; j < kMaxHovers; ++j) s_cache[j].active = false;
+         s_cacheWrite = 0;
+         break;
+      }
    }
 
-   // Find or allocate cache slot
    int slot = s_cacheWrite;
    if (slot >= kMaxHovers) return;
    s_cacheWrite++;
 
    CachedHover& ch = s_cache[slot];
    ch.active = true;
+   ch.key    = hover;
    ch.numBodies = numBodies;
 
    for (int i = 0; i < numBodies; ++i) {
@@ -149,33 +154,35 @@ static void draw_all_cached()
          uint32_t col = compression_color(cb.compression);
 
          // Sphere at body position
-         DebugCommand::drawSphere(bx, by, bz, cb.radius, col);
+         debug_draw_sphere(bx, by, bz, cb.radius, col);
 
          // White line = spring length (from sphere center)
-         DebugCommand::drawLine3D(bx, by, bz, bx, by - cb.springLen, bz, colWhite);
+         debug_draw_line(bx, by, bz, bx, by - cb.springLen, bz, colWhite);
 
          // Colored fill line = compression
          if (cb.compression > 0.01f) {
             float fill = cb.springLen * cb.compression;
-            DebugCommand::drawLine3D(bx + 0.05f, by, bz, bx + 0.05f, by - fill, bz, col);
+            debug_draw_line(bx + 0.05f, by, bz, bx + 0.05f, by - fill, bz, col);
          }
 
-         // Labels (2 lines per body: 12 per hover, fits 5 hovers in the 64 limit)
+         // Labels (2 per body; the engine keeps 64 per frame, so off-screen
+         // hovers must not spend them — debug_draw culls first)
          int lenW = (int)cb.springLen;
          int lenD = ((int)(cb.springLen * 10.f)) % 10;
          if (lenD < 0) lenD = -lenD;
 
-         float tp0[3] = { bx, by + cb.radius + 0.5f, bz };
-         float tp1[3] = { bx, by + cb.radius + 0.3f, bz };
-         DebugCommand::printf3D(tp0, "S%d Len=%d.%d", i, lenW, lenD);
-         DebugCommand::printf3D(tp1, "V%d P%d R%d",
-                    (int)cb.velF, (int)cb.omXF, (int)cb.omZF);
+         debug_draw_text(bx, by + cb.radius + 0.5f, bz, "S%d Len=%d.%d", i, lenW, lenD);
+         debug_draw_text(bx, by + cb.radius + 0.3f, bz, "V%d P%d R%d",
+                         (int)cb.velF, (int)cb.omXF, (int)cb.omZF);
       }
    }
+
+   debug_draw_submit();
 }
 
 // ---------------------------------------------------------------------------
-// Hook 1: EntityHover::PostCollisionUpdate — cache + draw during play
+// Hook 1: EntityHover::PostCollisionUpdate — cache during play, drawing
+// the previous frame's cache when the first hover comes round again
 // ---------------------------------------------------------------------------
 
 typedef int(__fastcall* PostCollUpdate_t)(void* ecx, void* edx, float dt);
@@ -189,11 +196,6 @@ static int __fastcall hooked_PostCollUpdate(void* ecx, void* edx, float dt)
       __try {
          cache_hover((char*)ecx);
       } __except (EXCEPTION_EXECUTE_HANDLER) {}
-
-      // Draw during play mode
-      __try {
-         draw_all_cached();
-      } __except (EXCEPTION_EXECUTE_HANDLER) {}
    }
 
    return result;
@@ -0,0 +1,15 @@
+#include "pch.h"
+#include "sidecar_stats.hpp"
+#include "command_registry.hpp"
+#include "entity/entity_sidecar.hpp"
+
+static int __cdecl sidecar_stats_cmd(void* /*console*/, unsigned int /*id*/, const char* /*args*/)
+{
+   sidecar_report();
+   return 0;
+}
+
+void SidecarStats::lateInit()
+{
+   DebugCommandRegistry::addCommand("SidecarStats", sidecar_stats_cmd);
+}
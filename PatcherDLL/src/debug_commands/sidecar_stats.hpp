@@ -0,0 +1,16 @@
+#pragma once
+
+#include "debug_command.hpp"
+
+// =============================================================================
+// SidecarStats — console debug command
+//
+// Logs every registered entity sidecar component type — live count,
+// capacity, peak, blob size, refused attaches — to BF2GameExt.log; see
+// entity/entity_sidecar.hpp.
+// =============================================================================
+
+class SidecarStats : public DebugCommand {
+public:
+   static void lateInit();
+};
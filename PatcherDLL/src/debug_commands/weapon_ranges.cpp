@@ -1,16 +1,16 @@
 #include "pch.h"
 #include "weapon_ranges.hpp"
 #include "command_registry.hpp"
+#include "render/debug_draw.hpp"
 
 #include <detours.h>
-#include <cmath>
 
 // =============================================================================
 // ShowWeaponRanges
 //
 // Per-soldier weapon range visualization for AI debugging.
-// Caches active weapon range data during PostCollisionUpdate,
-// draws in both play mode and freecam.
+// Caches active weapon range data during PostCollisionUpdate and draws
+// the whole cache once per frame through render/debug_draw, in play and freecam.
 // =============================================================================
 
 
@@ -48,37 +48,17 @@ static bool s_enabled = false;
 
 struct CachedRanges {
    bool  active;
+   const void* key;      // PCU this pointer — seen twice means a new frame
    float pos[3];
    float minRange, optimalRange, maxRange;
    float innerBand, outerBand;
 };
 
-static constexpr int kMaxCached = 8;
+static constexpr int kMaxCached = 64;
 static CachedRanges s_cache[kMaxCached];
 static int   s_cacheCount    = 0;
-static DWORD s_lastClearTick = 0;
 
-// ---------------------------------------------------------------------------
-// Draw a flat circle on the XZ plane using line segments
-// ---------------------------------------------------------------------------
-
-static void draw_circle_xz(float cx, float cy, float cz, float radius,
-                            uint32_t color, int segments = 24)
-{
-   if (radius <= 0.01f) return;
-   constexpr float PI2 = 6.283185307f;
-   float step = PI2 / (float)segments;
-   float px = cx + radius;
-   float pz = cz;
-   for (int i = 1; i <= segments; ++i) {
-      float angle = step * (float)i;
-      float nx = cx + radius * cosf(angle);
-      float nz = cz + radius * sinf(angle);
-      DebugCommand::drawLine3D(px, cy, pz, nx, cy, nz, color);
-      px = nx;
-      pz = nz;
-   }
-}
+static void draw_all_cached();
 
 // ---------------------------------------------------------------------------
 // Cache population — reads weapon range data from a live EntitySoldier
@@ -120,18 +100,21 @@ static void cache_soldier(char* ecx)
    float inner = optR - (optR - minR) * 0.2f;
    float outer = optR + (maxR - optR) * 0.2f;
 
-   // Clear cache once per frame (tick-based)
-   DWORD now = GetTickCount();
-   if (now != s_lastClearTick) {
-      s_lastClearTick = now;
-      for (int i = 0; i < kMaxCached; ++i) s_cache[i].active = false;
-      s_cacheCount = 0;
+   // Same soldier again — last frame's cache is complete: draw it, start over
+   for (int i = 0; i < s_cacheCount; ++i) {
+      if (s_cache[i].key == ecx) {
+         draw_all_cached();
+         for (int j = 0; j < kMaxCached; ++j) s_cache[j].active = false;
+         s_cacheCount = 0;
+         break;
+      }
    }
 
    if (s_cacheCount >= kMaxCached) return;
 
    CachedRanges& cr = s_cache[s_cacheCount++];
    cr.active       = true;
+   cr.key          = ecx;
    cr.pos[0]       = posX;
    cr.pos[1]       = posY;
    cr.pos[2]       = posZ;
@@ -160,34 +143,28 @@ static void draw_all_cached()
       float x = cr.pos[0], y = cr.pos[1] + 0.3f, z = cr.pos[2];
 
       // Range circles (raised slightly above ground to avoid z-fighting)
-      if (cr.minRange > 0.01f)
-         draw_circle_xz(x, y, z, cr.minRange, colRed, 20);
-      draw_circle_xz(x, y, z, cr.optimalRange, colGreen, 32);
-      draw_circle_xz(x, y, z, cr.maxRange, colBlue, 28);
+      debug_draw_circle_xz(x, y, z, cr.minRange, colRed);
+      debug_draw_circle_xz(x, y, z, cr.optimalRange, colGreen);
+      debug_draw_circle_xz(x, y, z, cr.maxRange, colBlue);
 
       // AI comfort band
-      if (cr.innerBand > 0.01f)
-         draw_circle_xz(x, y, z, cr.innerBand, colYellow, 16);
-      draw_circle_xz(x, y, z, cr.outerBand, colYellow, 16);
+      debug_draw_circle_xz(x, y, z, cr.innerBand, colYellow);
+      debug_draw_circle_xz(x, y, z, cr.outerBand, colYellow);
 
       // Labels at cardinal directions on each ring
       float minLabelR = cr.minRange > 0.01f ? cr.minRange : 1.f;
-      float lm[3] = { x + minLabelR, y + 1.f, z };
-      DebugCommand::printf3D(lm, "Min %.0f", cr.minRange);
-
-      float lo[3] = { x, y + 1.f, z + cr.optimalRange };
-      DebugCommand::printf3D(lo, "Optimal %.0f", cr.optimalRange);
-
-      float lx[3] = { x - cr.maxRange, y + 1.f, z };
-      DebugCommand::printf3D(lx, "Max %.0f", cr.maxRange);
-
-      float lb[3] = { x, y + 1.f, z - cr.outerBand };
-      DebugCommand::printf3D(lb, "Band %.0f-%.0f", cr.innerBand, cr.outerBand);
+      debug_draw_text(x + minLabelR, y + 1.f, z, "Min %.0f", cr.minRange);
+      debug_draw_text(x, y + 1.f, z + cr.optimalRange, "Optimal %.0f", cr.optimalRange);
+      debug_draw_text(x - cr.maxRange, y + 1.f, z, "Max %.0f", cr.maxRange);
+      debug_draw_text(x, y + 1.f, z - cr.outerBand, "Band %.0f-%.0f", cr.innerBand, cr.outerBand);
    }
+
+   debug_draw_submit();
 }
 
 // ---------------------------------------------------------------------------
-// Hook 1: EntitySoldier::PostCollisionUpdate — cache + draw during play
+// Hook 1: EntitySoldier::PostCollisionUpdate — cache during play, drawing
+// the previous frame's cache when the first soldier comes round again
 //
 // Signature: void __thiscall PCU(float* outParam, float dt)
 // Returns via RET 0x8 (2 stack params, callee-cleanup).
@@ -204,10 +181,6 @@ static void __fastcall hooked_SoldierPCU(void* ecx, void* edx, float* outParam,
       __try {
          cache_soldier((char*)ecx);
       } __except (EXCEPTION_EXECUTE_HANDLER) {}
-
-      __try {
-         draw_all_cached();
-      } __except (EXCEPTION_EXECUTE_HANDLER) {}
    }
 }
 
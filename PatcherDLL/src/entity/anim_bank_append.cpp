@@ -1,12 +1,15 @@
 #include "pch.h"
 #include "anim_bank_append.hpp"
+#include "anim_lookup_cache.hpp"
 #include "core/resolve.hpp"
+#include "util/pbl_hash.hpp"
 
 #pragma warning(disable: 4996) // strncpy, _snprintf deprecation
 
 #include <cstdio>
 #include <cstring>
 #include <cstdlib>
+#include <intrin.h>
 #include <detours.h>
 
 // =============================================================================
@@ -67,7 +70,6 @@
 // ---------------------------------------------------------------------------
 
 using fn_AddBank_t  = bool(__fastcall*)(void* ecx, void* edx, char* name);
-using fn_PblHash_t  = void(__thiscall*)(uint32_t* outHash, const char* str);
 using fn_HashFind_t = void*(__cdecl*)(void* table, int size, uint32_t hash);
 using fn_GameLog_t  = void(__cdecl*)(const char* fmt, ...);
 
@@ -76,7 +78,6 @@ using fn_GameLog_t  = void(__cdecl*)(const char* fmt, ...);
 // ---------------------------------------------------------------------------
 
 static fn_AddBank_t     original_AddBank = nullptr;
-static fn_PblHash_t     fn_pblHash       = nullptr;
 static fn_HashFind_t    fn_hashFind      = nullptr;
 static fn_GameLog_t     fn_log           = nullptr;
 static void*            g_animHashTable  = nullptr;
@@ -96,70 +97,262 @@ static constexpr int kRA_MBFind         = 0x24;
 // Max sub-bank index to search
 static constexpr int kMaxSubBankSearch  = 32;
 
+// Root banks memoized per level (human, pim, simp, ...)
+static constexpr int kMaxRootMemo       = 256;
+
+// Present-set capacity (power of two); falls back to a linear scan if full
+static constexpr int kPresentSetSize    = 1024;
+static constexpr int kPresentSetMaxLoad = kPresentSetSize * 3 / 4;
+
+// Initial capacity when we take over the bank array; doubled from then on
+static constexpr int kMinGrowCount      = 64;
+
+
+// ---------------------------------------------------------------------------
+// Per-root memo
+//
+// The engine calls _AddBank for every weapon bank, and every call used to
+// re-probe all sub-bank indices of the root.  Each root now remembers:
+//   frontier    — first index not found in the hash table yet.  Sub-banks
+//                 are numbered contiguously, so only the frontier has to be
+//                 re-probed to catch a late arrival (human_5).
+//   pendingMask — indices whose entry exists but has no ZephyrAnimBank yet;
+//                 these are re-checked until their data shows up.
+//   subHash     — PblHash of "<root>_<i>", computed once.
+// A call where nothing new arrived is one hash lookup at the frontier.
+// ---------------------------------------------------------------------------
+struct RootMemo {
+    uint32_t rootHash;                       // 0 = free slot
+    int      frontier;
+    uint32_t pendingMask;
+    uint32_t subHash[kMaxSubBankSearch];     // valid for indices < hashedCount
+    int      hashedCount;
+};
+
+static RootMemo s_rootMemo[kMaxRootMemo];
+static int      s_rootMemoCount = 0;
+
+// ---------------------------------------------------------------------------
+// Present-set — open-addressed set of RedAnimation* already in the bank
+// array, replacing the O(count) duplicate scan.  Synced incrementally from
+// the array tail; rebuilt if the finder, array pointer or count changes
+// under us (level transition, engine reallocation).
+// ---------------------------------------------------------------------------
+static void*  s_present[kPresentSetSize];
+static int    s_presentCount = 0;
+static bool   s_presentFull  = false;
+
+static char*  s_syncSelf  = nullptr;
+static void** s_syncArray = nullptr;
+static int    s_syncCount = 0;
+
+// Bank array we allocated ourselves — the only one we may HeapFree.
+// The engine's original array belongs to its own allocator and is kept.
+static void** s_ownedArray = nullptr;
+
+static inline uint32_t ptr_slot(const void* p)
+{
+    return ((uint32_t)(uintptr_t)p >> 4) * 0x9E3779B1u & (kPresentSetSize - 1);
+}
+
+static bool present_contains(const void* p)
+{
+    for (uint32_t i = ptr_slot(p);; i = (i + 1) & (kPresentSetSize - 1)) {
+        if (s_present[i] == p) return true;
+        if (!s_present[i])     return false;
+    }
+}
+
+static void present_insert(void* p)
+{
+    if (s_presentCount >= kPresentSetMaxLoad) {
+        s_presentFull = true;
+        return;
+    }
+    uint32_t i = ptr_slot(p);
+    while (s_present[i]) {
+        if (s_present[i] == p) return;
+        i = (i + 1) & (kPresentSetSize - 1);
+    }
+    s_present[i] = p;
+    s_presentCount++;
+}
+
+static void present_clear()
+{
+    memset(s_present, 0, sizeof(s_present));
+    s_presentCount = 0;
+    s_presentFull  = false;
+}
+
+static bool is_present(void** bankArray, int count, void* entry)
+{
+    if (!s_presentFull) return present_contains(entry);
+    for (int j = 0; j < count; j++)
+        if (bankArray[j] == entry) return true;
+    return false;
+}
+
+// Forget every memo — the hash table and bank array are about to be rebuilt.
+static void memo_clear()
+{
+    memset(s_rootMemo, 0, sizeof(s_rootMemo));
+    s_rootMemoCount = 0;
+}
+
+// Bring the present-set up to date with entries the engine appended itself.
+static void sync_present(char* self, void** bankArray, int count)
+{
+    if (self != s_syncSelf || bankArray != s_syncArray || count < s_syncCount) {
+        // A shrunk array means the finder was reset: hash table contents
+        // may have changed too, so the per-root memo goes as well.
+        if (self != s_syncSelf || count < s_syncCount) memo_clear();
+        if (bankArray != s_ownedArray) s_ownedArray = nullptr;
+
+        present_clear();
+        s_syncSelf  = self;
+        s_syncArray = bankArray;
+        s_syncCount = 0;
+    }
+    for (int j = s_syncCount; j < count; j++)
+        present_insert(bankArray[j]);
+    s_syncCount = count;
+}
+
+static RootMemo* memo_get(uint32_t rootHash)
+{
+    if (!rootHash) rootHash = 1;  // 0 marks a free slot
+
+    uint32_t i = (rootHash * 0x9E3779B1u) & (kMaxRootMemo - 1);
+    for (int n = 0; n < kMaxRootMemo; n++, i = (i + 1) & (kMaxRootMemo - 1)) {
+        RootMemo& m = s_rootMemo[i];
+        if (m.rootHash == rootHash) return &m;
+        if (!m.rootHash) {
+            if (s_rootMemoCount >= kMaxRootMemo - 1) return nullptr;
+            m.rootHash = rootHash;
+            s_rootMemoCount++;
+            return &m;
+        }
+    }
+    return nullptr;
+}
+
+static uint32_t sub_bank_hash(RootMemo& m, const char* rootName, int i)
+{
+    while (m.hashedCount <= i) {
+        char subName[280];
+        _snprintf(subName, sizeof(subName), "%s_%d", rootName, m.hashedCount);
+        subName[sizeof(subName) - 1] = '\0';
+        m.subHash[m.hashedCount] = pbl_hash(subName);
+        m.hashedCount++;
+    }
+    return m.subHash[i];
+}
+
+
+// ---------------------------------------------------------------------------
+// append_entry — add one RedAnimation to the bank array, growing it
+// geometrically.  Returns false if the array could not be grown.
+// ---------------------------------------------------------------------------
+static bool append_entry(char* self, int* pCount, void* entry)
+{
+    void** bankArray = *(void***)(self + kAF_AnimBank);
+    int    maxCount  = *(int*)(self + kAF_MaxCount);
+    int    count     = *pCount;
+
+    if (count >= maxCount) {
+        int newMax = maxCount * 2;
+        if (newMax < kMinGrowCount) newMax = kMinGrowCount;
+
+        void** newArray = (void**)HeapAlloc(
+            GetProcessHeap(), HEAP_ZERO_MEMORY, newMax * sizeof(void*));
+        if (!newArray) {
+            if (fn_log)
+                fn_log("[AnimBankAppend] HeapAlloc failed\n");
+            return false;
+        }
+        memcpy(newArray, bankArray, count * sizeof(void*));
+
+        *(void***)(self + kAF_AnimBank) = newArray;
+        *(int*)(self + kAF_MaxCount) = newMax;
+
+        // Only our own previous buffer can be released — the engine's
+        // original array came from its allocator and stays put.
+        if (s_ownedArray && s_ownedArray == bankArray)
+            HeapFree(GetProcessHeap(), 0, s_ownedArray);
+        s_ownedArray = newArray;
+        s_syncArray  = newArray;
+        bankArray    = newArray;
+    }
+
+    // Mark as referenced and append
+    *(uint8_t*)((char*)entry + kRA_MBFind) = 1;
+    bankArray[count] = entry;
+    (*pCount)++;
+
+    present_insert(entry);
+    s_syncCount = *pCount;
+    return true;
+}
+
+// Returns false if appending failed and the scan should stop.
+static bool check_sub_bank(char* self, int* pCount, RootMemo& m, int i, void* entry)
+{
+    // Entry exists but no animation data loaded yet — check again later
+    if (*(void**)((char*)entry + kRA_ZephyrAnimBank) == nullptr) {
+        m.pendingMask |= 1u << i;
+        return true;
+    }
+    m.pendingMask &= ~(1u << i);
+
+    void** bankArray = *(void***)(self + kAF_AnimBank);
+    if (is_present(bankArray, *pCount, entry)) return true;
+
+    return append_entry(self, pCount, entry);
+}
+
 
 // ---------------------------------------------------------------------------
-// try_append_sub_banks — scans for sub-banks of rootName that exist in the
+// try_append_sub_banks — appends sub-banks of rootName that exist in the
 // hash table but aren't in the AnimBank array yet.
 // ---------------------------------------------------------------------------
-static void try_append_sub_banks(char* self, const char* rootName)
+static void try_append_sub_banks(char* self, const char* rootName, uint32_t rootHash)
 {
-    int   maxCount   = *(int*)(self + kAF_MaxCount);
     void** bankArray = *(void***)(self + kAF_AnimBank);
     int*  pCount     = *(int**)(self + kAF_AnimBankCount);
 
     if (!bankArray || !pCount) return;
 
-    for (int i = 0; i < kMaxSubBankSearch; i++) {
-        char subName[280];
-        _snprintf(subName, sizeof(subName), "%s_%d", rootName, i);
-
-        uint32_t hash;
-        fn_pblHash(&hash, subName);
-
-        void* entry = fn_hashFind(g_animHashTable, 0x800, hash);
-        if (!entry) break;  // No more sub-banks
-
-        // Skip entries with no animation data loaded
-        if (*(void**)((char*)entry + kRA_ZephyrAnimBank) == nullptr)
-            continue;
-
-        // Duplicate check — already in the bank array?
-        bool duplicate = false;
-        int count = *pCount;
-        for (int j = 0; j < count; j++) {
-            if (bankArray[j] == entry) {
-                duplicate = true;
-                break;
-            }
-        }
-        if (duplicate) continue;
-
-        // Re-read maxCount (may have been updated by a previous expansion)
-        maxCount = *(int*)(self + kAF_MaxCount);
-
-        // Capacity check — expand if full
-        if (count >= maxCount) {
-            int newMax = maxCount + 16;
-            void** newArray = (void**)HeapAlloc(
-                GetProcessHeap(), HEAP_ZERO_MEMORY, newMax * sizeof(void*));
-            if (!newArray) {
-                if (fn_log)
-                    fn_log("[AnimBankAppend] HeapAlloc failed\n");
-                break;
-            }
-            memcpy(newArray, bankArray, count * sizeof(void*));
-
-            *(void***)(self + kAF_AnimBank) = newArray;
-            *(int*)(self + kAF_MaxCount) = newMax;
-            bankArray = newArray;
-            maxCount  = newMax;
-        }
+    sync_present(self, bankArray, *pCount);
 
-        // Mark as referenced and append
-        *(uint8_t*)((char*)entry + kRA_MBFind) = 1;
-        bankArray[*pCount] = entry;
-        (*pCount)++;
+    // Memo table full — scan from scratch with a throwaway memo
+    RootMemo scratch;
+    RootMemo* m = memo_get(rootHash);
+    if (!m) {
+        memset(&scratch, 0, sizeof(scratch));
+        m = &scratch;
+    }
+
+    // Known sub-banks still waiting for their animation data
+    uint32_t pending = m->pendingMask;
+    while (pending) {
+        unsigned long i;
+        _BitScanForward(&i, pending);
+        pending &= pending - 1;
+
+        void* entry = fn_hashFind(g_animHashTable, 0x800, m->subHash[i]);
+        if (!entry) continue;
+        if (!check_sub_bank(self, pCount, *m, (int)i, entry)) return;
+    }
+
+    // Advance past every index that has appeared since the last call
+    while (m->frontier < kMaxSubBankSearch) {
+        int i = m->frontier;
+        void* entry = fn_hashFind(g_animHashTable, 0x800, sub_bank_hash(*m, rootName, i));
+        if (!entry) break;  // No more sub-banks (yet)
 
+        if (!check_sub_bank(self, pCount, *m, i, entry)) return;
+        m->frontier++;
     }
 }
 
@@ -169,6 +362,9 @@ static void try_append_sub_banks(char* self, const char* rootName)
 // ---------------------------------------------------------------------------
 static bool __fastcall hooked_AddBank(void* ecx, void* edx, char* name)
 {
+    int* pCount = *(int**)((char*)ecx + kAF_AnimBankCount);
+    int countBefore = pCount ? *pCount : 0;
+
     bool result = original_AddBank(ecx, edx, name);
 
     // Extract root bank name: everything before the FIRST underscore.
@@ -179,8 +375,16 @@ static bool __fastcall hooked_AddBank(void* ecx, void* edx, char* name)
     char* us = strchr(rootName, '_');
     if (us) *us = '\0';
 
-    // Scan for missing sub-banks of the root
-    try_append_sub_banks((char*)ecx, rootName);
+    // Scan for missing sub-banks of the root.  rootName is a local buffer,
+    // so hash it through an interned copy rather than by pointer.
+    const char* root;
+    uint32_t rootHash = pbl_hash_intern_copy(rootName, &root);
+    try_append_sub_banks((char*)ecx, root, rootHash);
+
+    // Banks were added (by the engine or by us) — cached misses may be stale
+    pCount = *(int**)((char*)ecx + kAF_AnimBankCount);
+    if (pCount && *pCount != countBefore)
+        anim_cache_invalidate();
 
     return result;
 }
@@ -195,7 +399,6 @@ void anim_bank_append_install(uintptr_t exe_base)
     using namespace game_addrs::modtools;
 
     original_AddBank = (fn_AddBank_t)resolve(exe_base, anim_finder_add_bank);
-    fn_pblHash       = (fn_PblHash_t)resolve(exe_base, hash_string_thiscall);
     fn_hashFind      = (fn_HashFind_t)resolve(exe_base, pbl_hash_table_find);
     g_animHashTable  = (void*)resolve(exe_base, anim_hash_table);
     fn_log           = (fn_GameLog_t)resolve(exe_base, game_log);
@@ -206,6 +409,16 @@ void anim_bank_append_install(uintptr_t exe_base)
     DetourTransactionCommit();
 }
 
+void anim_bank_append_reset()
+{
+    memo_clear();
+    present_clear();
+    s_syncSelf   = nullptr;
+    s_syncArray  = nullptr;
+    s_syncCount  = 0;
+    s_ownedArray = nullptr;
+}
+
 void anim_bank_append_uninstall()
 {
     DetourTransactionBegin();
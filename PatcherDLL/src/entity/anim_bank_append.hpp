@@ -19,7 +19,13 @@
 // Works for any bank, not just human.  New animations must be in a new
 // numbered sub-bank — individual animations within an existing sub-bank
 // cannot be appended (first-loaded version wins).
+//
+// Discovery is memoized per root bank: each root remembers how far its
+// sub-bank numbering has been probed, so a repeated _AddBank with nothing
+// new costs a single hash lookup.  Call anim_bank_append_reset() from
+// hooked_init_state() (level transitions).
 // =============================================================================
 
 void anim_bank_append_install(uintptr_t exe_base);
 void anim_bank_append_uninstall();
+void anim_bank_append_reset();
@@ -0,0 +1,192 @@
+#include "pch.h"
+#include "anim_lookup_cache.hpp"
+#include "core/resolve.hpp"
+#include "util/pbl_hash.hpp"
+
+#include <cstring>
+#include <detours.h>
+
+// =============================================================================
+// Animation Name Lookup Cache
+//
+// Open-addressed table of (bank, PblHash) -> result.  bank is nullptr for
+// global FindAnimation lookups.  Each slot carries the generation it was
+// written in, so invalidation is a counter bump rather than a clear.  When
+// the table passes 3/4 load it is simply invalidated and refilled — the
+// working set per level is a few hundred names.
+// =============================================================================
+
+using fn_FindAnimation_t = void*(__cdecl*)(const char*);
+using fn_AnimBankFind_t  = void*(__fastcall*)(void* ecx, void* edx, const char* name);
+using fn_AddBank_t       = uint32_t(__cdecl*)(const char*);     // returns bool (low bit)
+
+static fn_FindAnimation_t fn_FindAnimation = nullptr;
+static fn_AnimBankFind_t  fn_AnimBankFind  = nullptr;
+static fn_AddBank_t       original_AddBank = nullptr;
+
+static constexpr int kCacheSize    = 2048;   // power of two
+static constexpr int kCacheMaxLoad = kCacheSize * 3 / 4;
+
+struct AnimCacheSlot {
+   void*    bank;
+   uint32_t hash;
+   uint32_t gen;       // slot is live only if gen == s_gen
+   void*    result;    // nullptr = cached miss
+};
+
+static AnimCacheSlot  s_slots[kCacheSize] = {};
+static uint32_t       s_gen     = 1;
+static int            s_live    = 0;
+static AnimCacheStats s_stats   = {};
+
+static inline uint32_t slot_index(void* bank, uint32_t hash)
+{
+   return (hash ^ ((uint32_t)(uintptr_t)bank >> 4) * 0x9E3779B1u) & (kCacheSize - 1);
+}
+
+// Returns the slot for (bank, hash): either the live match or the empty
+// slot where it should be inserted.
+static AnimCacheSlot* probe(void* bank, uint32_t hash)
+{
+   uint32_t i = slot_index(bank, hash);
+   for (;;) {
+      AnimCacheSlot& s = s_slots[i];
+      if (s.gen != s_gen) return &s;
+      if (s.hash == hash && s.bank == bank) return &s;
+      i = (i + 1) & (kCacheSize - 1);
+   }
+}
+
+static void store(AnimCacheSlot* slot, void* bank, uint32_t hash, void* result)
+{
+   if (s_live >= kCacheMaxLoad) {
+      anim_cache_invalidate();
+      slot = probe(bank, hash);
+   }
+   slot->bank   = bank;
+   slot->hash   = hash;
+   slot->gen    = s_gen;
+   slot->result = result;
+   s_live++;
+}
+
+static bool lookup(void* bank, uint32_t hash, AnimCacheSlot** outSlot, void** outResult)
+{
+   AnimCacheSlot* slot = probe(bank, hash);
+   *outSlot = slot;
+   if (slot->gen != s_gen) {
+      s_stats.misses++;
+      return false;
+   }
+   if (slot->result) s_stats.hits++;
+   else              s_stats.negativeHits++;
+   *outResult = slot->result;
+   return true;
+}
+
+// ---------------------------------------------------------------------------
+// Public lookups
+// ---------------------------------------------------------------------------
+
+void* anim_cache_find_animation(const char* name)
+{
+   if (!name || !fn_FindAnimation) return nullptr;
+
+   // Callers build these names in local buffers — not internable by pointer
+   uint32_t hash = pbl_hash(name);
+
+   AnimCacheSlot* slot;
+   void* result;
+   if (lookup(nullptr, hash, &slot, &result)) return result;
+
+   // Hits only — a missing name can appear with any later .lvl read
+   result = fn_FindAnimation(name);
+   if (result) store(slot, nullptr, hash, result);
+   return result;
+}
+
+void* anim_cache_bank_find(void* bank, const char* name)
+{
+   if (!bank || !name || !fn_AnimBankFind) return nullptr;
+
+   uint32_t hash = pbl_hash_intern(name);
+
+   AnimCacheSlot* slot;
+   void* result;
+   if (lookup(bank, hash, &slot, &result)) return result;
+
+   result = fn_AnimBankFind(bank, nullptr, name);
+   store(slot, bank, hash, result);
+   return result;
+}
+
+// ---------------------------------------------------------------------------
+// Invalidation / stats
+// ---------------------------------------------------------------------------
+
+void anim_cache_invalidate()
+{
+   if (++s_gen == 0) {
+      // Wrapped — stale slots could alias the new generation
+      memset(s_slots, 0, sizeof(s_slots));
+      s_gen = 1;
+   }
+   s_live = 0;
+   s_stats.invalidations++;
+}
+
+void anim_cache_get_stats(AnimCacheStats* out)
+{
+   *out = s_stats;
+   out->entries = (uint32_t)s_live;
+}
+
+void anim_cache_reset()
+{
+   const uint32_t lookups = s_stats.hits + s_stats.negativeHits + s_stats.misses;
+   if (lookups) {
+      get_gamelog()("[AnimCache] %u lookups: %u hits, %u negative hits, %u misses (%.1f%% hit), "
+                    "%u invalidations\n",
+                    lookups, s_stats.hits, s_stats.negativeHits, s_stats.misses,
+                    (s_stats.hits + s_stats.negativeHits) * 100.0 / lookups,
+                    s_stats.invalidations);
+   }
+   memset(&s_stats, 0, sizeof(s_stats));
+   anim_cache_invalidate();
+}
+
+// ---------------------------------------------------------------------------
+// Hook: AddBank — a bank that loaded can satisfy names cached as missing
+// ---------------------------------------------------------------------------
+
+static uint32_t __cdecl hooked_AddBank(const char* name)
+{
+   uint32_t result = original_AddBank(name);
+   if (result & 1) anim_cache_invalidate();
+   return result;
+}
+
+// ---------------------------------------------------------------------------
+// Install / Uninstall
+// ---------------------------------------------------------------------------
+
+void anim_cache_install(uintptr_t exe_base)
+{
+   using namespace game_addrs::modtools;
+   fn_FindAnimation = (fn_FindAnimation_t)resolve(exe_base, anim_find_animation);
+   fn_AnimBankFind  = (fn_AnimBankFind_t) resolve(exe_base, zephyr_anim_bank_find);
+   original_AddBank = (fn_AddBank_t)      resolve(exe_base, anim_add_bank);
+
+   DetourTransactionBegin();
+   DetourUpdateThread(GetCurrentThread());
+   DetourAttach(&(PVOID&)original_AddBank, hooked_AddBank);
+   DetourTransactionCommit();
+}
+
+void anim_cache_uninstall()
+{
+   DetourTransactionBegin();
+   DetourUpdateThread(GetCurrentThread());
+   if (original_AddBank) DetourDetach(&(PVOID&)original_AddBank, hooked_AddBank);
+   DetourTransactionCommit();
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stdint.h>
+
+// =============================================================================
+// Animation Name Lookup Cache
+//
+// Shared name -> animation cache in front of the engine's by-name lookups:
+//   anim_cache_find_animation — global FindAnimation (ZephyrAnim*)
+//   anim_cache_bank_find      — ZephyrAnimBank::Find on one bank
+//
+// Keys are the PblHash of the name (plus the bank pointer for bank finds).
+// Bank find names go through pbl_hash_intern, so they must be stable
+// strings (the one caller passes a literal); global find names are hashed
+// directly.
+// Bank find misses are cached too, so probing a bank for optional
+// animations (boost, per-slot FP overrides) only costs the engine once per
+// level.  Global misses are not: .lvl reads add entries to the global
+// animation table without going through AddBank, so a _sprint probe made
+// before its bank's .lvl is read has to reach the engine again next time.
+//
+// The whole cache is dropped by anim_cache_invalidate(), which runs only on
+// bank load / unload events: a successful AddBank (hooked here), an
+// AnimationFinder::_AddBank that grows the bank array (anim_bank_append),
+// and level transitions.  Any of them can turn a cached bank miss into a hit.
+//
+// The counters show in the ShowExtPerf overlay and are logged per level.
+// =============================================================================
+
+struct AnimCacheStats {
+   uint32_t hits;
+   uint32_t negativeHits;    // hits on a cached "not found"
+   uint32_t misses;          // went to the engine
+   uint32_t invalidations;
+   uint32_t entries;
+};
+
+void* anim_cache_find_animation(const char* name);
+void* anim_cache_bank_find(void* bank, const char* name);
+
+void anim_cache_invalidate();
+void anim_cache_get_stats(AnimCacheStats* out);
+
+void anim_cache_install(uintptr_t exe_base);
+void anim_cache_uninstall();
+
+// Level transition — log this level's counters, then invalidate.
+void anim_cache_reset();
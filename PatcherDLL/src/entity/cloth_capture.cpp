@@ -0,0 +1,139 @@
+#include "pch.h"
+#include "cloth_capture.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+bool g_clothCaptureEnabled = false;
+
+static constexpr int kCaptureCloths = 4;
+static constexpr int kCaptureSolves = 120;   // per cloth
+static constexpr int kMaxSolvePrims = 16;    // distinct primitives per solve
+
+struct CaptureSlot {
+   void* cloth;
+   int   solves;
+};
+
+static CaptureSlot g_slots[kCaptureCloths] = {};
+static FILE*       g_file      = nullptr;
+static int         g_fileIndex = 0;
+static bool        g_fileDone  = false;   // all slots full for this level
+static void*       g_active    = nullptr; // cloth whose solve is being written
+static uint32_t    g_frame     = 0;
+
+// Primitives already written for the active solve — the engine applies each
+// one once per constraint iteration, the file only needs it once.
+struct PrimKey {
+   int   kind;
+   float data[18];
+};
+static PrimKey g_solvePrims[kMaxSolvePrims];
+static int     g_solvePrimCount = 0;
+
+static void closeFile()
+{
+   if (!g_file) return;
+   fclose(g_file);
+   g_file = nullptr;
+   g_fileIndex++;
+}
+
+static bool openFile()
+{
+   if (g_file) return true;
+   if (g_fileDone) return false;
+
+   char filename[64];
+   sprintf_s(filename, "BF2GameExt_cloth_%d.txt", g_fileIndex);
+   if (fopen_s(&g_file, filename, "w") != 0 || !g_file) {
+      g_file     = nullptr;
+      g_fileDone = true;
+      return false;
+   }
+   fprintf(g_file, "# BF2GameExt cloth capture v1\n");
+   return true;
+}
+
+static void writeBuffers(const char* tag, const float* pos, const float* oldPos, uint32_t total)
+{
+   for (uint32_t i = 0; i < total; i++) {
+      const float* p = pos + i * 3;
+      const float* o = oldPos + i * 3;
+      fprintf(g_file, "%s %.9g %.9g %.9g %.9g %.9g %.9g\n", tag, p[0], p[1], p[2], o[0], o[1], o[2]);
+   }
+}
+
+bool cloth_capture_begin(void* cloth, const float* pos, const float* oldPos,
+                         uint32_t total, uint32_t fixed)
+{
+   g_active = nullptr;
+   if (!g_clothCaptureEnabled || g_fileDone || fixed >= total) return false;
+
+   g_frame++;
+
+   CaptureSlot* slot = nullptr;
+   for (int i = 0; i < kCaptureCloths && !slot; i++)
+      if (g_slots[i].cloth == cloth) slot = &g_slots[i];
+   for (int i = 0; i < kCaptureCloths && !slot; i++)
+      if (!g_slots[i].cloth) { slot = &g_slots[i]; slot->cloth = cloth; }
+
+   // Every slot taken and full — this level's capture is complete
+   bool anyOpen = false;
+   for (int i = 0; i < kCaptureCloths; i++)
+      if (!g_slots[i].cloth || g_slots[i].solves < kCaptureSolves) anyOpen = true;
+   if (!anyOpen) {
+      closeFile();
+      g_fileDone = true;
+      return false;
+   }
+   if (!slot || slot->solves >= kCaptureSolves || !openFile()) return false;
+
+   slot->solves++;
+   g_active = cloth;
+   g_solvePrimCount = 0;
+
+   fprintf(g_file, "solve %p %u %u %u\n", cloth, g_frame, total, fixed);
+   writeBuffers("pre", pos, oldPos, total);
+   return true;
+}
+
+void cloth_capture_primitive(void* cloth, ClothPrimKind kind, const float* mat, const float* params)
+{
+   if (!g_active || cloth != g_active || !g_file) return;
+
+   static const char* kTags[]   = { "cyl" };
+   static const int   kParams[] = { 2 };
+
+   PrimKey key = {};
+   key.kind = kind;
+   memcpy(key.data, mat, 16 * sizeof(float));
+   memcpy(key.data + 16, params, kParams[kind] * sizeof(float));
+   for (int i = 0; i < g_solvePrimCount; i++)
+      if (memcmp(&g_solvePrims[i], &key, sizeof(key)) == 0) return;
+   if (g_solvePrimCount < kMaxSolvePrims)
+      g_solvePrims[g_solvePrimCount++] = key;
+
+   fprintf(g_file, "%s", kTags[kind]);
+   for (int i = 0; i < 16; i++) fprintf(g_file, " %.9g", mat[i]);
+   for (int i = 0; i < kParams[kind]; i++) fprintf(g_file, " %.9g", params[i]);
+   fprintf(g_file, "\n");
+}
+
+void cloth_capture_end(const float* pos, const float* oldPos, uint32_t total)
+{
+   if (!g_active || !g_file) return;
+
+   writeBuffers("post", pos, oldPos, total);
+   fprintf(g_file, "end\n");
+   g_active = nullptr;
+}
+
+void cloth_capture_reset()
+{
+   closeFile();
+   memset(g_slots, 0, sizeof(g_slots));
+   g_fileDone = false;
+   g_active   = nullptr;
+   g_frame    = 0;
+}
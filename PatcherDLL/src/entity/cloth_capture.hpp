@@ -0,0 +1,39 @@
+#pragma once
+
+#include <stdint.h>
+
+// =============================================================================
+// Cloth State Capture
+//
+// Records live EntityCloth simulation input/output so the collision fixes
+// can be replayed and compared outside the game with cloth_kernels.hpp.
+// For the first kCaptureCloths cloths of a level, kCaptureSolves solves each
+// are written to BF2GameExt_cloth_<n>.txt (n counts levels):
+//
+//   solve <cloth> <frame> <total> <fixed>
+//   pre  <x y z ox oy oz>        x total   — buffers entering SatisfyConstraints
+//   cyl  <mat[16]> <halfHeight> <radius>   — primitives seen during the solve
+//   post <x y z ox oy oz>        x total   — buffers after the final pass
+//   end
+//
+// Floats are printed with %.9g, so they round-trip exactly.
+// Gated on [Profiling] ClothCapture=1.
+// =============================================================================
+
+extern bool g_clothCaptureEnabled;
+
+enum ClothPrimKind : int {
+   kClothPrimCylinder,
+};
+
+// SatisfyConstraints entry / exit.  begin returns true if this solve is
+// being captured.
+bool cloth_capture_begin(void* cloth, const float* pos, const float* oldPos,
+                         uint32_t total, uint32_t fixed);
+void cloth_capture_end(const float* pos, const float* oldPos, uint32_t total);
+
+// Collision primitive applied during the solve being captured.
+void cloth_capture_primitive(void* cloth, ClothPrimKind kind, const float* mat, const float* params);
+
+// Level transition — close the current file.
+void cloth_capture_reset();
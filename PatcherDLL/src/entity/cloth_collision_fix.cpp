@@ -1,10 +1,15 @@
 #include "pch.h"
 #include "cloth_collision_fix.hpp"
+#include "cloth_kernels.hpp"
+#include "cloth_lod.hpp"
+#include "cloth_capture.hpp"
 #include "core/resolve.hpp"
+#include "debug_commands/ext_perf.hpp"
 
 #include <cstring>
 #include <cmath>
 #include <cstdio>
+#include <new>
 #include <detours.h>
 
 // =============================================================================
@@ -27,8 +32,14 @@
 // FIX: Hook EnforceCylinderCollision with a corrected version (bugs 1+2).
 //   Hook SatisfyConstraints for a final collision pass + old_pos correction
 //   after all constraint iterations (bug 3).
+//
+// The cylinder loop runs the SSE kernel in cloth_kernels.hpp, 4 particles
+// per iteration.  [Profiling] ClothKernelCheck=1 checks it, and the model of
+// the engine it was derived from, against the engine on live solves.
 // =============================================================================
 
+bool g_clothKernelCheck = false;
+
 // ---------------------------------------------------------------------------
 // EntityCloth struct offsets (from this pointer)
 // ---------------------------------------------------------------------------
@@ -54,8 +65,122 @@ typedef void (__fastcall* fn_EnforceCylinderCollision_t)(void* ecx, void* edx,
                                                           float* matrix, float halfHeight, float radius);
 static fn_EnforceCylinderCollision_t original_EnforceCylinderCollision = nullptr;
 
-static constexpr uint32_t kMaxStackParticles = 256;
-static bool g_firstCorrectionLogged = false;
+// Position snapshot for the final pass — grown on demand, never shrunk
+static float*   g_snapshot    = nullptr;
+static uint32_t g_snapshotCap = 0;   // in floats
+
+// ---------------------------------------------------------------------------
+// Kernel check
+//
+// Each cylinder call also runs on copies of the buffer it was given:
+//   - the engine's own EnforceCylinderCollision, with the cloth's position
+//     pointer swapped to the copy for the call, against
+//     cloth_cylinder_vanilla_scalar — confirms the address, the calling
+//     convention and the model of the engine the fix is built from;
+//   - cloth_cylinder_scalar against the SSE kernel's output.
+// Particles differing by more than kCheckTolerance are counted per level
+// and the first kCheckLogLimit are logged.
+// ---------------------------------------------------------------------------
+
+static constexpr float kCheckTolerance = 1e-4f;   // relative, floored at 1 unit
+static constexpr int   kCheckLogLimit  = 8;
+
+struct KernelCheckStats {
+   uint32_t calls;
+   uint32_t particles;
+   uint32_t engineMismatches;
+   uint32_t kernelMismatches;
+   int      logged;
+};
+
+static KernelCheckStats g_check    = {};
+static float*           g_checkBuf = nullptr;   // pre | engine | reference, total * 3 floats each
+static uint32_t         g_checkCap = 0;         // floats per third
+
+static uint32_t check_particles(const char* what, void* cloth, const float* got, const float* want,
+                                uint32_t first, uint32_t last)
+{
+   uint32_t mismatches = 0;
+   for (uint32_t i = first; i < last; i++) {
+      const float* a = got + i * 3;
+      const float* b = want + i * 3;
+      for (int k = 0; k < 3; k++) {
+         float tol = kCheckTolerance * fmaxf(1.0f, fabsf(b[k]));
+         if (fabsf(a[k] - b[k]) <= tol) continue;
+
+         mismatches++;
+         if (g_check.logged < kCheckLogLimit) {
+            g_check.logged++;
+            get_gamelog()("[ClothCheck] %s mismatch: cloth %p particle %u got (%.6f %.6f %.6f) "
+                          "want (%.6f %.6f %.6f)\n",
+                          what, cloth, i, a[0], a[1], a[2], b[0], b[1], b[2]);
+         }
+         break;
+      }
+   }
+   return mismatches;
+}
+
+// Engine call on the check buffer; the cloth's pos pointer is put back
+// even if the engine faults.
+static bool run_engine_cylinder(void* ecx, float* buffer, float* mat, float halfHeight, float radius)
+{
+   float** posSlot = (float**)((uintptr_t)ecx + kPosBuffer_offset);
+   float*  live    = *posSlot;
+   bool    ok      = true;
+
+   *posSlot = buffer;
+   __try { original_EnforceCylinderCollision(ecx, nullptr, mat, halfHeight, radius); }
+   __except (EXCEPTION_EXECUTE_HANDLER) { ok = false; }
+   *posSlot = live;
+   return ok;
+}
+
+// pre holds the buffer as it was before the kernel ran on pos
+static void check_cylinder(void* ecx, const float* pos, float* mat, float halfHeight, float radius,
+                           uint32_t total, uint32_t fixed)
+{
+   const float* pre    = g_checkBuf;
+   float*       engine = g_checkBuf + g_checkCap;
+   float*       ref    = g_checkBuf + g_checkCap * 2;
+   size_t       bytes  = total * 3 * sizeof(float);
+
+   memcpy(engine, pre, bytes);
+   if (!run_engine_cylinder(ecx, engine, mat, halfHeight, radius)) {
+      get_gamelog()("[ClothCheck] engine EnforceCylinderCollision faulted - check off\n");
+      g_clothKernelCheck = false;
+      return;
+   }
+
+   memcpy(ref, pre, bytes);
+   for (uint32_t i = fixed; i < total; i++)
+      cloth_cylinder_vanilla_scalar(ref + i * 3, mat, halfHeight, radius);
+   g_check.engineMismatches += check_particles("engine", ecx, engine, ref, fixed, total);
+
+   memcpy(ref, pre, bytes);
+   for (uint32_t i = fixed; i < total; i++)
+      cloth_cylinder_scalar(ref + i * 3, mat, halfHeight, radius);
+   g_check.kernelMismatches += check_particles("kernel", ecx, pos, ref, fixed, total);
+
+   g_check.calls++;
+   g_check.particles += total - fixed;
+}
+
+// Make room for three copies of a total-particle buffer
+static bool reserve_check(uint32_t total)
+{
+   uint32_t floats = total * 3;
+   if (floats <= g_checkCap) return true;
+
+   uint32_t newCap = g_checkCap ? g_checkCap : 1024;
+   while (newCap < floats) newCap *= 2;
+   float* grown = new (std::nothrow) float[newCap * 3];
+   if (!grown) return false;
+   delete[] g_checkBuf;
+   g_checkBuf = grown;
+   g_checkCap = newCap;
+   return true;
+}
 
 // ---------------------------------------------------------------------------
 // Fixed EnforceCylinderCollision
@@ -77,74 +202,46 @@ static void __fastcall hooked_EnforceCylinderCollision(
    uint32_t totalCount = clothData[0];
    uint32_t fixedCount = clothData[1];
 
-   // Matrix layout (4x4, row-major as float[16]):
-   //   Axis X: mat[0..2]     Axis Y (cylinder axis): mat[4..6]
-   //   Axis Z: mat[8..10]    Translation (center):   mat[12..14]
-
-   for (uint32_t i = fixedCount; i < totalCount; i++) {
-      float* pos = posBuffer + i * 3;
-
-      // Vector from cylinder center to particle
-      float dx = pos[0] - mat[12];
-      float dy = pos[1] - mat[13];
-      float dz = pos[2] - mat[14];
-
-      // Project onto cylinder axis (Y axis of matrix)
-      float axisProj = dx * mat[4] + dy * mat[5] + dz * mat[6];
-
-      // Height check: particle must be within ±halfHeight of center
-      float heightPen = halfHeight - std::abs(axisProj);
-      if (heightPen <= 0.0f)
-         continue;
-
-      // Project onto radial plane (X and Z axes of matrix)
-      float radialX = dx * mat[0] + dy * mat[1] + dz * mat[2];
-      float radialZ = dx * mat[8] + dy * mat[9] + dz * mat[10];
-      float radialDist = std::sqrt(radialX * radialX + radialZ * radialZ);
-
-      // Radial check: particle must be within radius
-      float radialPen = radius - radialDist;
-      if (radialPen <= 0.0f)
-         continue;
-
-      // Inside cylinder — push out along axis of minimum penetration
-      if (heightPen <= radialPen) {
-         // Push along cylinder axis toward nearest cap
-         // FIX: use sign(axisProj) so we push AWAY from center, not always positive
-         float sign = (axisProj >= 0.0f) ? 1.0f : -1.0f;
-         pos[0] += sign * heightPen * mat[4];
-         pos[1] += sign * heightPen * mat[5];
-         pos[2] += sign * heightPen * mat[6];
-      }
-      else {
-         // Push radially outward
-         if (radialDist > 1e-6f) {
-            float scale = radialPen / radialDist;
-            pos[0] += (radialX * mat[0] + radialZ * mat[8]) * scale;
-            pos[1] += (radialX * mat[1] + radialZ * mat[9]) * scale;
-            pos[2] += (radialX * mat[2] + radialZ * mat[10]) * scale;
-         }
-      }
+   if (fixedCount >= totalCount) return;
+
+   if (g_clothCaptureEnabled) {
+      float params[2] = { halfHeight, radius };
+      cloth_capture_primitive(ecx, kClothPrimCylinder, mat, params);
    }
+
+   bool check = g_clothKernelCheck && reserve_check(totalCount);
+   if (check) memcpy(g_checkBuf, posBuffer, totalCount * 3 * sizeof(float));
+
+   cloth_collide_cylinder(posBuffer + fixedCount * 3, totalCount - fixedCount,
+                          mat, halfHeight, radius);
+
+   if (check) check_cylinder(ecx, posBuffer, mat, halfHeight, radius, totalCount, fixedCount);
 }
 
 // ---------------------------------------------------------------------------
 // SatisfyConstraints hook — final collision pass + old_pos velocity fix
 // ---------------------------------------------------------------------------
 
-static void __fastcall hooked_SatisfyConstraints(void* ecx, void* edx,
-                                                  void* param_2, int param_3, int param_4)
+static void satisfy_constraints(void* ecx, void* edx, void* param_2, int param_3, int param_4)
 {
-   // Run the full vanilla constraint solver (constraints + collisions)
-   original_SatisfyConstraints(ecx, edx, param_2, param_3, param_4);
-
-   // --- Final collision pass: give collision the last word ---
    uintptr_t self = (uintptr_t)ecx;
 
    float*    posBuffer    = *(float**)(self + kPosBuffer_offset);
    float*    oldPosBuffer = *(float**)(self + kOldPosBuffer_offset);
    uint32_t* clothData    = *(uint32_t**)(self + kClothData_offset);
 
+   // Sleeping / throttled cloth skips the solve entirely (see cloth_lod.hpp)
+   if (posBuffer && oldPosBuffer && clothData
+       && !cloth_lod_begin(ecx, posBuffer, oldPosBuffer, clothData[0], clothData[1]))
+      return;
+
+   bool captured = g_clothCaptureEnabled && posBuffer && oldPosBuffer && clothData
+                && cloth_capture_begin(ecx, posBuffer, oldPosBuffer, clothData[0], clothData[1]);
+
+   // Run the full vanilla constraint solver (constraints + collisions)
+   ext_perf_engine(kExtPerf_ClothSolve, [&] { original_SatisfyConstraints(ecx, edx, param_2, param_3, param_4); });
+
+   // --- Final collision pass: give collision the last word ---
    if (!posBuffer || !oldPosBuffer || !clothData)
       return;
 
@@ -157,8 +254,16 @@ static void __fastcall hooked_SatisfyConstraints(void* ecx, void* edx,
    uint32_t floatCount   = movableCount * 3;
 
    // Snapshot positions before final collision pass
-   float stackBuf[kMaxStackParticles * 3];
-   float* snapshot = (movableCount <= kMaxStackParticles) ? stackBuf : new float[floatCount];
+   if (floatCount > g_snapshotCap) {
+      uint32_t newCap = g_snapshotCap ? g_snapshotCap : 1024;
+      while (newCap < floatCount) newCap *= 2;
+      float* grown = new (std::nothrow) float[newCap];
+      if (!grown) return;
+      delete[] g_snapshot;
+      g_snapshot    = grown;
+      g_snapshotCap = newCap;
+   }
+   float* snapshot = g_snapshot;
 
    float* movablePos = posBuffer + fixedCount * 3;
    std::memcpy(snapshot, movablePos, floatCount * sizeof(float));
@@ -167,53 +272,17 @@ static void __fastcall hooked_SatisfyConstraints(void* ecx, void* edx,
    fn_EnforceCollisions(ecx, nullptr, param_2, param_3);
 
    // Fix old_pos for any particle displaced by the final collision pass
-   float* movableOldPos = oldPosBuffer + fixedCount * 3;
-   uint32_t fixedThisCall = 0;
-
-   for (uint32_t i = 0; i < movableCount; i++) {
-      uint32_t b = i * 3;
-
-      float dx = movablePos[b]     - snapshot[b];
-      float dy = movablePos[b + 1] - snapshot[b + 1];
-      float dz = movablePos[b + 2] - snapshot[b + 2];
-
-      if (dx == 0.0f && dy == 0.0f && dz == 0.0f)
-         continue;
+   cloth_correct_old_pos(movablePos, snapshot, oldPosBuffer + fixedCount * 3, movableCount);
 
-      float dLen2 = dx * dx + dy * dy + dz * dz;
-      if (dLen2 < 1e-10f)
-         continue;
+   if (captured) cloth_capture_end(posBuffer, oldPosBuffer, totalCount);
 
-      fixedThisCall++;
-
-      // Original velocity: snapshot_pos - old_pos
-      float vx = snapshot[b]     - movableOldPos[b];
-      float vy = snapshot[b + 1] - movableOldPos[b + 1];
-      float vz = snapshot[b + 2] - movableOldPos[b + 2];
-
-      float proj = (vx * dx + vy * dy + vz * dz) / dLen2;
-
-      if (proj < 0.0f) {
-         // Kill penetrating component, preserve tangential sliding
-         float vx_tang = vx - proj * dx;
-         float vy_tang = vy - proj * dy;
-         float vz_tang = vz - proj * dz;
-
-         movableOldPos[b]     = movablePos[b]     - vx_tang;
-         movableOldPos[b + 1] = movablePos[b + 1] - vy_tang;
-         movableOldPos[b + 2] = movablePos[b + 2] - vz_tang;
-      }
-      else {
-         movableOldPos[b]     += dx;
-         movableOldPos[b + 1] += dy;
-         movableOldPos[b + 2] += dz;
-      }
-   }
-
-   (void)fixedThisCall;
+   cloth_lod_end(ecx, posBuffer, oldPosBuffer, totalCount, fixedCount);
+}
 
-   if (snapshot != stackBuf)
-      delete[] snapshot;
+static void __fastcall hooked_SatisfyConstraints(void* ecx, void* edx,
+                                                  void* param_2, int param_3, int param_4)
+{
+   ext_perf_call(kExtPerf_ClothSolve, [&] { satisfy_constraints(ecx, edx, param_2, param_3, param_4); });
 }
 
 // ---------------------------------------------------------------------------
@@ -223,6 +292,8 @@ static void __fastcall hooked_SatisfyConstraints(void* ecx, void* edx,
 void cloth_collision_fix_install(uintptr_t exe_base)
 {
    using namespace game_addrs::modtools;
+   cloth_lod_install(exe_base);
+
    original_SatisfyConstraints = (fn_SatisfyConstraints_t)resolve(exe_base, cloth_satisfy_constraints);
    fn_EnforceCollisions = (fn_EnforceCollisions_t)resolve(exe_base, cloth_enforce_collisions);
    original_EnforceCylinderCollision = (fn_EnforceCylinderCollision_t)resolve(exe_base, cloth_enforce_cylinder_coll);
@@ -246,3 +317,13 @@ void cloth_collision_fix_uninstall()
       DetourDetach(&(PVOID&)original_EnforceCylinderCollision, hooked_EnforceCylinderCollision);
    DetourTransactionCommit();
 }
+
+void cloth_collision_fix_reset()
+{
+   if (g_check.calls) {
+      get_gamelog()("[ClothCheck] %u cylinder calls, %u particles: %u engine-model mismatches, "
+                    "%u kernel mismatches\n",
+                    g_check.calls, g_check.particles, g_check.engineMismatches, g_check.kernelMismatches);
+   }
+   g_check = {};
+}
@@ -13,9 +13,18 @@
 // The fix snapshots positions before collision, then for any displaced particle
 // kills the penetrating velocity component while preserving tangential sliding.
 //
+// With [Profiling] ClothKernelCheck=1 every EnforceCylinderCollision call is
+// also run through the engine's original and the scalar references on copies
+// of the buffer; mismatch counts are logged per level.
+//
 // Call cloth_collision_fix_install()   from lua_hooks_install().
 // Call cloth_collision_fix_uninstall() from lua_hooks_uninstall().
 // =============================================================================
 
+extern bool g_clothKernelCheck;
+
 void cloth_collision_fix_install(uintptr_t exe_base);
 void cloth_collision_fix_uninstall();
+
+// Level transition — log and clear the kernel check counters
+void cloth_collision_fix_reset();
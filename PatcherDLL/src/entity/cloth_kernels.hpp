@@ -0,0 +1,283 @@
+#pragma once
+
+#include <stdint.h>
+#include <math.h>
+#include <emmintrin.h>
+
+// =============================================================================
+// Cloth collision kernels (SSE) and Verlet correction
+//
+// Push cloth particles out of a collision primitive.  Positions are the
+// engine's packed float[3] array; four particles are loaded as three
+// unaligned vectors, transposed to x/y/z lanes, resolved together, and the
+// displacement is transposed back and added, so particles that don't collide
+// are left bit-identical.  The remainder (< 4) goes through the scalar
+// version of the same math.
+//
+// Primitive matrices are 4x4 row-major float[16]:
+//   Axis X: mat[0..2]   Axis Y: mat[4..6]   Axis Z: mat[8..10]
+//   Translation (center): mat[12..14]
+//
+// Semantics match the fixed cylinder in cloth_collision_fix.cpp: push along
+// the axis of minimum penetration, toward the nearest cap (sign of the
+// projection), with halfHeight measured from the center.
+//
+// Also here: the unfixed vanilla cylinder, which models the engine's own
+// EnforceCylinderCollision, and the Verlet old_pos correction used after
+// the final collision pass.  With [Profiling] ClothKernelCheck=1 the game
+// checks both against live solves (cloth_collision_fix.cpp).
+//
+// No engine or Windows dependencies — shared with any host-side tooling,
+// e.g. replaying a BF2GameExt_cloth_<n>.txt capture (cloth_capture.hpp).
+// =============================================================================
+
+// ---------------------------------------------------------------------------
+// Lane helpers
+// ---------------------------------------------------------------------------
+
+struct ClothLanes {
+   __m128 x, y, z;
+};
+
+// p[0..11] = x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3  ->  x0..3, y0..3, z0..3
+inline ClothLanes cloth_load4(const float* p, __m128& a, __m128& b, __m128& c)
+{
+   a = _mm_loadu_ps(p);
+   b = _mm_loadu_ps(p + 4);
+   c = _mm_loadu_ps(p + 8);
+
+   ClothLanes v;
+   __m128 bc = _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2));                  // b2 b2 c1 c1
+   v.x = _mm_shuffle_ps(a, bc, _MM_SHUFFLE(2, 0, 3, 0));                        // a0 a3 b2 c1
+   v.y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)),          // a1 a1 b0 b0
+                        _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)),          // b3 b3 c2 c2
+                        _MM_SHUFFLE(2, 0, 2, 0));
+   v.z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)),          // a2 a2 b1 b1
+                        _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)),          // c0 c0 c3 c3
+                        _MM_SHUFFLE(2, 0, 2, 0));
+   return v;
+}
+
+// Add lane displacements d back onto the packed vectors and store.
+inline void cloth_store4_add(float* p, __m128 a, __m128 b, __m128 c, const ClothLanes& d)
+{
+   __m128 xyLo = _mm_unpacklo_ps(d.x, d.y);                                     // x0 y0 x1 y1
+   __m128 xyHi = _mm_unpackhi_ps(d.x, d.y);                                     // x2 y2 x3 y3
+   __m128 yzLo = _mm_unpacklo_ps(d.y, d.z);                                     // y0 z0 y1 z1
+   __m128 zx   = _mm_shuffle_ps(d.z, d.x, _MM_SHUFFLE(1, 1, 0, 0));             // z0 z0 x1 x1
+
+   __m128 da = _mm_shuffle_ps(xyLo, zx, _MM_SHUFFLE(2, 0, 1, 0));               // x0 y0 z0 x1
+   __m128 db = _mm_shuffle_ps(yzLo, xyHi, _MM_SHUFFLE(1, 0, 3, 2));             // y1 z1 x2 y2
+   __m128 dc = _mm_shuffle_ps(_mm_shuffle_ps(d.z, d.x, _MM_SHUFFLE(3, 3, 2, 2)),// z2 z2 x3 x3
+                              _mm_shuffle_ps(d.y, d.z, _MM_SHUFFLE(3, 3, 3, 3)),// y3 y3 z3 z3
+                              _MM_SHUFFLE(2, 0, 2, 0));                         // z2 x3 y3 z3
+
+   _mm_storeu_ps(p,     _mm_add_ps(a, da));
+   _mm_storeu_ps(p + 4, _mm_add_ps(b, db));
+   _mm_storeu_ps(p + 8, _mm_add_ps(c, dc));
+}
+
+inline __m128 cloth_dot3(__m128 x, __m128 y, __m128 z, const float* axis)
+{
+   return _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(axis[0])),
+                                _mm_mul_ps(y, _mm_set1_ps(axis[1]))),
+                     _mm_mul_ps(z, _mm_set1_ps(axis[2])));
+}
+
+inline __m128 cloth_abs(__m128 v)
+{
+   return _mm_andnot_ps(_mm_set1_ps(-0.0f), v);
+}
+
+// +1 where v >= 0, -1 elsewhere (same as the scalar (v >= 0) ? 1 : -1)
+inline __m128 cloth_sign(__m128 v)
+{
+   __m128 ge = _mm_cmpge_ps(v, _mm_setzero_ps());
+   return _mm_or_ps(_mm_and_ps(ge, _mm_set1_ps(1.0f)), _mm_andnot_ps(ge, _mm_set1_ps(-1.0f)));
+}
+
+inline __m128 cloth_select(__m128 mask, __m128 a, __m128 b)
+{
+   return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+// ---------------------------------------------------------------------------
+// Cylinder — axis is matrix Y, radial plane is X/Z
+// ---------------------------------------------------------------------------
+
+inline void cloth_cylinder_scalar(float* pos, const float* mat, float halfHeight, float radius)
+{
+   float dx = pos[0] - mat[12];
+   float dy = pos[1] - mat[13];
+   float dz = pos[2] - mat[14];
+
+   float axisProj  = dx * mat[4] + dy * mat[5] + dz * mat[6];
+   float heightPen = halfHeight - fabsf(axisProj);
+   if (heightPen <= 0.0f) return;
+
+   float radialX    = dx * mat[0] + dy * mat[1] + dz * mat[2];
+   float radialZ    = dx * mat[8] + dy * mat[9] + dz * mat[10];
+   float radialDist = sqrtf(radialX * radialX + radialZ * radialZ);
+   float radialPen  = radius - radialDist;
+   if (radialPen <= 0.0f) return;
+
+   if (heightPen <= radialPen) {
+      float sign = (axisProj >= 0.0f) ? 1.0f : -1.0f;
+      pos[0] += sign * heightPen * mat[4];
+      pos[1] += sign * heightPen * mat[5];
+      pos[2] += sign * heightPen * mat[6];
+   }
+   else if (radialDist > 1e-6f) {
+      float scale = radialPen / radialDist;
+      pos[0] += (radialX * mat[0] + radialZ * mat[8]) * scale;
+      pos[1] += (radialX * mat[1] + radialZ * mat[9]) * scale;
+      pos[2] += (radialX * mat[2] + radialZ * mat[10]) * scale;
+   }
+}
+
+inline void cloth_collide_cylinder(float* pos, uint32_t count, const float* mat,
+                                   float halfHeight, float radius)
+{
+   const __m128 cx = _mm_set1_ps(mat[12]);
+   const __m128 cy = _mm_set1_ps(mat[13]);
+   const __m128 cz = _mm_set1_ps(mat[14]);
+   const __m128 hh = _mm_set1_ps(halfHeight);
+   const __m128 rr = _mm_set1_ps(radius);
+   const __m128 zero = _mm_setzero_ps();
+
+   uint32_t i = 0;
+   for (; i + 4 <= count; i += 4) {
+      float* p = pos + i * 3;
+      __m128 a, b, c;
+      ClothLanes v = cloth_load4(p, a, b, c);
+
+      __m128 rx = _mm_sub_ps(v.x, cx);
+      __m128 ry = _mm_sub_ps(v.y, cy);
+      __m128 rz = _mm_sub_ps(v.z, cz);
+
+      __m128 axisProj  = cloth_dot3(rx, ry, rz, mat + 4);
+      __m128 heightPen = _mm_sub_ps(hh, cloth_abs(axisProj));
+
+      __m128 radialX    = cloth_dot3(rx, ry, rz, mat + 0);
+      __m128 radialZ    = cloth_dot3(rx, ry, rz, mat + 8);
+      __m128 radialDist = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(radialX, radialX),
+                                                 _mm_mul_ps(radialZ, radialZ)));
+      __m128 radialPen  = _mm_sub_ps(rr, radialDist);
+
+      __m128 inside = _mm_and_ps(_mm_cmpgt_ps(heightPen, zero), _mm_cmpgt_ps(radialPen, zero));
+      if (!_mm_movemask_ps(inside)) continue;
+
+      // Axis push toward the nearest cap
+      __m128 axisAmt = _mm_mul_ps(cloth_sign(axisProj), heightPen);
+
+      // Radial push (lanes with radialDist ~ 0 are masked out below)
+      __m128 scale = _mm_div_ps(radialPen, radialDist);
+      __m128 sx = _mm_mul_ps(radialX, scale);
+      __m128 sz = _mm_mul_ps(radialZ, scale);
+
+      __m128 useAxis  = _mm_cmple_ps(heightPen, radialPen);
+      __m128 radialOk = _mm_cmpgt_ps(radialDist, _mm_set1_ps(1e-6f));
+      __m128 radMask  = _mm_andnot_ps(useAxis, _mm_and_ps(inside, radialOk));
+      __m128 axMask   = _mm_and_ps(useAxis, inside);
+
+      ClothLanes d;
+      d.x = _mm_or_ps(_mm_and_ps(axMask, _mm_mul_ps(axisAmt, _mm_set1_ps(mat[4]))),
+                      _mm_and_ps(radMask, _mm_add_ps(_mm_mul_ps(sx, _mm_set1_ps(mat[0])),
+                                                     _mm_mul_ps(sz, _mm_set1_ps(mat[8])))));
+      d.y = _mm_or_ps(_mm_and_ps(axMask, _mm_mul_ps(axisAmt, _mm_set1_ps(mat[5]))),
+                      _mm_and_ps(radMask, _mm_add_ps(_mm_mul_ps(sx, _mm_set1_ps(mat[1])),
+                                                     _mm_mul_ps(sz, _mm_set1_ps(mat[9])))));
+      d.z = _mm_or_ps(_mm_and_ps(axMask, _mm_mul_ps(axisAmt, _mm_set1_ps(mat[6]))),
+                      _mm_and_ps(radMask, _mm_add_ps(_mm_mul_ps(sx, _mm_set1_ps(mat[2])),
+                                                     _mm_mul_ps(sz, _mm_set1_ps(mat[10])))));
+
+      cloth_store4_add(p, a, b, c, d);
+   }
+
+   for (; i < count; i++)
+      cloth_cylinder_scalar(pos + i * 3, mat, halfHeight, radius);
+}
+
+// Unfixed engine behavior — always pushes toward +axis and tests against
+// 2 * halfHeight.  Model of the engine's EnforceCylinderCollision; the
+// fixed kernel differs from it only by those two changes.
+inline void cloth_cylinder_vanilla_scalar(float* pos, const float* mat, float halfHeight, float radius)
+{
+   float dx = pos[0] - mat[12];
+   float dy = pos[1] - mat[13];
+   float dz = pos[2] - mat[14];
+
+   float axisProj  = dx * mat[4] + dy * mat[5] + dz * mat[6];
+   float heightPen = (halfHeight + halfHeight) - fabsf(axisProj);
+   if (heightPen <= 0.0f) return;
+
+   float radialX    = dx * mat[0] + dy * mat[1] + dz * mat[2];
+   float radialZ    = dx * mat[8] + dy * mat[9] + dz * mat[10];
+   float radialDist = sqrtf(radialX * radialX + radialZ * radialZ);
+   float radialPen  = radius - radialDist;
+   if (radialPen <= 0.0f) return;
+
+   if (heightPen <= radialPen) {
+      pos[0] += heightPen * mat[4];
+      pos[1] += heightPen * mat[5];
+      pos[2] += heightPen * mat[6];
+   }
+   else if (radialDist > 1e-6f) {
+      float scale = radialPen / radialDist;
+      pos[0] += (radialX * mat[0] + radialZ * mat[8]) * scale;
+      pos[1] += (radialX * mat[1] + radialZ * mat[9]) * scale;
+      pos[2] += (radialX * mat[2] + radialZ * mat[10]) * scale;
+   }
+}
+
+// ---------------------------------------------------------------------------
+// Verlet velocity correction after a collision pass
+//
+// Collision moves pos but not old_pos, so the implicit velocity
+// (pos - old_pos) would push the particle straight back in next frame.
+// For every particle the pass displaced (before -> pos), kill the velocity
+// component into the surface and keep tangential sliding.  Returns the
+// number of particles corrected.
+// ---------------------------------------------------------------------------
+
+inline uint32_t cloth_correct_old_pos(const float* pos, const float* before, float* oldPos, uint32_t count)
+{
+   uint32_t corrected = 0;
+
+   for (uint32_t i = 0; i < count; i++) {
+      uint32_t b = i * 3;
+
+      float dx = pos[b]     - before[b];
+      float dy = pos[b + 1] - before[b + 1];
+      float dz = pos[b + 2] - before[b + 2];
+
+      if (dx == 0.0f && dy == 0.0f && dz == 0.0f)
+         continue;
+
+      float dLen2 = dx * dx + dy * dy + dz * dz;
+      if (dLen2 < 1e-10f)
+         continue;
+
+      corrected++;
+
+      // Original velocity: before - old_pos
+      float vx = before[b]     - oldPos[b];
+      float vy = before[b + 1] - oldPos[b + 1];
+      float vz = before[b + 2] - oldPos[b + 2];
+
+      float proj = (vx * dx + vy * dy + vz * dz) / dLen2;
+
+      if (proj < 0.0f) {
+         // Kill penetrating component, preserve tangential sliding
+         oldPos[b]     = pos[b]     - (vx - proj * dx);
+         oldPos[b + 1] = pos[b + 1] - (vy - proj * dy);
+         oldPos[b + 2] = pos[b + 2] - (vz - proj * dz);
+      }
+      else {
+         oldPos[b]     += dx;
+         oldPos[b + 1] += dy;
+         oldPos[b + 2] += dz;
+      }
+   }
+   return corrected;
+}
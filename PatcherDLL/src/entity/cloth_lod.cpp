@@ -0,0 +1,322 @@
+#include "pch.h"
+#include "cloth_lod.hpp"
+#include "core/resolve.hpp"
+#include "render/frame_clock.hpp"
+#include "render/red_camera.hpp"
+
+#include <cmath>
+#include <cstring>
+
+bool  g_clothLodEnabled      = false;
+int   g_clothSleepFrames     = 30;
+float g_clothLodDistance     = 60.0f;
+int   g_clothFarTickInterval = 3;
+bool  g_clothCullOffscreen   = true;
+
+// ---------------------------------------------------------------------------
+// Thresholds (world units, L-infinity per particle)
+// ---------------------------------------------------------------------------
+
+static constexpr float kSleepEpsilon  = 0.001f;   // per-frame movement counted as "still"
+static constexpr float kAnchorEpsilon = 0.0005f;  // fixed-particle movement that wakes
+static constexpr float kWakeEpsilon   = 0.002f;   // change in the integration step that wakes
+static constexpr float kCullRadius    = 4.0f;     // cloth bounding radius for the view test
+
+static constexpr DWORD kStatsLogIntervalMs = 10000;
+
+// ---------------------------------------------------------------------------
+// Per-cloth record
+// ---------------------------------------------------------------------------
+
+static constexpr int kMaxCloths = 64;
+
+struct ClothRecord {
+   void*    cloth;          // EntityCloth*, nullptr = free
+   uint32_t total;          // particle count the buffers were sized for
+   float*   rest;           // pos after the last solve
+   float*   restOld;        // old_pos after the last solve
+   uint32_t cap;            // floats per buffer
+   bool     hasRest;
+   bool     asleep;
+   int      stillFrames;
+   int      tick;
+   float    entryDev;       // integration step seen this frame
+   float    sleepEntryDev;  // integration step when it fell asleep
+   DWORD    lastSeenMs;
+};
+
+static ClothRecord  g_cloths[kMaxCloths] = {};
+static ClothRecord* g_lastRec = nullptr;
+
+static ClothLodStats g_statsCur   = {};
+static ClothLodStats g_statsLast  = {};
+static ClothLodStats g_statsWin   = {};
+static uint32_t      g_winFrames  = 0;
+static DWORD         g_winStartMs = 0;
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+static void releaseRecord(ClothRecord* rec)
+{
+   delete[] rec->rest;
+   delete[] rec->restOld;
+   memset(rec, 0, sizeof(*rec));
+}
+
+static ClothRecord* findRecord(void* cloth)
+{
+   if (g_lastRec && g_lastRec->cloth == cloth) return g_lastRec;
+   for (int i = 0; i < kMaxCloths; i++) {
+      if (g_cloths[i].cloth == cloth) {
+         g_lastRec = &g_cloths[i];
+         return g_lastRec;
+      }
+   }
+   return nullptr;
+}
+
+static ClothRecord* findOrCreateRecord(void* cloth, uint32_t total)
+{
+   ClothRecord* rec = findRecord(cloth);
+
+   if (!rec) {
+      // Free slot, or evict the cloth seen longest ago
+      ClothRecord* oldest = &g_cloths[0];
+      for (int i = 0; i < kMaxCloths && !rec; i++) {
+         if (!g_cloths[i].cloth) rec = &g_cloths[i];
+         else if ((LONG)(g_cloths[i].lastSeenMs - oldest->lastSeenMs) < 0) oldest = &g_cloths[i];
+      }
+      if (!rec) {
+         rec = oldest;
+         float* rest    = rec->rest;
+         float* restOld = rec->restOld;
+         uint32_t cap   = rec->cap;
+         memset(rec, 0, sizeof(*rec));
+         rec->rest = rest; rec->restOld = restOld; rec->cap = cap;
+      }
+      rec->cloth = cloth;
+      g_lastRec  = rec;
+   }
+
+   // New cloth at a recycled address, or a resized one — start over
+   if (rec->total != total) {
+      rec->total       = total;
+      rec->hasRest     = false;
+      rec->asleep      = false;
+      rec->stillFrames = 0;
+   }
+
+   uint32_t floats = total * 3;
+   if (floats > rec->cap) {
+      delete[] rec->rest;
+      delete[] rec->restOld;
+      rec->rest    = new float[floats];
+      rec->restOld = new float[floats];
+      rec->cap     = floats;
+      rec->hasRest = false;
+   }
+   return rec;
+}
+
+static float maxDeviation(const float* a, const float* b, uint32_t first, uint32_t last)
+{
+   float dev = 0.0f;
+   for (uint32_t i = first * 3; i < last * 3; i++) {
+      float d = fabsf(a[i] - b[i]);
+      if (d > dev) dev = d;
+   }
+   return dev;
+}
+
+// Hold the movable particles at their last solved shape, carried by the
+// mean movement of the fixed particles since then — cloth on a moving owner
+// keeps up with it instead of snapping back to where it was last solved.
+// Fixed particles keep whatever the engine attached them to this frame.
+// The carried state becomes the new rest.
+static void restoreMovable(ClothRecord* rec, float* pos, float* oldPos, uint32_t fixed)
+{
+   float delta[3] = {};
+   for (uint32_t i = 0; i < fixed * 3; i += 3) {
+      delta[0] += pos[i]     - rec->rest[i];
+      delta[1] += pos[i + 1] - rec->rest[i + 1];
+      delta[2] += pos[i + 2] - rec->rest[i + 2];
+   }
+   if (fixed) {
+      float inv = 1.0f / (float)fixed;
+      delta[0] *= inv; delta[1] *= inv; delta[2] *= inv;
+   }
+
+   for (uint32_t i = fixed * 3; i < rec->total * 3; i += 3) {
+      for (int k = 0; k < 3; k++) {
+         pos[i + k]    = rec->rest[i + k]    += delta[k];
+         oldPos[i + k] = rec->restOld[i + k] += delta[k];
+      }
+   }
+   memcpy(rec->rest,    pos,    fixed * 3 * sizeof(float));
+   memcpy(rec->restOld, oldPos, fixed * 3 * sizeof(float));
+}
+
+// Where the cloth is for LOD: the centroid of its fixed particles (the
+// attachment to the owner), or the centre of its bounds if it has none.
+static void clothCentre(const float* pos, uint32_t total, uint32_t fixed, float* centre)
+{
+   if (fixed) {
+      centre[0] = centre[1] = centre[2] = 0.0f;
+      for (uint32_t i = 0; i < fixed * 3; i += 3) {
+         centre[0] += pos[i];
+         centre[1] += pos[i + 1];
+         centre[2] += pos[i + 2];
+      }
+      float inv = 1.0f / (float)fixed;
+      centre[0] *= inv; centre[1] *= inv; centre[2] *= inv;
+      return;
+   }
+
+   float lo[3] = { pos[0], pos[1], pos[2] };
+   float hi[3] = { pos[0], pos[1], pos[2] };
+   for (uint32_t i = 3; i < total * 3; i += 3) {
+      for (int k = 0; k < 3; k++) {
+         lo[k] = fminf(lo[k], pos[i + k]);
+         hi[k] = fmaxf(hi[k], pos[i + k]);
+      }
+   }
+   for (int k = 0; k < 3; k++) centre[k] = (lo[k] + hi[k]) * 0.5f;
+}
+
+// Distant or off-screen cloth solves at a reduced rate
+static bool isThrottled(const float* anchor)
+{
+   const float* m = red_camera_matrix();
+   if (!m) return false;
+
+   if (g_clothLodDistance > 0.0f) {
+      float rx = anchor[0] - m[12], ry = anchor[1] - m[13], rz = anchor[2] - m[14];
+      float d2 = rx * rx + ry * ry + rz * rz;
+      if (d2 > g_clothLodDistance * g_clothLodDistance) return true;
+   }
+
+   return g_clothCullOffscreen && !camera_cone_test(anchor, kCullRadius);
+}
+
+// Frame clock callback — close this frame's counters
+static void statsEndFrame()
+{
+   if (!g_clothLodEnabled) return;
+
+   g_statsLast = g_statsCur;
+   g_statsWin.active    += g_statsCur.active;
+   g_statsWin.sleeping  += g_statsCur.sleeping;
+   g_statsWin.throttled += g_statsCur.throttled;
+   g_statsCur = {};
+   g_winFrames++;
+
+   DWORD now = GetTickCount();
+   if (!g_winStartMs) g_winStartMs = now;
+   if (now - g_winStartMs >= kStatsLogIntervalMs) {
+      if (g_statsWin.active + g_statsWin.sleeping + g_statsWin.throttled) {
+         float f = (float)g_winFrames;
+         get_gamelog()("[ClothLOD] per frame over %u frames: %.1f active, %.1f sleeping, %.1f throttled\n",
+                       g_winFrames, g_statsWin.active / f, g_statsWin.sleeping / f,
+                       g_statsWin.throttled / f);
+      }
+      g_statsWin   = {};
+      g_winFrames  = 0;
+      g_winStartMs = now;
+   }
+}
+
+// ---------------------------------------------------------------------------
+// Public
+// ---------------------------------------------------------------------------
+
+bool cloth_lod_begin(void* cloth, float* pos, float* oldPos, uint32_t total, uint32_t fixed)
+{
+   if (!g_clothLodEnabled || fixed >= total) return true;
+
+   ClothRecord* rec = findOrCreateRecord(cloth, total);
+   if (!rec || !rec->rest) return true;
+
+   rec->lastSeenMs = GetTickCount();
+
+   if (!rec->hasRest) {
+      g_statsCur.active++;
+      return true;
+   }
+
+   // What moved since the last solve: anchors (owner / primitives) and the
+   // movable particles (this frame's Verlet integration step).
+   float anchorDev = fixed ? maxDeviation(pos, rec->rest, 0, fixed) : 0.0f;
+   rec->entryDev   = maxDeviation(pos, rec->rest, fixed, total);
+
+   if (rec->asleep) {
+      if (anchorDev > kAnchorEpsilon || fabsf(rec->entryDev - rec->sleepEntryDev) > kWakeEpsilon) {
+         rec->asleep      = false;
+         rec->stillFrames = 0;
+      }
+      else {
+         restoreMovable(rec, pos, oldPos, fixed);
+         g_statsCur.sleeping++;
+         return false;
+      }
+   }
+
+   float centre[3];
+   clothCentre(pos, total, fixed, centre);
+   if (isThrottled(centre)) {
+      if (++rec->tick < g_clothFarTickInterval) {
+         restoreMovable(rec, pos, oldPos, fixed);
+         g_statsCur.throttled++;
+         return false;
+      }
+   }
+   rec->tick = 0;
+
+   g_statsCur.active++;
+   return true;
+}
+
+void cloth_lod_end(void* cloth, float* pos, float* oldPos, uint32_t total, uint32_t fixed)
+{
+   if (!g_clothLodEnabled || fixed >= total) return;
+
+   ClothRecord* rec = findRecord(cloth);
+   if (!rec || !rec->rest || rec->total != total) return;
+
+   if (rec->hasRest) {
+      float moved = maxDeviation(pos, rec->rest, fixed, total);
+      if (moved < kSleepEpsilon) {
+         if (++rec->stillFrames >= g_clothSleepFrames) {
+            rec->asleep        = true;
+            rec->sleepEntryDev = rec->entryDev;
+         }
+      }
+      else {
+         rec->stillFrames = 0;
+      }
+   }
+
+   memcpy(rec->rest,    pos,    total * 3 * sizeof(float));
+   memcpy(rec->restOld, oldPos, total * 3 * sizeof(float));
+   rec->hasRest = true;
+}
+
+void cloth_lod_get_stats(ClothLodStats* lastFrame)
+{
+   *lastFrame = g_statsLast;
+}
+
+void cloth_lod_install(uintptr_t /*exe_base*/)
+{
+   frame_clock_on_frame_end(statsEndFrame);
+}
+
+void cloth_lod_reset()
+{
+   for (int i = 0; i < kMaxCloths; i++)
+      releaseRecord(&g_cloths[i]);
+   g_lastRec   = nullptr;
+   g_statsCur  = {};
+   g_statsLast = {};
+}
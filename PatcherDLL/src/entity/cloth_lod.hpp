@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stdint.h>
+
+// =============================================================================
+// Cloth Sleep / Visibility LOD
+//
+// Wraps EntityCloth::SatisfyConstraints (see cloth_collision_fix.cpp).  Each
+// cloth keeps a copy of its last solved pos / old_pos buffers:
+//
+//   Sleep     — a cloth whose particles moved less than kSleepEpsilon per
+//               frame for SleepFrames solves in a row goes to sleep.  While
+//               asleep the frame's Verlet integration is dropped, the rest
+//               state is carried along by the mean movement of the fixed
+//               particles, and the solve is skipped.
+//   Wake      — a fixed (attached) particle moved, i.e. the owner or its
+//               collision primitives moved, or the integration step differs
+//               from the one seen when it fell asleep (wind / velocity change).
+//   Throttle  — cloth whose anchor centroid (bounds centre if it has no
+//               fixed particles) is past LodDistance or outside the camera
+//               view solves every FarTickInterval frames; in between it
+//               holds its last solved shape, carried like a sleeping cloth
+//               (time stands still rather than drifting unconstrained).
+//
+// Counters of active / sleeping / throttled cloths are logged every 10 s.
+// Gated on [ClothLOD] Enabled=1, off by default.
+// =============================================================================
+
+extern bool  g_clothLodEnabled;
+extern int   g_clothSleepFrames;
+extern float g_clothLodDistance;       // 0 = no distance throttle
+extern int   g_clothFarTickInterval;
+extern bool  g_clothCullOffscreen;
+
+struct ClothLodStats {
+   uint32_t active;      // solved this frame
+   uint32_t sleeping;
+   uint32_t throttled;
+};
+
+// Before SatisfyConstraints.  Returns false if the solve should be skipped —
+// pos / old_pos have then already been restored to the last solved state.
+bool cloth_lod_begin(void* cloth, float* pos, float* oldPos, uint32_t total, uint32_t fixed);
+
+// After a full solve (including the final collision pass).
+void cloth_lod_end(void* cloth, float* pos, float* oldPos, uint32_t total, uint32_t fixed);
+
+// Counters of the last completed frame
+void cloth_lod_get_stats(ClothLodStats* lastFrame);
+
+void cloth_lod_install(uintptr_t exe_base);
+
+// Level transition — forget every cloth.
+void cloth_lod_reset();
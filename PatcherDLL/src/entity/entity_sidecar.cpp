@@ -0,0 +1,407 @@
+#include "pch.h"
+#include "entity_sidecar.hpp"
+#include "core/game_addrs.hpp"
+#include "core/resolve.hpp"
+
+#include <detours.h>
+#include <cstring>
+
+// Entity::mHandleId, the generation half of a PblHandle (aim_assist.cpp)
+static constexpr uintptr_t kSidecarHandleIdOffset = 0x204;
+
+// EntityCarrier::~EntityCarrier can be entered with the object base or the
+// +0x240 sub-object (flyer_carrier_fixes.cpp), so both are dropped
+static constexpr uintptr_t kCarrier_SubObject = 0x240;
+
+static constexpr int kIndexBits = 12;               // 2 x kSidecarMaxEntities
+static constexpr int kIndexSize = 1 << kIndexBits;
+
+// =============================================================================
+// Entity records
+// =============================================================================
+
+// A PblHandle: the pointer plus the entity's handle id when it was attached
+struct SidecarRecord {
+   void*    entity;                      // nullptr = free
+   uint32_t handleId;
+   bool     checked;                     // key is an Entity with a handle id
+   int16_t  slot[kSidecarMaxTypes];      // dense index in each pool, -1 = none
+   int      components;
+};
+
+static SidecarRecord s_records[kSidecarMaxEntities];
+static int16_t       s_freeRecords[kSidecarMaxEntities];
+static int           s_freeCount = 0;
+static int16_t       s_index[kIndexSize];              // record, -1 = empty
+static int           s_liveRecords = 0;
+
+// =============================================================================
+// Component pools
+// =============================================================================
+
+struct SidecarPool {
+   const char*      name;
+   uint32_t         stride;              // size rounded up to 8
+   int              capacity;
+   int              count;
+   char*            blobs;               // capacity * stride, [0, count) live
+   int16_t*         owner;               // record of each live blob
+   SidecarRelease_t release;
+   bool             entityKeyed;
+   int              peak;
+   uint32_t         full;                // attaches refused
+};
+
+static SidecarPool s_pools[kSidecarMaxTypes];
+static int         s_poolCount = 0;
+static uint32_t    s_staleDrops = 0;
+
+// Destructors that drop components before the entity is freed
+static bool        s_entityDtorHooked  = false;
+static bool        s_carrierDtorHooked = false;
+
+static GameLog_t   g_log = nullptr;
+
+// =============================================================================
+// Index
+// =============================================================================
+
+static inline uint32_t ptr_hash(const void* entity)
+{
+   return (((uint32_t)(uintptr_t)entity >> 3) * 0x9E3779B1u) >> (32 - kIndexBits);
+}
+
+static int index_find(const void* entity)
+{
+   uint32_t i = ptr_hash(entity);
+   for (int16_t r; (r = s_index[i]) >= 0; i = (i + 1) & (kIndexSize - 1)) {
+      if (s_records[r].entity == entity) return (int)i;
+   }
+   return -1;
+}
+
+static void index_insert(int r)
+{
+   uint32_t i = ptr_hash(s_records[r].entity);
+   while (s_index[i] >= 0) i = (i + 1) & (kIndexSize - 1);
+   s_index[i] = (int16_t)r;
+}
+
+// Backward-shift delete, no tombstones
+static void index_remove(uint32_t i)
+{
+   for (;;) {
+      s_index[i] = -1;
+      uint32_t j = i;
+      for (;;) {
+         j = (j + 1) & (kIndexSize - 1);
+         const int16_t r = s_index[j];
+         if (r < 0) return;
+         const uint32_t h = ptr_hash(s_records[r].entity);
+         if (((j - h) & (kIndexSize - 1)) >= ((j - i) & (kIndexSize - 1))) {
+            s_index[i] = r;
+            i = j;
+            break;
+         }
+      }
+   }
+}
+
+// -1 never matches a stored id, so an unreadable entity reads as stale
+static uint32_t handle_id(const void* entity)
+{
+   __try {
+      return *(const uint32_t*)((const char*)entity + kSidecarHandleIdOffset);
+   } __except (EXCEPTION_EXECUTE_HANDLER) {
+      return 0xFFFFFFFFu;
+   }
+}
+
+// =============================================================================
+// Pool ops
+// =============================================================================
+
+static inline char* blob_at(const SidecarPool& p, int i)
+{
+   return p.blobs + (size_t)i * p.stride;
+}
+
+// Drop record r's blob in pool t; the pool's last blob moves into the hole
+static void pool_remove(int t, int r)
+{
+   SidecarPool& p = s_pools[t];
+   SidecarRecord& rec = s_records[r];
+   const int i = rec.slot[t];
+   if (i < 0) return;
+
+   if (p.release) p.release(blob_at(p, i), rec.entity);
+
+   const int last = --p.count;
+   if (i != last) {
+      memcpy(blob_at(p, i), blob_at(p, last), p.stride);
+      p.owner[i] = p.owner[last];
+      s_records[p.owner[i]].slot[t] = (int16_t)i;
+   }
+   memset(blob_at(p, last), 0, p.stride);
+   rec.slot[t] = -1;
+   rec.components--;
+}
+
+static void record_free(int r)
+{
+   index_remove((uint32_t)index_find(s_records[r].entity));
+   s_records[r].entity = nullptr;
+   s_freeRecords[s_freeCount++] = (int16_t)r;
+   s_liveRecords--;
+}
+
+static void record_drop(int r)
+{
+   for (int t = 0; t < s_poolCount; t++) pool_remove(t, r);
+   record_free(r);
+}
+
+// Record for entity, or -1.  A record whose handle id no longer matches
+// belongs to an entity destroyed without a hooked dtor and whose memory has
+// since been reused; it's dropped here.
+static int record_find(const void* entity)
+{
+   const int at = index_find(entity);
+   if (at < 0) return -1;
+   const int r = s_index[at];
+   if (s_records[r].checked && s_records[r].handleId != handle_id(entity)) {
+      s_staleDrops++;
+      record_drop(r);
+      return -1;
+   }
+   return r;
+}
+
+// Drop every record whose handle id has moved on
+static int sweep_stale()
+{
+   int dropped = 0;
+   for (int r = 0; r < kSidecarMaxEntities; r++) {
+      const void* e = s_records[r].entity;
+      if (e && s_records[r].checked && s_records[r].handleId != handle_id(e)) {
+         record_drop(r);
+         dropped++;
+      }
+   }
+   s_staleDrops += dropped;
+   return dropped;
+}
+
+static void clear_all()
+{
+   for (int r = 0; r < kSidecarMaxEntities; r++)
+      if (s_records[r].entity) record_drop(r);
+
+   memset(s_index, -1, sizeof(s_index));
+   for (int r = 0; r < kSidecarMaxEntities; r++) {
+      s_records[r].entity = nullptr;
+      s_records[r].components = 0;
+      memset(s_records[r].slot, -1, sizeof(s_records[r].slot));
+      s_freeRecords[r] = (int16_t)(kSidecarMaxEntities - 1 - r);
+   }
+   s_freeCount   = kSidecarMaxEntities;
+   s_liveRecords = 0;
+}
+
+// =============================================================================
+// API
+// =============================================================================
+
+int sidecar_register(const char* name, uint32_t size, int capacity, SidecarRelease_t release,
+                     bool entityKeyed)
+{
+   for (int t = 0; t < s_poolCount; t++)
+      if (strcmp(s_pools[t].name, name) == 0) return t;
+   if (s_poolCount == kSidecarMaxTypes || !size || capacity <= 0) return -1;
+   if (capacity > kSidecarMaxEntities) capacity = kSidecarMaxEntities;
+
+   // First registration sets the index up
+   if (!s_poolCount && !s_freeCount && !s_liveRecords) clear_all();
+
+   SidecarPool& p = s_pools[s_poolCount];
+   p.name     = name;
+   p.stride   = (size + 7) & ~7u;
+   p.capacity = capacity;
+   p.count    = 0;
+   p.blobs    = new char[(size_t)capacity * p.stride]();
+   p.owner    = new int16_t[capacity];
+   p.release  = release;
+   p.entityKeyed = entityKeyed;
+   p.peak     = 0;
+   p.full     = 0;
+   return s_poolCount++;
+}
+
+void* sidecar_get(int type, void* entity)
+{
+   if (type < 0 || type >= s_poolCount || !entity) return nullptr;
+   const int r = record_find(entity);
+   if (r < 0) return nullptr;
+   const int i = s_records[r].slot[type];
+   return i >= 0 ? blob_at(s_pools[type], i) : nullptr;
+}
+
+void* sidecar_attach(int type, void* entity, bool* created)
+{
+   if (created) *created = false;
+   if (type < 0 || type >= s_poolCount || !entity) return nullptr;
+   SidecarPool& p = s_pools[type];
+
+   int r = record_find(entity);
+   if (r >= 0 && s_records[r].slot[type] >= 0) return blob_at(p, s_records[r].slot[type]);
+
+   if (p.count == p.capacity || (r < 0 && !s_freeCount)) {
+      // Entities destroyed without a hooked dtor may still be holding slots
+      if (!sweep_stale() || p.count == p.capacity || (r < 0 && !s_freeCount)) {
+         p.full++;
+         return nullptr;
+      }
+      r = record_find(entity);
+   }
+
+   if (r < 0) {
+      r = s_freeRecords[--s_freeCount];
+      SidecarRecord& rec = s_records[r];
+      rec.entity     = entity;
+      rec.checked    = p.entityKeyed;
+      rec.handleId   = rec.checked ? handle_id(entity) : 0;
+      rec.components = 0;
+      memset(rec.slot, -1, sizeof(rec.slot));
+      index_insert(r);
+      s_liveRecords++;
+   }
+
+   const int i = p.count++;
+   if (p.count > p.peak) p.peak = p.count;
+   p.owner[i] = (int16_t)r;
+   s_records[r].slot[type] = (int16_t)i;
+   s_records[r].components++;
+   if (created) *created = true;
+   return blob_at(p, i);
+}
+
+void sidecar_detach(int type, void* entity)
+{
+   if (type < 0 || type >= s_poolCount || !entity) return;
+   const int r = record_find(entity);
+   if (r < 0) return;
+   pool_remove(type, r);
+   if (!s_records[r].components) record_free(r);
+}
+
+void sidecar_detach_all(void* entity)
+{
+   if (!entity || !s_poolCount) return;
+   const int at = index_find(entity);
+   if (at >= 0) record_drop(s_index[at]);
+}
+
+int sidecar_count(int type)
+{
+   return (type >= 0 && type < s_poolCount) ? s_pools[type].count : 0;
+}
+
+void* sidecar_at(int type, int index, void** entityOut)
+{
+   if (type < 0 || type >= s_poolCount) return nullptr;
+   const SidecarPool& p = s_pools[type];
+   if (index < 0 || index >= p.count) return nullptr;
+   if (entityOut) *entityOut = s_records[p.owner[index]].entity;
+   return blob_at(p, index);
+}
+
+void sidecar_reset()
+{
+   if (s_poolCount) clear_all();
+}
+
+void sidecar_report()
+{
+   if (!g_log) g_log = get_gamelog();
+   if (!g_log) return;
+
+   g_log("[Sidecar] %d entities with components, %u stale dropped; Entity::~Entity %s, EntityCarrier::~EntityCarrier %s\n",
+         s_liveRecords, s_staleDrops, s_entityDtorHooked ? "hooked" : "not mapped",
+         s_carrierDtorHooked ? "hooked" : "not hooked");
+   for (int t = 0; t < s_poolCount; t++) {
+      const SidecarPool& p = s_pools[t];
+      g_log("[Sidecar]   %-20s %4d / %-4d  peak %d, %u B each, %u refused\n",
+            p.name, p.count, p.capacity, p.peak, p.stride, p.full);
+   }
+}
+
+// =============================================================================
+// Entity destruction hooks
+// =============================================================================
+
+typedef void(__fastcall* fn_EntityDtor_t)(void* ecx, void* edx);
+static fn_EntityDtor_t s_origEntityDtor  = nullptr;
+static fn_EntityDtor_t s_origCarrierDtor = nullptr;
+
+static void __fastcall hooked_EntityDtor(void* ecx, void* edx)
+{
+   sidecar_detach_all(ecx);
+   s_origEntityDtor(ecx, edx);
+}
+
+static void __fastcall hooked_CarrierDtor(void* ecx, void* edx)
+{
+   sidecar_detach_all(ecx);
+   sidecar_detach_all((char*)ecx - kCarrier_SubObject);
+   s_origCarrierDtor(ecx, edx);
+}
+
+void sidecar_install(uintptr_t exe_base)
+{
+   using namespace game_addrs::modtools;
+
+   g_log = get_gamelog();
+
+   s_origCarrierDtor = (fn_EntityDtor_t)resolve(exe_base, carrier_dtor);
+   if (entity_dtor) s_origEntityDtor = (fn_EntityDtor_t)resolve(exe_base, entity_dtor);
+
+   DetourTransactionBegin();
+   DetourUpdateThread(GetCurrentThread());
+   LONG rCarrier = DetourAttach(&(PVOID&)s_origCarrierDtor, hooked_CarrierDtor);
+   LONG rEntity  = s_origEntityDtor ? DetourAttach(&(PVOID&)s_origEntityDtor, hooked_EntityDtor) : NO_ERROR;
+   LONG rc = DetourTransactionCommit();
+
+   s_carrierDtorHooked = (rCarrier == NO_ERROR && rc == NO_ERROR);
+   s_entityDtorHooked  = (s_origEntityDtor && rEntity == NO_ERROR && rc == NO_ERROR);
+   if (!s_carrierDtorHooked) s_origCarrierDtor = nullptr;
+   if (!s_entityDtorHooked)  s_origEntityDtor = nullptr;
+
+   if (g_log) {
+      g_log("[Sidecar] Installed: EntityCarrier::~EntityCarrier %s, Entity::~Entity %s (commit=%ld)\n",
+            s_carrierDtorHooked ? "hooked" : "failed",
+            s_entityDtorHooked ? "hooked" : (entity_dtor ? "failed" : "not mapped, other types rely on the handle id check"),
+            rc);
+   }
+}
+
+void sidecar_uninstall()
+{
+   if (s_origEntityDtor || s_origCarrierDtor) {
+      DetourTransactionBegin();
+      DetourUpdateThread(GetCurrentThread());
+      if (s_origEntityDtor)  DetourDetach(&(PVOID&)s_origEntityDtor,  hooked_EntityDtor);
+      if (s_origCarrierDtor) DetourDetach(&(PVOID&)s_origCarrierDtor, hooked_CarrierDtor);
+      DetourTransactionCommit();
+      s_origEntityDtor  = nullptr;
+      s_origCarrierDtor = nullptr;
+   }
+   s_entityDtorHooked  = false;
+   s_carrierDtorHooked = false;
+
+   sidecar_reset();
+   for (int t = 0; t < s_poolCount; t++) {
+      delete[] s_pools[t].blobs;
+      delete[] s_pools[t].owner;
+   }
+   s_poolCount = 0;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <stdint.h>
+
+// =============================================================================
+// Entity sidecar store — typed extension state attached to engine entities
+//
+// Features that keep per-entity state used to roll their own fixed tables
+// (carrier flight/anim overrides, flyer boost instances, the grapple) and
+// scan them by pointer.  The sidecar store is the shared version:
+//
+//   - A component type is registered once with a blob size and capacity.
+//     Its blobs live in one contiguous pool, densely packed, so iterating
+//     every entity that has it is a loop over [0, count).
+//   - Entities are keyed by PblHandle: a 4096-bucket hash on the Entity*,
+//     O(1), plus the entity's handle id (+0x204) at attach.  A lookup whose
+//     id no longer matches is an entity that was destroyed and its memory
+//     reused; the record is dropped and the lookup misses.  A full pool
+//     sweeps such records before refusing an attach.
+//   - EntityCarrier::~EntityCarrier is hooked and drops components before
+//     the carrier is freed.  Entity::~Entity is hooked the same way once its
+//     address is mapped (game_addrs.hpp TODO); until then other types rely
+//     on the handle id check.
+//   - Everything is dropped on level load.
+//
+// Detach moves the last blob of the pool into the freed slot.  Blob
+// pointers are therefore only valid until the next detach of that type —
+// look them up again rather than keeping them.  Game thread only.
+//
+// "SidecarStats" in the ~ console logs each type's use.
+// =============================================================================
+
+static constexpr int kSidecarMaxTypes    = 16;
+static constexpr int kSidecarMaxEntities = 2048;   // ObjectLimitIncrease table size
+
+// Called with the blob before it's dropped (detach, entity destroyed, level
+// load).  Blob memory is zeroed again after.
+typedef void (*SidecarRelease_t)(void* blob, void* entity);
+
+// Register a component type.  Returns its id, or -1 if the type table is
+// full.  Registering a name twice returns the first id.  entityKeyed =
+// false for keys that aren't Entities (no handle id at +0x204); their owner
+// must detach them before the key is freed.
+int   sidecar_register(const char* name, uint32_t size, int capacity, SidecarRelease_t release = nullptr,
+                       bool entityKeyed = true);
+
+// Component of this type on entity, or nullptr
+void* sidecar_get(int type, void* entity);
+
+// Existing component, or a new zeroed one.  nullptr if the pool is full.
+void* sidecar_attach(int type, void* entity, bool* created = nullptr);
+
+void  sidecar_detach(int type, void* entity);
+void  sidecar_detach_all(void* entity);
+
+// Dense iteration: for (i = 0; i < sidecar_count(t); i++) sidecar_at(t, i, &e)
+int   sidecar_count(int type);
+void* sidecar_at(int type, int index, void** entityOut = nullptr);
+
+void  sidecar_install(uintptr_t exe_base);
+void  sidecar_uninstall();
+void  sidecar_reset();
+
+// Log per-type counts, peaks, refused attaches and stale drops
+void  sidecar_report();
+
+// -----------------------------------------------------------------------------
+// Typed wrapper
+//
+//   static SidecarComponent<GrappleState> s_grapple;
+//   s_grapple.init("Grapple", 64, nullptr, false);   // at install
+//   GrappleState* g = s_grapple.attach(ordnance);
+// -----------------------------------------------------------------------------
+
+template <typename T>
+struct SidecarComponent {
+   int type = -1;
+
+   void init(const char* name, int capacity, SidecarRelease_t release = nullptr, bool entityKeyed = true)
+   {
+      type = sidecar_register(name, sizeof(T), capacity, release, entityKeyed);
+   }
+
+   T*   get(void* entity) const                          { return (T*)sidecar_get(type, entity); }
+   T*   attach(void* entity, bool* created = nullptr) const { return (T*)sidecar_attach(type, entity, created); }
+   void detach(void* entity) const                       { sidecar_detach(type, entity); }
+   int  count() const                                    { return sidecar_count(type); }
+   T*   at(int index, void** entityOut = nullptr) const  { return (T*)sidecar_at(type, index, entityOut); }
+};
@@ -1,8 +1,12 @@
 #include "pch.h"
 #include "flyer_boost_animation.hpp"
+#include "anim_lookup_cache.hpp"
 #include "core/resolve.hpp"
 #include "core/game_addrs.hpp"
+#include "render/frame_clock.hpp"
+#include "render/red_camera.hpp"
 
+#include <cmath>
 #include <cstring>
 #include <detours.h>
 
@@ -14,8 +18,19 @@
 // blends the boost animation on top using boostRatio.  This handles partial
 // animations (fewer joints than the skeleton) correctly — un-keyed joints
 // keep the base flying pose instead of snapping to bind pose.
+//
+// The blended pose stays in the flyer's RedPose while the vanilla animation
+// is gated off, so it is only re-evaluated when boostRatio or the takeoff
+// progress moved by more than kPoseEpsilon.  Flyers past LodDistance update
+// every FarUpdateInterval frames, and off-screen flyers skip the blend.
+// Each tracked instance owns a pooled ZephyrPoseStatic instead of building
+// one on the stack every render.
 // =============================================================================
 
+float g_flyerBoostLodDistance    = 150.0f;
+int   g_flyerBoostFarInterval    = 4;
+bool  g_flyerBoostCullOffscreen  = true;
+
 // ---------------------------------------------------------------------------
 // Offsets (from struct_base = renderThis - 0x94)
 // ---------------------------------------------------------------------------
@@ -24,6 +39,7 @@ static constexpr uintptr_t kSB_FlightState = 0x5A4;
 static constexpr uintptr_t kSB_Progress    = 0x5A8;
 static constexpr uintptr_t kSB_Flags       = 0x5F4;
 static constexpr uintptr_t kSB_ClassPtr    = 0x66C;
+static constexpr uintptr_t kSB_PosX        = 0x120;   // float[3] world position
 
 // Offsets from renderThis
 static constexpr uintptr_t kRT_AnimGate    = 0x5B8;   // int: if 0, skip animation
@@ -38,6 +54,13 @@ static constexpr uintptr_t kCls_AnimObj     = 0x878;
 static constexpr uintptr_t kCls_TakeoffAnim = 0x87C;
 
 static constexpr float kTransitionTime = 0.6f;
+
+// Ratio / progress change that forces a pose re-evaluation
+static constexpr float kPoseEpsilon = 0.002f;
+
+// Bounding radius used for the off-screen test — generous, flyers are large
+static constexpr float kCullRadius = 30.0f;
+
 static constexpr uintptr_t kRenderThisToBase = 0x94;
 
 // Global identity matrix used by Skeleton::Finalize
@@ -81,9 +104,6 @@ using fn_ConvertPose_t = void(__fastcall*)(void* ecx, void* edx, void* skeleton)
 // EntityFlyerClass::InitAnimations
 using fn_InitAnimations_t = int(__fastcall*)(void* ecx, void* edx, const char* bankName);
 
-// ZephyrAnimBank::Find
-using fn_AnimBankFind_t = void*(__fastcall*)(void* ecx, void* edx, const char* name);
-
 // ---------------------------------------------------------------------------
 // Resolved function pointers
 // ---------------------------------------------------------------------------
@@ -99,7 +119,6 @@ static fn_PoseStaticBlend_t fn_PoseStaticBlend = nullptr;
 static fn_SkeletonFinalize_t fn_SkeletonFinalize = nullptr;
 static fn_ConvertPose_t     fn_ConvertPose     = nullptr;
 static fn_InitAnimations_t  original_InitAnimations = nullptr;
-static fn_AnimBankFind_t    fn_AnimBankFind    = nullptr;
 
 // ---------------------------------------------------------------------------
 // Class sidecar
@@ -121,14 +140,35 @@ static int             g_clsCount = 0;
 
 static constexpr int kMaxInstances = 32;
 
+// ZephyrPoseStatic<32> is 0x388 bytes (from Render stack frame analysis)
+static constexpr int kPoseStaticSize = 0x388;
+
 struct BoostInstance {
-   void*  structBase;
-   float  boostRatio;
-   DWORD  lastTickMs;
+   __declspec(align(16)) char pose[kPoseStaticSize];  // pooled ZephyrPoseStatic<32>
+   void*    structBase;
+   float    boostRatio;
+   DWORD    lastTickMs;
+   bool     poseBuilt;      // pose[] constructed
+   bool     poseValid;      // RedPose holds our blend from poseRatio/poseProgress
+   float    poseRatio;
+   float    poseProgress;
+   int      farFrames;      // renders since the last far-LOD evaluation
 };
 
 static BoostInstance g_inst[kMaxInstances] = {};
 
+// ---------------------------------------------------------------------------
+// Blend counters — current frame, last completed frame, and a log window
+// ---------------------------------------------------------------------------
+
+static constexpr DWORD kStatsLogIntervalMs = 10000;
+
+static FlyerBoostStats g_statsCur   = {};
+static FlyerBoostStats g_statsLast  = {};
+static FlyerBoostStats g_statsWin   = {};
+static uint32_t        g_winFrames  = 0;
+static DWORD           g_winStartMs = 0;
+
 // ---------------------------------------------------------------------------
 // Per-render saved state
 // ---------------------------------------------------------------------------
@@ -155,14 +195,76 @@ static BoostInstance* findOrCreateInst(void* structBase)
    for (int i = 0; i < kMaxInstances; i++)
       if (g_inst[i].structBase == structBase) return &g_inst[i];
    for (int i = 0; i < kMaxInstances; i++) {
-      if (!g_inst[i].structBase) {
-         g_inst[i] = { structBase, 0.0f, GetTickCount() };
-         return &g_inst[i];
+      BoostInstance& inst = g_inst[i];
+      if (!inst.structBase) {
+         inst.structBase = structBase;
+         inst.boostRatio = 0.0f;
+         inst.lastTickMs = GetTickCount();
+         inst.poseValid  = false;
+         inst.farFrames  = 0;
+         return &inst;
       }
    }
    return nullptr;
 }
 
+static void releaseInst(BoostInstance* inst)
+{
+   if (inst->poseBuilt) {
+      __try { fn_PoseStaticDtor(inst->pose, nullptr); }
+      __except (EXCEPTION_EXECUTE_HANDLER) {}
+   }
+   inst->structBase = nullptr;
+   inst->boostRatio = 0.0f;
+   inst->poseBuilt  = false;
+   inst->poseValid  = false;
+}
+
+// Frame clock callback — close this frame's counters
+static void statsEndFrame()
+{
+   g_statsLast = g_statsCur;
+   g_statsWin.evaluated += g_statsCur.evaluated;
+   g_statsWin.reused    += g_statsCur.reused;
+   g_statsWin.throttled += g_statsCur.throttled;
+   g_statsWin.culled    += g_statsCur.culled;
+   g_statsCur = {};
+   g_winFrames++;
+
+   DWORD now = GetTickCount();
+   if (!g_winStartMs) g_winStartMs = now;
+   if (now - g_winStartMs >= kStatsLogIntervalMs) {
+      if (g_statsWin.evaluated + g_statsWin.reused + g_statsWin.throttled + g_statsWin.culled) {
+         float f = (float)g_winFrames;
+         get_gamelog()("[FlyerBoost] per frame over %u frames: %.2f evaluated, %.2f reused, "
+                       "%.2f far-throttled, %.2f off-screen\n",
+                       g_winFrames, g_statsWin.evaluated / f, g_statsWin.reused / f,
+                       g_statsWin.throttled / f, g_statsWin.culled / f);
+      }
+      g_statsWin   = {};
+      g_winFrames  = 0;
+      g_winStartMs = now;
+   }
+}
+
+enum BoostLod { kLodNear, kLodFar, kLodOffscreen };
+
+static BoostLod classifyLod(char* structBase)
+{
+   const float* m = red_camera_matrix();
+   if (!m) return kLodNear;
+
+   const float* pos = (const float*)(structBase + kSB_PosX);
+   if (g_flyerBoostCullOffscreen && !camera_cone_test(pos, kCullRadius)) return kLodOffscreen;
+
+   if (g_flyerBoostLodDistance > 0.0f) {
+      float rx = pos[0] - m[12], ry = pos[1] - m[13], rz = pos[2] - m[14];
+      float d2 = rx * rx + ry * ry + rz * rz;
+      if (d2 > g_flyerBoostLodDistance * g_flyerBoostLodDistance) return kLodFar;
+   }
+   return kLodNear;
+}
+
 // ---------------------------------------------------------------------------
 // Hook: EntityFlyerClass::InitAnimations
 // ---------------------------------------------------------------------------
@@ -174,7 +276,7 @@ static int __fastcall hooked_InitAnimations(void* ecx, void* edx, const char* ba
    void* bank = *(void**)((char*)ecx + kCls_AnimObj);
    if (!bank) return ret;
 
-   void* boostAnim = fn_AnimBankFind(bank, nullptr, "boost");
+   void* boostAnim = anim_cache_bank_find(bank, "boost");
    if (!boostAnim) return ret;
 
    BoostClassEntry* entry = findClass(ecx);
@@ -191,8 +293,63 @@ static int __fastcall hooked_InitAnimations(void* ecx, void* edx, const char* ba
 // Render integration — compute blended pose, disable vanilla animation
 // ---------------------------------------------------------------------------
 
-// ZephyrPoseStatic<32> is 0x388 bytes (from Render stack frame analysis)
-static constexpr int kPoseStaticSize = 0x388;
+// ---------------------------------------------------------------------------
+// evaluatePose — takeoff base pose + boost blend, written to the RedPose.
+// Returns false if the flyer has no takeoff animation to blend onto.
+// ---------------------------------------------------------------------------
+
+static bool evaluatePose(char* structBase, void* classPtr, BoostClassEntry* cls,
+                         BoostInstance* inst, float progress)
+{
+   char* renderThis = structBase + kRenderThisToBase;
+
+   void* poseDyn  = renderThis + kRT_PoseDyn;
+   void* skeleton = renderThis + kRT_Skeleton;
+   void* skelShared = *(void**)(renderThis + kRT_Skeleton);  // first field = m_pShared
+   void* redPose  = renderThis + kRT_RedPose;
+
+   void* takeoffAnim = *(void**)((char*)classPtr + kCls_TakeoffAnim);
+   if (!takeoffAnim) return false;  // need takeoff as base
+
+   // Get frame counts
+   uint16_t tkFrames = *(uint16_t*)((char*)takeoffAnim + 8);
+   uint16_t bsFrames = *(uint16_t*)((char*)cls->animBoost + 8);
+
+   // Step 1: Compute base pose (takeoff at full progress = flying pose)
+   fn_SetAnimation(poseDyn, nullptr, takeoffAnim, 30.0f);
+   float baseTime = (float)(tkFrames - 1) * progress;
+   fn_SetAnimTime(poseDyn, nullptr, baseTime);
+
+   // Pooled ZephyrPoseStatic<32>, constructed once per tracked instance
+   void* staticPose = inst->pose;
+   if (!inst->poseBuilt) {
+      fn_PoseStaticCtor(staticPose, nullptr);
+      inst->poseBuilt = true;
+   }
+   fn_SkeletonOpen(skeleton, nullptr, skelShared, staticPose);
+   fn_PoseStaticOpen(staticPose, nullptr, skeleton);
+   fn_PoseStaticSet(staticPose, nullptr, poseDyn, 1);
+
+   // Step 2: Blend boost animation on top (smoothstep for ease-in/out)
+   float t = inst->boostRatio;
+   float smooth = t * t * (3.0f - 2.0f * t);
+
+   fn_SetAnimation(poseDyn, nullptr, cls->animBoost, 30.0f);
+   float boostTime = (float)(bsFrames - 1) * smooth;
+   fn_SetAnimTime(poseDyn, nullptr, boostTime);
+   fn_PoseStaticBlend(staticPose, nullptr, poseDyn, smooth);
+
+   // Step 3: Finalize and write to RedPose
+   fn_SkeletonFinalize(skeleton, nullptr, g_identityMatrix);
+   fn_ConvertPose(redPose, nullptr, skeleton);
+
+   inst->poseValid    = true;
+   inst->poseRatio    = inst->boostRatio;
+   inst->poseProgress = progress;
+   inst->farFrames    = 0;
+   g_statsCur.evaluated++;
+   return true;
+}
 
 bool flyer_boost_anim_render_prepare(char* structBase)
 {
@@ -235,56 +392,40 @@ bool flyer_boost_anim_render_prepare(char* structBase)
       }
 
       if (state == 5) {
-         inst->structBase = nullptr;
-         inst->boostRatio = 0.0f;
+         releaseInst(inst);
          return false;
       }
 
-      if (inst->boostRatio < 0.001f) return false;
-
-      // --- Compute blended pose ---
-
-      void* poseDyn  = renderThis + kRT_PoseDyn;
-      void* skeleton = renderThis + kRT_Skeleton;
-      void* skelShared = *(void**)(renderThis + kRT_Skeleton);  // first field = m_pShared
-      void* redPose  = renderThis + kRT_RedPose;
-
-      void* takeoffAnim = *(void**)((char*)classPtr + kCls_TakeoffAnim);
-      if (!takeoffAnim) return false;  // need takeoff as base
-
-      // Get frame counts
-      uint16_t tkFrames = *(uint16_t*)((char*)takeoffAnim + 8);
-      uint16_t bsFrames = *(uint16_t*)((char*)cls->animBoost + 8);
-
-      // Step 1: Compute base pose (takeoff at full progress = flying pose)
-      fn_SetAnimation(poseDyn, nullptr, takeoffAnim, 30.0f);
-      float baseTime = (float)(tkFrames - 1) * *(float*)(structBase + kSB_Progress);
-      fn_SetAnimTime(poseDyn, nullptr, baseTime);
-
-      // Create ZephyrPoseStatic<32> on stack (aligned to 16 bytes)
-      __declspec(align(16)) char poseStaticBuf[kPoseStaticSize];
-      void* staticPose = poseStaticBuf;
+      if (inst->boostRatio < 0.001f) {
+         inst->poseValid = false;
+         return false;
+      }
 
-      fn_PoseStaticCtor(staticPose, nullptr);
-      fn_SkeletonOpen(skeleton, nullptr, skelShared, staticPose);
-      fn_PoseStaticOpen(staticPose, nullptr, skeleton);
-      fn_PoseStaticSet(staticPose, nullptr, poseDyn, 1);
+      // --- LOD / reuse ---
 
-      // Step 2: Blend boost animation on top (smoothstep for ease-in/out)
-      float t = inst->boostRatio;
-      float smooth = t * t * (3.0f - 2.0f * t);
+      BoostLod lod = classifyLod(structBase);
+      if (lod == kLodOffscreen) {
+         inst->poseValid = false;   // vanilla animation owns RedPose this frame
+         g_statsCur.culled++;
+         return false;
+      }
 
-      fn_SetAnimation(poseDyn, nullptr, cls->animBoost, 30.0f);
-      float boostTime = (float)(bsFrames - 1) * smooth;
-      fn_SetAnimTime(poseDyn, nullptr, boostTime);
-      fn_PoseStaticBlend(staticPose, nullptr, poseDyn, smooth);
+      float progress = *(float*)(structBase + kSB_Progress);
+      bool dirty = !inst->poseValid
+                || fabsf(inst->boostRatio - inst->poseRatio) > kPoseEpsilon
+                || fabsf(progress - inst->poseProgress) > kPoseEpsilon;
 
-      // Step 3: Finalize and write to RedPose
-      fn_SkeletonFinalize(skeleton, nullptr, g_identityMatrix);
-      fn_ConvertPose(redPose, nullptr, skeleton);
+      if (dirty && lod == kLodFar && inst->poseValid
+          && ++inst->farFrames < g_flyerBoostFarInterval) {
+         dirty = false;
+         g_statsCur.throttled++;
+      }
+      else if (!dirty) {
+         g_statsCur.reused++;
+      }
 
-      // Cleanup
-      fn_PoseStaticDtor(staticPose, nullptr);
+      if (dirty && !evaluatePose(structBase, classPtr, cls, inst, progress))
+         return false;
 
       // Step 4: Disable vanilla animation — it will use our pre-computed RedPose
       g_saved.animGateSlot = (int*)(renderThis + kRT_AnimGate);
@@ -298,6 +439,11 @@ bool flyer_boost_anim_render_prepare(char* structBase)
    }
 }
 
+void flyer_boost_anim_get_stats(FlyerBoostStats* lastFrame)
+{
+   *lastFrame = g_statsLast;
+}
+
 void flyer_boost_anim_render_restore(char* structBase)
 {
    if (!g_saved.active) return;
@@ -315,7 +461,6 @@ void flyer_boost_anim_install(uintptr_t exe_base)
 {
    using namespace game_addrs::modtools;
 
-   fn_AnimBankFind         = (fn_AnimBankFind_t)    resolve(exe_base, zephyr_anim_bank_find);
    original_InitAnimations = (fn_InitAnimations_t)  resolve(exe_base, flyer_init_animations);
 
    fn_SetAnimation     = (fn_SetAnimation_t)    resolve(exe_base, zephyr_pose_dyn_set_anim);
@@ -331,6 +476,8 @@ void flyer_boost_anim_install(uintptr_t exe_base)
    g_identityMatrix    = (void*)                resolve(exe_base, g_identity_matrix);
    g_pauseMode         = (uint8_t*)             resolve(exe_base, gameloop_pause_mode);
 
+   frame_clock_on_frame_end(statsEndFrame);
+
    DetourTransactionBegin();
    DetourUpdateThread(GetCurrentThread());
    DetourAttach(&(PVOID&)original_InitAnimations, hooked_InitAnimations);
@@ -350,5 +497,9 @@ void flyer_boost_anim_reset()
 {
    memset(g_cls, 0, sizeof(g_cls));
    g_clsCount = 0;
+   for (int i = 0; i < kMaxInstances; i++)
+      if (g_inst[i].structBase) releaseInst(&g_inst[i]);
    memset(g_inst, 0, sizeof(g_inst));
+   g_statsCur = {};
+   g_statsLast = {};
 }
@@ -10,11 +10,29 @@
 // reversing out when boost ends.  Same convention as "takeoff" and "fins".
 //
 // Frame 0 = normal flying pose.  Final frame = full boost pose.
+//
+// The blend is re-evaluated only when it changes; distant flyers update at a
+// reduced rate and off-screen flyers skip it ([FlyerBoost] in the INI).
 // =============================================================================
 
+extern float g_flyerBoostLodDistance;    // 0 = no distance LOD
+extern int   g_flyerBoostFarInterval;    // re-evaluate every Nth render past LodDistance
+extern bool  g_flyerBoostCullOffscreen;
+
+// Blend counters for one frame
+struct FlyerBoostStats {
+   uint32_t evaluated;   // pose rebuilt
+   uint32_t reused;      // pose unchanged, previous RedPose kept
+   uint32_t throttled;   // past LodDistance, waiting for the next update
+   uint32_t culled;      // off-screen, blend skipped
+};
+
 void flyer_boost_anim_install(uintptr_t exe_base);
 void flyer_boost_anim_uninstall();
 void flyer_boost_anim_reset();
 
 bool flyer_boost_anim_render_prepare(char* structBase);
 void flyer_boost_anim_render_restore(char* structBase);
+
+// Counters of the last completed frame
+void flyer_boost_anim_get_stats(FlyerBoostStats* lastFrame);
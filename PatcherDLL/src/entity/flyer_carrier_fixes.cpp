@@ -1,7 +1,9 @@
 #include "pch.h"
 #include "flyer_carrier_fixes.hpp"
 #include "flyer_boost_animation.hpp"
+#include "entity_sidecar.hpp"
 #include "core/resolve.hpp"
+#include "debug_commands/ext_perf.hpp"
 
 #include <cmath>
 #include <detours.h>
@@ -56,6 +58,7 @@ static constexpr uintptr_t kCargoSlot_ObjPtr    = 0x0C;   // slot+0xC = object p
 static constexpr uintptr_t kClass_offset        = 0x42C;  // EntityCarrierClass*
 
 static constexpr int kMaxTrackedCarriers = 8;
+static constexpr int kMaxCarrierOverrides = 32;   // flight / anim sidecar capacity
 
 // ---------------------------------------------------------------------------
 // Custom carrier flight system
@@ -143,7 +146,7 @@ static constexpr int kMaxTrackedCarriers = 8;
 // ─── CARRIER LIFECYCLE ───
 //
 //   1. VehicleSpawn spawns carrier + cargo → state 3 (LANDING)
-//      - UpdateSpawn assigns a CarrierFlightOverride slot
+//      - UpdateSpawn attaches a CarrierFlightOverride
 //      - Additional cargo spawned for multi-cargo carriers
 //
 //   2. Carrier descends (our PHASE 1) → lands → state 0 (LANDED)
@@ -187,22 +190,24 @@ static constexpr int kMaxTrackedCarriers = 8;
 //
 // ─── SLOT TRACKING ───
 //
-//   Three parallel arrays track per-carrier state:
+//   Per-carrier state, keyed by struct_base:
 //
-//   - g_flightOverride[8]: pad position, class params, descent/ascent
-//     state, forward direction, elapsed timers, despawn timer.
-//     Assigned in UpdateSpawn, freed on carrier death.
+//   - s_flight (sidecar component): pad position, class params,
+//     descent/ascent state, forward direction, elapsed timers, despawn
+//     timer.  Attached in UpdateSpawn, detached on carrier death.
 //
 //   - g_takeoffPos[8]: transform snapshot (X, Z, rotation rows) saved
 //     at TakeOff time. Restored each frame during state 1 to prevent
 //     visual jumping from the movement controller.
 //
-//   - g_animOverride[8]: animation progress override for the render hook.
+//   - s_anim (sidecar component): animation progress override for the
+//     render hook.  Attached on the first cargo drop.
 //
-//   All arrays are cleaned of stale entries (dead carriers) via
-//   vtable validation whenever a new carrier spawns. This handles
-//   carriers destroyed outside our Update hook (e.g., by CalculateDest)
-//   and prevents stale data from interfering on match restart.
+//   The sidecar store (entity_sidecar.hpp) drops both components in
+//   EntityCarrier::~EntityCarrier, which covers carriers destroyed outside
+//   our Update hook (e.g., by CalculateDest), and on level load.
+//   g_takeoffPos is cleaned of stale entries via vtable validation
+//   whenever a new carrier spawns.
 // ---------------------------------------------------------------------------
 
 // EntityFlyerClass offsets for flight parameters
@@ -221,9 +226,8 @@ static fn_CarrierKill_t g_CarrierKill = nullptr;
 static constexpr float kDefaultDespawnDelay = 15.0f;
 static constexpr float kMinDuration         = 2.0f;
 
+// Sidecar component on the carrier's struct_base
 struct CarrierFlightOverride {
-   void*  structBase;        // carrier identity (struct_base ptr), nullptr = unused
-
    // Pad info (from VehicleSpawn at spawn time)
    float  padX, padY, padZ;
 
@@ -256,7 +260,7 @@ struct CarrierFlightOverride {
    int    lastState;
    bool   cargoDropped;      // true after first landing cycle completes
 };
-static CarrierFlightOverride g_flightOverride[kMaxTrackedCarriers] = {};
+static SidecarComponent<CarrierFlightOverride> s_flight;
 
 // Cargo slot offsets from struct_base (inner base)
 static constexpr uintptr_t kInner_mCargoSlot0Obj = 0x1DDC; // first cargo slot object ptr
@@ -293,9 +297,9 @@ static void* g_VehicleTrackerPool = nullptr;
 // GameLoop::sPauseMode — true when game is ESC-paused
 static uint8_t* g_pauseMode = nullptr;
 
-// Per-carrier animation progress override (used by render hook)
+// Per-carrier animation progress override (used by render hook), a sidecar
+// component on the carrier's struct_base
 struct CarrierAnimOverride {
-   void* structBase;    // carrier struct_base (inner), nullptr = unused
    DWORD startTick;     // GetTickCount() at activation
    float duration;      // seconds to play from start → end
    float startProg;     // progress value at activation
@@ -304,7 +308,7 @@ struct CarrierAnimOverride {
    DWORD lastRenderMs;  // last render frame timestamp (for pause tracking)
    DWORD pausedAccum;   // accumulated paused time in ms
 };
-static CarrierAnimOverride g_animOverride[kMaxTrackedCarriers] = {};
+static SidecarComponent<CarrierAnimOverride> s_anim;
 
 // ---------------------------------------------------------------------------
 // EntityCarrierClass::SetProperty
@@ -348,12 +352,10 @@ static void __fastcall hooked_AttachCargo(void* ecx, void* /*edx*/,
    // Save cargo's team and set to 0 to disable spawning while carried.
    // ECX = struct_base in AttachCargo.
    __try {
-      for (int i = 0; i < kMaxTrackedCarriers; i++) {
-         if (g_flightOverride[i].structBase != ecx) continue;
-
+      if (CarrierFlightOverride* fo = s_flight.get(ecx)) {
          int* teamBits = (int*)((char*)cargo + 0x234);
          int team = (*teamBits >> 4) & 0xF;
-         g_flightOverride[i].savedCargoTeam[slotIdx] = team;
+         fo->savedCargoTeam[slotIdx] = team;
 
          if (team != 0) {
             // SetTeam(0) via vtable[36]
@@ -363,7 +365,6 @@ static void __fastcall hooked_AttachCargo(void* ecx, void* /*edx*/,
             // Clear team bits
             *teamBits = *teamBits & ~0xFF0; // clear bits 4-11
          }
-         break;
       }
    } __except(EXCEPTION_EXECUTE_HANDLER) {}
 }
@@ -396,9 +397,8 @@ static void __fastcall hooked_DetachCargo(void* ecx, void* /*edx*/, int slotIdx)
    // Restore cargo team that was saved at attach time.
    if (hadCargo && cargoObj) {
       __try {
-         for (int i = 0; i < kMaxTrackedCarriers; i++) {
-            if (g_flightOverride[i].structBase != ecx) continue;
-            int savedTeam = g_flightOverride[i].savedCargoTeam[slotIdx];
+         if (CarrierFlightOverride* fo = s_flight.get(ecx)) {
+            int savedTeam = fo->savedCargoTeam[slotIdx];
             if (savedTeam > 0) {
                typedef void (__thiscall* SetTeam_t)(void* entity, int team);
                void** vtbl = *(void***)cargoObj;
@@ -408,8 +408,7 @@ static void __fastcall hooked_DetachCargo(void* ecx, void* /*edx*/, int slotIdx)
                *teamBits = *teamBits ^ (((savedTeam << 8) ^ *teamBits) & 0xF00);
 
             }
-            g_flightOverride[i].savedCargoTeam[slotIdx] = -1;
-            break;
+            fo->savedCargoTeam[slotIdx] = -1;
          }
       } __except(EXCEPTION_EXECUTE_HANDLER) {}
    }
@@ -417,14 +416,6 @@ static void __fastcall hooked_DetachCargo(void* ecx, void* /*edx*/, int slotIdx)
    // Activate animation override on first cargo slot drop — progress starts at 1.0
    // (fully deployed) and will be driven down toward 0.0 by the Update hook.
    if (hadCargo && slotIdx == 0) {
-      int slot = -1;
-      for (int i = 0; i < kMaxTrackedCarriers; i++) {
-         if (g_animOverride[i].structBase == ecx || g_animOverride[i].structBase == nullptr) {
-            slot = i; break;
-         }
-      }
-      if (slot < 0) slot = 0;
-
       // Read animation duration from the takeoff anim's nFrames (class+0x87c -> +8)
       float dur = 3.0f; // fallback
       __try {
@@ -438,14 +429,16 @@ static void __fastcall hooked_DetachCargo(void* ecx, void* /*edx*/, int slotIdx)
          }
       } __except(EXCEPTION_EXECUTE_HANDLER) {}
 
-      g_animOverride[slot].structBase = ecx;
-      g_animOverride[slot].startTick = GetTickCount();
-      g_animOverride[slot].duration = dur;
-      g_animOverride[slot].startProg = 0.0f;    // start at first frame
-      g_animOverride[slot].endProg = 1.0f;      // end at last frame
-      g_animOverride[slot].active = true;
-      g_animOverride[slot].lastRenderMs = g_animOverride[slot].startTick;
-      g_animOverride[slot].pausedAccum = 0;
+      CarrierAnimOverride* ao = s_anim.attach(ecx);
+      if (ao) {
+         ao->startTick = GetTickCount();
+         ao->duration = dur;
+         ao->startProg = 0.0f;    // start at first frame
+         ao->endProg = 1.0f;      // end at last frame
+         ao->active = true;
+         ao->lastRenderMs = ao->startTick;
+         ao->pausedAccum = 0;
+      }
    }
 }
 
@@ -465,17 +458,90 @@ using fn_FlyerRender_t = void(__fastcall*)(void* ecx, void* edx,
                                            unsigned int param2, float param3, unsigned int param4);
 static fn_FlyerRender_t original_FlyerRender = nullptr;
 
-// Visibility JZ bypass — NOP/restore the 6-byte JZ at 0x004f6999
-// that skips the entire render when the bounding sphere fails frustum culling.
+// Visibility JZ bypass — the 6-byte JZ at 0x004f6999 skips the entire render
+// when the bounding sphere fails frustum culling.  It is redirected once, at
+// install, to visJz_cave, which takes the original branch unless the current
+// thread has set s_visBypassThread (hooked_FlyerRender does, around the
+// original call for tracked carriers).
 static unsigned char* s_visJzAddr = nullptr;
-
-// RayHit call NOP — disable the two downward RayHit calls in EntityFlyer::Update
-// (states 1 and 3) that read terrain surface normals and cause the carrier to
-// swirl/wobble over uneven terrain.  Each is a 5-byte CALL instruction.
-// Only applied when the carrier is above a height threshold so terrain alignment
-// still works near the ground for natural landing.
+static unsigned char  s_visJzSaved[6] = {};
+static uintptr_t      s_visJzTaken  = 0;      // original JZ target (cull → skip render)
+static uintptr_t      s_visJzResume = 0;      // 0x004f6999 + 6
+
+// RayHit call bypass — the two downward RayHit calls in EntityFlyer::Update
+// (states 1 and 3) read terrain surface normals and cause the carrier to
+// swirl/wobble over uneven terrain.  Each 5-byte CALL is redirected once, at
+// install, to a cave that returns 1.0 in ST0 instead when the current thread
+// has set s_rayHitBypassThread.  hooked_CarrierUpdate only sets it when the
+// carrier is above a height threshold so terrain alignment still works near
+// the ground for natural landing.
 static unsigned char* s_rayHitCall1 = nullptr;  // state 1: 0x004fe8cd
 static unsigned char* s_rayHitCall2 = nullptr;  // state 3: 0x004feae2
+static unsigned char  s_rayHitSaved1[5] = {};
+static unsigned char  s_rayHitSaved2[5] = {};
+static uintptr_t      s_rayHitTarget1 = 0;     // original CALL targets
+static uintptr_t      s_rayHitTarget2 = 0;
+
+// Thread id (TEB+0x24) the bypass is armed for; 0 = off.  A thread id
+// rather than a bool, so another thread running the same engine code is
+// never affected.
+static DWORD s_visBypassThread    = 0;
+static DWORD s_rayHitBypassThread = 0;
+
+// ZF set = culled.  Flags are preserved so the code after the JZ sees what
+// it would have.
+static __declspec(naked) void visJz_cave()
+{
+   __asm {
+      jnz  _resume                    // visible → fall through as before
+      pushfd
+      push eax
+      mov  eax, fs:[0x24]             // current thread id
+      cmp  eax, dword ptr [s_visBypassThread]
+      pop  eax
+      je   _bypass
+      popfd
+      jmp  dword ptr [s_visJzTaken]
+
+   _bypass:
+      popfd
+   _resume:
+      jmp  dword ptr [s_visJzResume]
+   }
+}
+
+// FLD1 in place of the call: the following FMUL (×1024) then produces a
+// large ground distance (1024), so no terrain normal influence.  RayHit
+// leaves its stack arguments to the caller, so a bare RET matches.
+static __declspec(naked) void rayHit1_cave()
+{
+   __asm {
+      push eax
+      mov  eax, fs:[0x24]
+      cmp  eax, dword ptr [s_rayHitBypassThread]
+      pop  eax
+      je   _skip
+      jmp  dword ptr [s_rayHitTarget1]
+   _skip:
+      fld1
+      ret
+   }
+}
+
+static __declspec(naked) void rayHit2_cave()
+{
+   __asm {
+      push eax
+      mov  eax, fs:[0x24]
+      cmp  eax, dword ptr [s_rayHitBypassThread]
+      pop  eax
+      je   _skip
+      jmp  dword ptr [s_rayHitTarget2]
+   _skip:
+      fld1
+      ret
+   }
+}
 
 static void visJzInit() {
    if (!s_visJzAddr) {
@@ -492,55 +558,77 @@ static void rayHitInit() {
    }
 }
 
-// Replace a 5-byte CALL with FLD1 (D9 E8) + 3×NOP.
-// FLD1 pushes 1.0 onto FPU stack so the subsequent FMUL (×1024)
-// produces a large ground distance (1024), preventing terrain normal influence.
-static void rayHitNop(unsigned char saved1[5], unsigned char saved2[5]) {
-   if (!s_rayHitCall1) return;
-   static const unsigned char patch[5] = { 0xD9, 0xE8, 0x90, 0x90, 0x90 };
+// Write a rel32 JMP/CALL at site, padding to len with NOPs.  Returns false
+// (site untouched) if the page can't be made writable.
+static bool writeBranch(unsigned char* site, size_t len, unsigned char opcode, const void* target,
+                        unsigned char* savedOut)
+{
    DWORD oldProt;
-   if (VirtualProtect(s_rayHitCall1, 5, PAGE_EXECUTE_READWRITE, &oldProt)) {
-      memcpy(saved1, s_rayHitCall1, 5);
-      memcpy(s_rayHitCall1, patch, 5);
-      VirtualProtect(s_rayHitCall1, 5, oldProt, &oldProt);
-   }
-   if (VirtualProtect(s_rayHitCall2, 5, PAGE_EXECUTE_READWRITE, &oldProt)) {
-      memcpy(saved2, s_rayHitCall2, 5);
-      memcpy(s_rayHitCall2, patch, 5);
-      VirtualProtect(s_rayHitCall2, 5, oldProt, &oldProt);
-   }
+   if (!VirtualProtect(site, len, PAGE_EXECUTE_READWRITE, &oldProt)) return false;
+   memcpy(savedOut, site, len);
+   site[0] = opcode;
+   uintptr_t rel = (uintptr_t)target - ((uintptr_t)site + 5);
+   memcpy(site + 1, &rel, 4);
+   memset(site + 5, 0x90, len - 5);
+   VirtualProtect(site, len, oldProt, &oldProt);
+   FlushInstructionCache(GetCurrentProcess(), site, len);
+   return true;
 }
 
-static void rayHitRestore(const unsigned char saved1[5], const unsigned char saved2[5]) {
-   if (!s_rayHitCall1) return;
+static void restoreBranch(unsigned char* site, size_t len, const unsigned char* saved)
+{
    DWORD oldProt;
-   if (VirtualProtect(s_rayHitCall1, 5, PAGE_EXECUTE_READWRITE, &oldProt)) {
-      memcpy(s_rayHitCall1, saved1, 5);
-      VirtualProtect(s_rayHitCall1, 5, oldProt, &oldProt);
+   if (!VirtualProtect(site, len, PAGE_EXECUTE_READWRITE, &oldProt)) return;
+   memcpy(site, saved, len);
+   VirtualProtect(site, len, oldProt, &oldProt);
+   FlushInstructionCache(GetCurrentProcess(), site, len);
+}
+
+// Only redirect sites that still hold the expected instruction — another
+// patch may already own them.
+static void visJzInstall()
+{
+   if (!s_visJzAddr || s_visJzResume) return;
+   if (s_visJzAddr[0] != 0x0F || s_visJzAddr[1] != 0x84) return;   // JZ rel32
+   int32_t rel;
+   memcpy(&rel, s_visJzAddr + 2, 4);
+   s_visJzResume = (uintptr_t)s_visJzAddr + 6;
+   s_visJzTaken  = s_visJzResume + rel;
+   if (!writeBranch(s_visJzAddr, 6, 0xE9, &visJz_cave, s_visJzSaved)) s_visJzResume = 0;
+}
+
+static void rayHitInstall()
+{
+   if (!s_rayHitCall1 || s_rayHitTarget1) return;
+   if (s_rayHitCall1[0] != 0xE8 || s_rayHitCall2[0] != 0xE8) return;  // CALL rel32
+   int32_t rel1, rel2;
+   memcpy(&rel1, s_rayHitCall1 + 1, 4);
+   memcpy(&rel2, s_rayHitCall2 + 1, 4);
+   s_rayHitTarget1 = (uintptr_t)s_rayHitCall1 + 5 + rel1;
+   s_rayHitTarget2 = (uintptr_t)s_rayHitCall2 + 5 + rel2;
+   if (!writeBranch(s_rayHitCall1, 5, 0xE8, &rayHit1_cave, s_rayHitSaved1)) {
+      s_rayHitTarget1 = 0;
+      return;
    }
-   if (VirtualProtect(s_rayHitCall2, 5, PAGE_EXECUTE_READWRITE, &oldProt)) {
-      memcpy(s_rayHitCall2, saved2, 5);
-      VirtualProtect(s_rayHitCall2, 5, oldProt, &oldProt);
+   if (!writeBranch(s_rayHitCall2, 5, 0xE8, &rayHit2_cave, s_rayHitSaved2)) {
+      restoreBranch(s_rayHitCall1, 5, s_rayHitSaved1);
+      s_rayHitTarget1 = 0;
    }
 }
 
-static void visJzNop(unsigned char savedOut[6]) {
-   if (!s_visJzAddr) return;
-   DWORD oldProt;
-   if (VirtualProtect(s_visJzAddr, 6, PAGE_EXECUTE_READWRITE, &oldProt)) {
-      memcpy(savedOut, s_visJzAddr, 6);
-      memset(s_visJzAddr, 0x90, 6);
-      VirtualProtect(s_visJzAddr, 6, oldProt, &oldProt);
-   }
+static void visJzUninstall()
+{
+   if (!s_visJzResume) return;
+   restoreBranch(s_visJzAddr, 6, s_visJzSaved);
+   s_visJzResume = 0;
 }
 
-static void visJzRestore(const unsigned char saved[6]) {
-   if (!s_visJzAddr) return;
-   DWORD oldProt;
-   if (VirtualProtect(s_visJzAddr, 6, PAGE_EXECUTE_READWRITE, &oldProt)) {
-      memcpy(s_visJzAddr, saved, 6);
-      VirtualProtect(s_visJzAddr, 6, oldProt, &oldProt);
-   }
+static void rayHitUninstall()
+{
+   if (!s_rayHitTarget1) return;
+   restoreBranch(s_rayHitCall1, 5, s_rayHitSaved1);
+   restoreBranch(s_rayHitCall2, 5, s_rayHitSaved2);
+   s_rayHitTarget1 = 0;
 }
 
 // EntityCarrier vtable (unrelocated 0x00A3A670), resolved at install time.
@@ -863,23 +951,16 @@ static bool __fastcall hooked_TurretUpdateIndirect(void* ecx, void* /*edx*/, flo
 
 // Render hook — installed via Detour on FUN_004f6970.
 // Intercepts ALL flyer renders but only applies animation override to carriers
-// (identified by matching g_animOverride structBase).
-static void __fastcall hooked_FlyerRender(void* ecx, void* /*edx*/,
-                                          unsigned int param2, float param3, unsigned int param4)
+// (identified by an active s_anim component on the structBase).
+static void flyer_render(void* ecx, unsigned int param2, float param3, unsigned int param4)
 {
    char* structBase = (char*)ecx - kRender_thisToBase;
 
    // Find active animation override for this carrier
-   int overrideSlot = -1;
-   for (int i = 0; i < kMaxTrackedCarriers; i++) {
-      if (g_animOverride[i].structBase == (void*)structBase && g_animOverride[i].active) {
-         overrideSlot = i;
-         break;
-      }
-   }
+   CarrierAnimOverride* anim = s_anim.get(structBase);
 
-   if (overrideSlot >= 0) {
-      CarrierAnimOverride& ov = g_animOverride[overrideSlot];
+   if (anim && anim->active) {
+      CarrierAnimOverride& ov = *anim;
       DWORD now = GetTickCount();
       if (g_pauseMode && *g_pauseMode)
          ov.pausedAccum += now - ov.lastRenderMs;
@@ -919,10 +1000,9 @@ static void __fastcall hooked_FlyerRender(void* ecx, void* /*edx*/,
       } __except(EXCEPTION_EXECUTE_HANDLER) {}
 
       // Bypass visibility/frustum cull + force LOD 0 (skinned mesh) for animation.
-      unsigned char jzSaved[6];
-      visJzNop(jzSaved);
-      original_FlyerRender(ecx, nullptr, 0, param3, param4);
-      visJzRestore(jzSaved);
+      s_visBypassThread = GetCurrentThreadId();
+      ext_perf_engine(kExtPerf_FlyerRender, [&] { original_FlyerRender(ecx, nullptr, 0, param3, param4); });
+      s_visBypassThread = 0;
 
       __try {
          *progSlot = savedProg;
@@ -938,14 +1018,7 @@ static void __fastcall hooked_FlyerRender(void* ecx, void* /*edx*/,
    // For tracked carriers (even without active anim override), bypass the
    // frustum/visibility cull.  The carrier's bounding sphere is often too small
    // or offset, causing flicker when viewed from behind or up close.
-   bool isTrackedCarrier = false;
-   for (int i = 0; i < kMaxTrackedCarriers; i++) {
-      if (g_flightOverride[i].structBase == (void*)structBase) {
-         isTrackedCarrier = true;
-         break;
-      }
-   }
-   if (isTrackedCarrier) {
+   if (s_flight.get(structBase)) {
       // During descent (state 3, before cargo drop), force progress=0 so the
       // carrier shows frame 0 (closed/folded).  Vanilla's progress goes 1→0
       // during landing, which plays the animation backwards — we don't want that.
@@ -961,10 +1034,9 @@ static void __fastcall hooked_FlyerRender(void* ecx, void* /*edx*/,
          }
       } __except(EXCEPTION_EXECUTE_HANDLER) {}
 
-      unsigned char jzSaved[6];
-      visJzNop(jzSaved);
-      original_FlyerRender(ecx, nullptr, param2, param3, param4);
-      visJzRestore(jzSaved);
+      s_visBypassThread = GetCurrentThreadId();
+      ext_perf_engine(kExtPerf_FlyerRender, [&] { original_FlyerRender(ecx, nullptr, param2, param3, param4); });
+      s_visBypassThread = 0;
 
       if (didOverrideProg) {
          __try { *progSlot = savedProg; } __except(EXCEPTION_EXECUTE_HANDLER) {}
@@ -974,10 +1046,16 @@ static void __fastcall hooked_FlyerRender(void* ecx, void* /*edx*/,
 
    // Boost animation: swap class anim + progress if boosting
    bool boostApplied = flyer_boost_anim_render_prepare(structBase);
-   original_FlyerRender(ecx, nullptr, param2, param3, param4);
+   ext_perf_engine(kExtPerf_FlyerRender, [&] { original_FlyerRender(ecx, nullptr, param2, param3, param4); });
    if (boostApplied) flyer_boost_anim_render_restore(structBase);
 }
 
+static void __fastcall hooked_FlyerRender(void* ecx, void* /*edx*/,
+                                          unsigned int param2, float param3, unsigned int param4)
+{
+   ext_perf_call(kExtPerf_FlyerRender, [&] { flyer_render(ecx, param2, param3, param4); });
+}
+
 // ---------------------------------------------------------------------------
 // EntityFlyer::TakeOff — block landing interruption
 //   __thiscall(EntityFlyer* this_inner)    (this_inner = struct_base)
@@ -1125,20 +1203,18 @@ static void __fastcall hooked_TakeOff(void* ecx, void* /*edx*/)
             g_takeoffPos[slot].active = true;
 
             // Post-drop: also capture forward direction for forward movement during ascent
-            for (int j = 0; j < kMaxTrackedCarriers; j++) {
-               if (g_flightOverride[j].structBase == ecx && g_flightOverride[j].cargoDropped) {
-                  // Forward direction = rotation row 1 (struct_base+0x110)
-                  float fwdX = *(float*)(p + 0x110);
-                  float fwdZ = *(float*)(p + 0x118);
-                  // Normalize XZ
-                  float len = sqrtf(fwdX * fwdX + fwdZ * fwdZ);
-                  if (len > 0.001f) { fwdX /= len; fwdZ /= len; }
-                  g_flightOverride[j].fwdDirX = fwdX;
-                  g_flightOverride[j].fwdDirZ = fwdZ;
-                  g_flightOverride[j].ascentElapsed = 0.0f;
-                  g_flightOverride[j].ascentActive = true;
-                  break;
-               }
+            CarrierFlightOverride* fo = s_flight.get(ecx);
+            if (fo && fo->cargoDropped) {
+               // Forward direction = rotation row 1 (struct_base+0x110)
+               float fwdX = *(float*)(p + 0x110);
+               float fwdZ = *(float*)(p + 0x118);
+               // Normalize XZ
+               float len = sqrtf(fwdX * fwdX + fwdZ * fwdZ);
+               if (len > 0.001f) { fwdX /= len; fwdZ /= len; }
+               fo->fwdDirX = fwdX;
+               fo->fwdDirZ = fwdZ;
+               fo->ascentElapsed = 0.0f;
+               fo->ascentActive = true;
             }
          }
 
@@ -1160,7 +1236,7 @@ static void __fastcall hooked_TakeOff(void* ecx, void* /*edx*/)
 using fn_CarrierUpdate_t = bool(__fastcall*)(void* ecx, void* edx, float dt);
 static fn_CarrierUpdate_t original_CarrierUpdate = nullptr;
 
-static bool __fastcall hooked_CarrierUpdate(void* ecx, void* /*edx*/, float dt)
+static bool carrier_update(void* ecx, float dt)
 {
    char* inner = (char*)ecx - 0x240;
 
@@ -1181,26 +1257,21 @@ static bool __fastcall hooked_CarrierUpdate(void* ecx, void* /*edx*/, float dt)
             memcpy(inner + 0x100, g_takeoffPos[i].rotRow0, 16);
             memcpy(inner + 0x110, g_takeoffPos[i].rotRow1, 16);
             // Check for post-drop forward displacement
-            bool isPostDrop = false;
-            for (int j = 0; j < kMaxTrackedCarriers; j++) {
-               if (g_flightOverride[j].structBase == carrierInner && g_flightOverride[j].ascentActive) {
-                  // Ramp from 0 to forwardSpeed over ~3s, then hold at full speed
-                  float spd = g_flightOverride[j].forwardSpeed;
-                  float ramp = 3.0f; // seconds to reach full speed
-                  float t   = g_flightOverride[j].ascentElapsed;
-                  float dist;
-                  if (t <= ramp) {
-                     dist = spd * t * t / (2.0f * ramp); // accelerating
-                  } else {
-                     dist = spd * ramp / 2.0f + spd * (t - ramp); // constant
-                  }
-                  *(float*)(inner + kInner_mPosX) = g_takeoffPos[i].savedX + g_flightOverride[j].fwdDirX * dist;
-                  *(float*)(inner + kInner_mPosZ) = g_takeoffPos[i].savedZ + g_flightOverride[j].fwdDirZ * dist;
-                  isPostDrop = true;
-                  break;
+            CarrierFlightOverride* fo = s_flight.get(carrierInner);
+            if (fo && fo->ascentActive) {
+               // Ramp from 0 to forwardSpeed over ~3s, then hold at full speed
+               float spd = fo->forwardSpeed;
+               float ramp = 3.0f; // seconds to reach full speed
+               float t   = fo->ascentElapsed;
+               float dist;
+               if (t <= ramp) {
+                  dist = spd * t * t / (2.0f * ramp); // accelerating
+               } else {
+                  dist = spd * ramp / 2.0f + spd * (t - ramp); // constant
                }
-            }
-            if (!isPostDrop) {
+               *(float*)(inner + kInner_mPosX) = g_takeoffPos[i].savedX + fo->fwdDirX * dist;
+               *(float*)(inner + kInner_mPosZ) = g_takeoffPos[i].savedZ + fo->fwdDirZ * dist;
+            } else {
                // First takeoff: only lock X, let Z be free for vanilla path
                *(float*)(inner + kInner_mPosX) = g_takeoffPos[i].savedX;
             }
@@ -1209,45 +1280,36 @@ static bool __fastcall hooked_CarrierUpdate(void* ecx, void* /*edx*/, float dt)
       }
    } __except(EXCEPTION_EXECUTE_HANDLER) {}
 
-   // NOP the downward RayHit calls when the carrier is high above its pad.
+   // Bypass the downward RayHit calls when the carrier is high above its pad.
    // This prevents terrain surface normals from causing heading/pitch wobble
    // at altitude.  Near the ground (within 2× landedHt), leave RayHit active
    // so the carrier aligns naturally to terrain for landing.
-   bool didNopRayHit = false;
-   unsigned char rhSaved1[5] = {}, rhSaved2[5] = {};
+   bool didBypassRayHit = false;
    __try {
-      for (int i = 0; i < kMaxTrackedCarriers; i++) {
-         if (g_flightOverride[i].structBase != (void*)inner) continue;
+      if (CarrierFlightOverride* fo = s_flight.get(inner)) {
          float posY = *(float*)(inner + kInner_mPosY);
-         float padY = g_flightOverride[i].padY;
-         float landedHt = g_flightOverride[i].landedHt;
+         float padY = fo->padY;
+         float landedHt = fo->landedHt;
          float heightAbovePad = posY - padY;
-         // NOP raycasts when more than 2× landedHt above pad (or at least 10 units)
+         // Skip raycasts when more than 2× landedHt above pad (or at least 10 units)
          float threshold = (landedHt * 2.0f > 10.0f) ? landedHt * 2.0f : 10.0f;
          if (heightAbovePad > threshold) {
-            rayHitNop(rhSaved1, rhSaved2);
-            didNopRayHit = true;
+            s_rayHitBypassThread = GetCurrentThreadId();
+            didBypassRayHit = true;
          }
-         break;
       }
    } __except(EXCEPTION_EXECUTE_HANDLER) {}
 
-   bool alive = original_CarrierUpdate(ecx, nullptr, dt);
+   bool alive = ext_perf_engine(kExtPerf_CarrierUpdate, [&] { return original_CarrierUpdate(ecx, nullptr, dt); });
 
-   if (didNopRayHit) {
-      rayHitRestore(rhSaved1, rhSaved2);
+   if (didBypassRayHit) {
+      s_rayHitBypassThread = 0;
    }
 
    if (!alive) {
-      // Clean up animation override for destroyed carriers
-      for (int i = 0; i < kMaxTrackedCarriers; i++) {
-         if (g_animOverride[i].structBase == (void*)inner) {
-            g_animOverride[i] = {};
-         }
-         if (g_flightOverride[i].structBase == (void*)inner) {
-            g_flightOverride[i] = {};
-         }
-      }
+      // Clean up overrides for destroyed carriers
+      s_anim.detach(inner);
+      s_flight.detach(inner);
       return false;
    }
 
@@ -1263,25 +1325,20 @@ static bool __fastcall hooked_CarrierUpdate(void* ecx, void* /*edx*/, float dt)
          } else {
             memcpy(inner + 0x100, g_takeoffPos[i].rotRow0, 16);
             memcpy(inner + 0x110, g_takeoffPos[i].rotRow1, 16);
-            bool isPostDrop = false;
-            for (int j = 0; j < kMaxTrackedCarriers; j++) {
-               if (g_flightOverride[j].structBase == carrierInner && g_flightOverride[j].ascentActive) {
-                  float spd = g_flightOverride[j].forwardSpeed;
-                  float ramp = 3.0f;
-                  float t   = g_flightOverride[j].ascentElapsed;
-                  float dist;
-                  if (t <= ramp) {
-                     dist = spd * t * t / (2.0f * ramp);
-                  } else {
-                     dist = spd * ramp / 2.0f + spd * (t - ramp);
-                  }
-                  *(float*)(inner + kInner_mPosX) = g_takeoffPos[i].savedX + g_flightOverride[j].fwdDirX * dist;
-                  *(float*)(inner + kInner_mPosZ) = g_takeoffPos[i].savedZ + g_flightOverride[j].fwdDirZ * dist;
-                  isPostDrop = true;
-                  break;
+            CarrierFlightOverride* fo = s_flight.get(carrierInner);
+            if (fo && fo->ascentActive) {
+               float spd = fo->forwardSpeed;
+               float ramp = 3.0f;
+               float t   = fo->ascentElapsed;
+               float dist;
+               if (t <= ramp) {
+                  dist = spd * t * t / (2.0f * ramp);
+               } else {
+                  dist = spd * ramp / 2.0f + spd * (t - ramp);
                }
-            }
-            if (!isPostDrop) {
+               *(float*)(inner + kInner_mPosX) = g_takeoffPos[i].savedX + fo->fwdDirX * dist;
+               *(float*)(inner + kInner_mPosZ) = g_takeoffPos[i].savedZ + fo->fwdDirZ * dist;
+            } else {
                *(float*)(inner + kInner_mPosX) = g_takeoffPos[i].savedX;
             }
          }
@@ -1293,12 +1350,9 @@ static bool __fastcall hooked_CarrierUpdate(void* ecx, void* /*edx*/, float dt)
    __try {
       int state = *(int*)((char*)ecx + kState_offset);
 
-      // Diagnostic: detect carriers with no flight override slot
-      bool foundSlot = false;
-      for (int i = 0; i < kMaxTrackedCarriers; i++) {
-         if (g_flightOverride[i].structBase == (void*)inner) { foundSlot = true; break; }
-      }
-      if (!foundSlot && state == 3) {
+      // Diagnostic: detect carriers with no flight override
+      CarrierFlightOverride* flight = s_flight.get(inner);
+      if (!flight && state == 3) {
          // Check if this is actually a carrier (vtable match)
          void* vtable = *(void**)inner;
          if (vtable == g_carrierVtable) {
@@ -1306,19 +1360,15 @@ static bool __fastcall hooked_CarrierUpdate(void* ecx, void* /*edx*/, float dt)
             if (missLogCount++ < 5) {
                auto fn = get_gamelog();
                if (fn) {
-                  fn("[Carrier:%p] WARNING: no flight override slot! state=%d slots=[%p,%p,%p,%p]\n",
-                     inner, state,
-                     g_flightOverride[0].structBase, g_flightOverride[1].structBase,
-                     g_flightOverride[2].structBase, g_flightOverride[3].structBase);
+                  fn("[Carrier:%p] WARNING: no flight override! state=%d tracked=%d\n",
+                     inner, state, s_flight.count());
                }
             }
          }
       }
 
-      for (int i = 0; i < kMaxTrackedCarriers; i++) {
-         if (g_flightOverride[i].structBase != (void*)inner) continue;
-
-         CarrierFlightOverride& fo = g_flightOverride[i];
+      if (flight) {
+         CarrierFlightOverride& fo = *flight;
          int prevState = fo.lastState;
          fo.lastState = state;
 
@@ -1400,12 +1450,11 @@ static bool __fastcall hooked_CarrierUpdate(void* ecx, void* /*edx*/, float dt)
             if (fo.despawnTimer <= 0.0f && g_CarrierKill) {
                fo.despawnActive = false;
                g_CarrierKill((void*)inner, nullptr);
-               fo = {};
-               break; // carrier is dead, stop processing
+               // fo may already be gone: the dtor hook detaches, and that
+               // moves another carrier's blob into its slot
+               s_flight.detach(inner);
             }
          }
-
-         break;
       }
    } __except(EXCEPTION_EXECUTE_HANDLER) {}
 
@@ -1438,6 +1487,11 @@ static bool __fastcall hooked_CarrierUpdate(void* ecx, void* /*edx*/, float dt)
    return alive;
 }
 
+static bool __fastcall hooked_CarrierUpdate(void* ecx, void* /*edx*/, float dt)
+{
+   return ext_perf_call(kExtPerf_CarrierUpdate, [&] { return carrier_update(ecx, dt); });
+}
+
 // ---------------------------------------------------------------------------
 // EntityCarrier::UpdateLandedHeight — passthrough hook (kept for future use)
 //   __thiscall(EntityCarrier* this_inner)    (this_inner = struct_base, NOT +0x240)
@@ -1571,21 +1625,8 @@ static void __fastcall hooked_UpdateSpawn(void* ecx, void* /*edx*/, float dt)
          float* padMtx = (float*)(vs + kVS_PadTransform);
          float pX = padMtx[12], pY = padMtx[13], pZ = padMtx[14];
 
-         // Evict stale slots: if the carrier at a slot's structBase is dead
+         // Evict stale snapshot entries: if the carrier at a slot's ecx is dead
          // (vtable no longer matches), free the slot for reuse.
-         for (int i = 0; i < kMaxTrackedCarriers; i++) {
-            if (g_flightOverride[i].structBase == nullptr) continue;
-            __try {
-               void* vtbl = *(void**)g_flightOverride[i].structBase;
-               if (vtbl != g_carrierVtable) {
-                  g_flightOverride[i] = {};
-               }
-            } __except(EXCEPTION_EXECUTE_HANDLER) {
-               g_flightOverride[i] = {};
-            }
-         }
-
-         // Also evict stale snapshot entries (same logic: dead carrier = bad vtable)
          for (int i = 0; i < kMaxTrackedCarriers; i++) {
             if (g_takeoffPos[i].ecx == nullptr) continue;
             __try {
@@ -1598,78 +1639,61 @@ static void __fastcall hooked_UpdateSpawn(void* ecx, void* /*edx*/, float dt)
             }
          }
 
-         // Also evict stale animation override entries
-         for (int i = 0; i < kMaxTrackedCarriers; i++) {
-            if (g_animOverride[i].structBase == nullptr) continue;
-            __try {
-               void* vtbl = *(void**)g_animOverride[i].structBase;
-               if (vtbl != g_carrierVtable) {
-                  g_animOverride[i] = {};
-               }
-            } __except(EXCEPTION_EXECUTE_HANDLER) {
-               g_animOverride[i] = {};
-            }
-         }
-
-         int loSlot = -1;
-         for (int i = 0; i < kMaxTrackedCarriers; i++) {
-            if (g_flightOverride[i].structBase == (void*)carrierStructBase ||
-                g_flightOverride[i].structBase == nullptr) {
-               loSlot = i; break;
-            }
-         }
-         if (loSlot < 0) loSlot = 0; // overwrite oldest if full
-
-         // Zero-init the slot, then populate
-         g_flightOverride[loSlot] = {};
-         g_flightOverride[loSlot].structBase = (void*)carrierStructBase;
-         g_flightOverride[loSlot].padX = pX;
-         g_flightOverride[loSlot].padY = pY;
-         g_flightOverride[loSlot].padZ = pZ;
-         g_flightOverride[loSlot].lastState = -1;
-         g_flightOverride[loSlot].despawnTimer = -1.0f;
-         for (int c = 0; c < kMaxCargo; c++) g_flightOverride[loSlot].savedCargoTeam[c] = -1;
-
-         // Cache class params from EntityFlyerClass
-         void* classPtr = *(void**)(carrierStructBase + kInner_mClass);
-         if (classPtr) {
-            float takeoffHt  = *(float*)((char*)classPtr + kClassTakeoffHt_off);
-            float takeoffTm  = *(float*)((char*)classPtr + kClassTakeoffTime_off);
-            float takeoffSpd = *(float*)((char*)classPtr + kClassTakeoffSpeed_off);
-            float landingTm  = *(float*)((char*)classPtr + kClassLandingTime_off);
-            float landHt     = *(float*)((char*)classPtr + kClassLandedHt_off);
-
-            g_flightOverride[loSlot].flightAltitude  = takeoffHt;
-            g_flightOverride[loSlot].ascentDuration   = (takeoffTm > kMinDuration) ? takeoffTm : kMinDuration;
-            g_flightOverride[loSlot].descentDuration  = (landingTm > kMinDuration) ? landingTm : kMinDuration;
-            g_flightOverride[loSlot].forwardSpeed     = (takeoffSpd > 1.0f) ? takeoffSpd : 1.0f;
-            g_flightOverride[loSlot].landedHt         = landHt;
+         // Zero-init the component (a reused one too), then populate
+         CarrierFlightOverride* fo = s_flight.attach(carrierStructBase);
+         if (!fo) {
+            if (fn) fn("[Carrier:%p] Flight init: no free override (%d tracked)\n",
+                       carrierStructBase, s_flight.count());
          } else {
-            // Fallback defaults
-            g_flightOverride[loSlot].flightAltitude  = 100.0f;
-            g_flightOverride[loSlot].ascentDuration   = 10.0f;
-            g_flightOverride[loSlot].descentDuration  = 10.0f;
-            g_flightOverride[loSlot].forwardSpeed     = 20.0f;
-            g_flightOverride[loSlot].landedHt         = 5.0f;
-            if (fn) fn("[Carrier:%p] Flight init: no class ptr, using defaults\n", carrierStructBase);
-         }
+            *fo = {};
+            fo->padX = pX;
+            fo->padY = pY;
+            fo->padZ = pZ;
+            fo->lastState = -1;
+            fo->despawnTimer = -1.0f;
+            for (int c = 0; c < kMaxCargo; c++) fo->savedCargoTeam[c] = -1;
+
+            // Cache class params from EntityFlyerClass
+            void* classPtr = *(void**)(carrierStructBase + kInner_mClass);
+            if (classPtr) {
+               float takeoffHt  = *(float*)((char*)classPtr + kClassTakeoffHt_off);
+               float takeoffTm  = *(float*)((char*)classPtr + kClassTakeoffTime_off);
+               float takeoffSpd = *(float*)((char*)classPtr + kClassTakeoffSpeed_off);
+               float landingTm  = *(float*)((char*)classPtr + kClassLandingTime_off);
+               float landHt     = *(float*)((char*)classPtr + kClassLandedHt_off);
+
+               fo->flightAltitude  = takeoffHt;
+               fo->ascentDuration   = (takeoffTm > kMinDuration) ? takeoffTm : kMinDuration;
+               fo->descentDuration  = (landingTm > kMinDuration) ? landingTm : kMinDuration;
+               fo->forwardSpeed     = (takeoffSpd > 1.0f) ? takeoffSpd : 1.0f;
+               fo->landedHt         = landHt;
+            } else {
+               // Fallback defaults
+               fo->flightAltitude  = 100.0f;
+               fo->ascentDuration   = 10.0f;
+               fo->descentDuration  = 10.0f;
+               fo->forwardSpeed     = 20.0f;
+               fo->landedHt         = 5.0f;
+               if (fn) fn("[Carrier:%p] Flight init: no class ptr, using defaults\n", carrierStructBase);
+            }
 
-         // Slot 0 cargo was attached inside original_UpdateSpawn, before the
-         // flight override existed.  Save its team and set to 0 now.
-         {
-            void* cargo0 = *(void**)(carrierStructBase + kInner_mCargoSlot0Obj);
-            if (cargo0) {
-               __try {
-                  int* teamBits = (int*)((char*)cargo0 + 0x234);
-                  int team0 = (*teamBits >> 4) & 0xF;
-                  g_flightOverride[loSlot].savedCargoTeam[0] = team0;
-                  if (team0 != 0) {
-                     typedef void (__thiscall* SetTeam_t)(void* entity, int t);
-                     void** vtbl = *(void***)cargo0;
-                     ((SetTeam_t)vtbl[36])(cargo0, 0);
-                     *teamBits = *teamBits & ~0xFF0;
-                  }
-               } __except(EXCEPTION_EXECUTE_HANDLER) {}
+            // Slot 0 cargo was attached inside original_UpdateSpawn, before the
+            // flight override existed.  Save its team and set to 0 now.
+            {
+               void* cargo0 = *(void**)(carrierStructBase + kInner_mCargoSlot0Obj);
+               if (cargo0) {
+                  __try {
+                     int* teamBits = (int*)((char*)cargo0 + 0x234);
+                     int team0 = (*teamBits >> 4) & 0xF;
+                     fo->savedCargoTeam[0] = team0;
+                     if (team0 != 0) {
+                        typedef void (__thiscall* SetTeam_t)(void* entity, int t);
+                        void** vtbl = *(void***)cargo0;
+                        ((SetTeam_t)vtbl[36])(cargo0, 0);
+                        *teamBits = *teamBits & ~0xFF0;
+                     }
+                  } __except(EXCEPTION_EXECUTE_HANDLER) {}
+               }
             }
          }
       }
@@ -1729,12 +1753,10 @@ static void __fastcall hooked_UpdateSpawn(void* ecx, void* /*edx*/, float dt)
          *teamBits = *teamBits ^ (((team << 8) ^ *teamBits) & 0xF00);
 
          // 3b. Save cargo team and set to 0 (disable spawning while carried)
-         for (int fi = 0; fi < kMaxTrackedCarriers; fi++) {
-            if (g_flightOverride[fi].structBase != (void*)carrierStructBase) continue;
-            g_flightOverride[fi].savedCargoTeam[slot] = team;
+         if (CarrierFlightOverride* fo = s_flight.get(carrierStructBase)) {
+            fo->savedCargoTeam[slot] = team;
             ((SetTeam_t)cargoVtbl[36])(cargoEntity, 0);
             *teamBits = *teamBits & ~0xFF0;
-            break;
          }
 
          // 4. cargo->vtable[5]() — activation (in own __try so tracker still created)
@@ -1768,8 +1790,12 @@ void entity_carrier_fixes_install(uintptr_t exe_base)
    original_CarrierUpdate  = (fn_CarrierUpdate_t) resolve(exe_base, game_addrs::modtools::carrier_update);
    original_UpdateLandedHeight = (fn_UpdateLandedHeight_t)resolve(exe_base, game_addrs::modtools::carrier_update_landed_ht);
    original_FlyerRender    = (fn_FlyerRender_t)   resolve(exe_base, game_addrs::modtools::flyer_render);
+   s_flight.init("CarrierFlight", kMaxCarrierOverrides);
+   s_anim.init("CarrierAnim", kMaxCarrierOverrides);
    visJzInit();
+   visJzInstall();
    rayHitInit();
+   rayHitInstall();
    original_UpdateSpawn    = (fn_UpdateSpawn_t)   resolve(exe_base, game_addrs::modtools::carrier_update_spawn);
 
    g_MemPoolAlloc          = (fn_MemPoolAlloc_t)  resolve(exe_base, game_addrs::modtools::mem_pool_alloc);
@@ -1838,4 +1864,6 @@ void entity_carrier_fixes_uninstall()
 
    turretFireUninstall();
    createCtrlNullCheckUninstall();
+   visJzUninstall();
+   rayHitUninstall();
 }
@@ -1,6 +1,9 @@
 #include "pch.h"
 #include "soldier_fp_animation_override.hpp"
+#include "anim_lookup_cache.hpp"
 #include "core/resolve.hpp"
+#include "util/pbl_hash.hpp"
+#include "debug_commands/ext_perf.hpp"
 
 #include <cstring>
 #include <detours.h>
@@ -18,6 +21,14 @@
 //      array with the custom bank's animations for the duration of the call.
 //      Also detects sprint state and substitutes _sprint animations for _run.
 //
+// Swap cost:
+//   mAnim is a static array the engine indexes directly, so it can't be
+//   redirected with a pointer write.  When a bank loads, its overrides are
+//   compacted into (slot, anim) lists, one normal and one sprinting.  Per
+//   frame only the listed slots are saved, written and restored; slots the
+//   bank doesn't override are never touched, so the engine's defaults need
+//   no snapshot or comparison.  The lists only change when a bank loads.
+//
 // Animations not found in the custom bank fall through to the default
 // (humanfp / droidekafp).
 //
@@ -34,9 +45,7 @@
 // Game function types
 // ---------------------------------------------------------------------------
 
-using fn_hash_string_t    = uint32_t(__cdecl*)(const char*);
 using fn_AddBank_t        = uint32_t(__cdecl*)(const char*);     // returns bool (low bit)
-using fn_FindAnimation_t  = void*(__cdecl*)(const char*);        // returns ZephyrAnim*
 
 // EntitySoldierClass::SetProperty — __thiscall(this, uint hash, const char* value)
 using fn_SetProperty_t = void(__fastcall*)(void* ecx, void* edx,
@@ -71,9 +80,7 @@ static const char* kSprintSuffixes[kHumanWeaponClasses] = {
 // Resolved function pointers
 // ---------------------------------------------------------------------------
 
-static fn_hash_string_t   fn_hash_string   = nullptr;
 static fn_AddBank_t       fn_AddBank       = nullptr;
-static fn_FindAnimation_t fn_FindAnimation = nullptr;
 
 // ---------------------------------------------------------------------------
 // Trampolines
@@ -83,10 +90,10 @@ static fn_SetProperty_t   original_SetProperty   = nullptr;
 static fn_UpdateSoldier_t original_UpdateSoldier  = nullptr;
 
 // ---------------------------------------------------------------------------
-// Custom property hash (computed at install time)
+// Custom property hash
 // ---------------------------------------------------------------------------
 
-static uint32_t g_fpBankPropHash = 0;
+static constexpr uint32_t kFpBankPropHash = pbl_hash_ct("FirstPersonAnimationBank");
 
 // ---------------------------------------------------------------------------
 // Class -> Bank mapping
@@ -100,11 +107,19 @@ struct FPBankEntry {
    int   bankIndex;   // index into g_bankCaches
 };
 
+// mAnim slots to replace, built when the bank loads
+struct FPOverrideList {
+   int     count;
+   uint8_t slot[kAnimCount];
+   void*   anim[kAnimCount];
+};
+
 struct FPAnimCache {
-   char   bankName[64];
-   void*  anims[kAnimCount];                    // ZephyrAnim*, nullptr = use default
-   void*  sprintAnims[kHumanWeaponClasses];     // per-weapon-class sprint overrides
-   bool   loaded;
+   char           bankName[64];
+   void*          anims[kAnimCount];                  // ZephyrAnim*, nullptr = use default
+   void*          sprintAnims[kHumanWeaponClasses];   // per-weapon-class sprint overrides
+   FPOverrideList overrides[2];                       // [sprinting]
+   bool           loaded;
 };
 
 static FPBankEntry  g_classBanks[kMaxClassBanks] = {};
@@ -117,9 +132,14 @@ static int          g_bankCacheCount = 0;
 // Default (humanfp) sprint animations — loaded lazily
 // ---------------------------------------------------------------------------
 
-static void*  g_defaultSprintAnims[kHumanWeaponClasses] = {};
-static bool   g_defaultSprintLoaded = false;
-static bool   g_wasSprinting = false;
+static void*          g_defaultSprintAnims[kHumanWeaponClasses] = {};
+static FPOverrideList g_defaultSprintOverrides = {};
+static bool           g_defaultSprintLoaded = false;
+static bool           g_wasSprinting = false;
+
+// Last class -> cache lookup (one local player, so this nearly always hits)
+static void*         g_lastClass = nullptr;
+static FPAnimCache*  g_lastCache = nullptr;
 
 // ---------------------------------------------------------------------------
 // Resolved global pointers
@@ -170,10 +190,45 @@ static void loadSprintAnims(const char* bankName, void* out[kHumanWeaponClasses]
       memcpy(name, bankName, bankNameLen);
       memcpy(name + bankNameLen, kSprintSuffixes[wc], suffixLen + 1);
 
-      out[wc] = fn_FindAnimation(name);
+      out[wc] = anim_cache_find_animation(name);
+   }
+}
+
+// ---------------------------------------------------------------------------
+// Override lists — non-null slots of a 48-entry overlay, compacted
+// ---------------------------------------------------------------------------
+
+static void applySprint(void* out[kAnimCount], void* const sprintAnims[kHumanWeaponClasses])
+{
+   for (int wc = 0; wc < kHumanWeaponClasses; wc++) {
+      if (sprintAnims[wc])
+         out[wc * kStatesPerWeapon + kRunState] = sprintAnims[wc];
    }
 }
 
+static void buildOverrideList(FPOverrideList* out, void* const overlay[kAnimCount])
+{
+   out->count = 0;
+   for (int i = 0; i < kAnimCount; i++) {
+      if (!overlay[i]) continue;
+      out->slot[out->count] = (uint8_t)i;
+      out->anim[out->count] = overlay[i];
+      out->count++;
+   }
+}
+
+static void buildOverrideLists(void* const anims[kAnimCount],
+                               void* const sprintAnims[kHumanWeaponClasses],
+                               FPOverrideList* normal, FPOverrideList* sprinting)
+{
+   void* overlay[kAnimCount];
+   memcpy(overlay, anims, sizeof(overlay));
+   if (normal) buildOverrideList(normal, overlay);
+
+   applySprint(overlay, sprintAnims);
+   buildOverrideList(sprinting, overlay);
+}
+
 // ---------------------------------------------------------------------------
 // Hook: EntitySoldierClass::SetProperty
 // ---------------------------------------------------------------------------
@@ -181,12 +236,14 @@ static void loadSprintAnims(const char* bankName, void* out[kHumanWeaponClasses]
 static void __fastcall hooked_SetProperty(void* ecx, void* /*edx*/,
                                           unsigned int hash, const char* value)
 {
-   if (hash == g_fpBankPropHash && g_fpBankPropHash != 0) {
+   if (hash == kFpBankPropHash) {
       if (!value || value[0] == '\0') return;
 
       int bankIdx = findOrCreateBankCache(value);
       if (bankIdx < 0) return;
 
+      g_lastClass = nullptr;
+
       for (int i = 0; i < g_classBankCount; i++) {
          if (g_classBanks[i].classPtr == ecx) {
             g_classBanks[i].bankIndex = bankIdx;
@@ -239,7 +296,7 @@ static void loadBankCache(FPAnimCache* cache)
       memcpy(newName, cache->bankName, bankNameLen);
       memcpy(newName + bankNameLen, suffix, suffixLen + 1);
 
-      void* anim = fn_FindAnimation(newName);
+      void* anim = anim_cache_find_animation(newName);
       if (anim) {
          cache->anims[i] = anim;
       }
@@ -248,6 +305,7 @@ static void loadBankCache(FPAnimCache* cache)
    // Also load sprint animations for this bank
    loadSprintAnims(cache->bankName, cache->sprintAnims);
 
+   buildOverrideLists(cache->anims, cache->sprintAnims, &cache->overrides[0], &cache->overrides[1]);
    cache->loaded = true;
 
    int count = 0;
@@ -265,11 +323,10 @@ static void loadBankCache(FPAnimCache* cache)
 // Hook: FirstPersonRenderable::UpdateSoldier
 // ---------------------------------------------------------------------------
 
-static void __fastcall hooked_UpdateSoldier(void* ecx, void* /*edx*/,
-                                            void* model, void* ctrl, void* aimer)
+static void update_soldier(void* ecx, void* model, void* ctrl, void* aimer)
 {
    if (!ctrl) {
-      original_UpdateSoldier(ecx, nullptr, model, ctrl, aimer);
+      ext_perf_engine(kExtPerf_FPUpdateSoldier, [&] { original_UpdateSoldier(ecx, nullptr, model, ctrl, aimer); });
       return;
    }
 
@@ -284,12 +341,18 @@ static void __fastcall hooked_UpdateSoldier(void* ecx, void* /*edx*/,
       // Look up custom bank override
       if (g_classBankCount > 0) {
          void* entityClass = *(void**)((uintptr_t)ctrl + 0x218);
-         if (entityClass && entityClass != (void*)0xFFFFFFFF) {
+         if (entityClass && entityClass == g_lastClass) {
+            cache = g_lastCache;
+         }
+         else if (entityClass && entityClass != (void*)0xFFFFFFFF) {
+            g_lastClass = entityClass;
+            g_lastCache = nullptr;
             for (int i = 0; i < g_classBankCount; i++) {
                if (g_classBanks[i].classPtr == entityClass) {
                   int bankIdx = g_classBanks[i].bankIndex;
                   if (bankIdx >= 0 && bankIdx < g_bankCacheCount)
                      cache = &g_bankCaches[bankIdx];
+                  g_lastCache = cache;
                   break;
                }
             }
@@ -301,7 +364,7 @@ static void __fastcall hooked_UpdateSoldier(void* ecx, void* /*edx*/,
 
    // Fast path: no bank override and not sprinting
    if (!cache && !isSprinting) {
-      original_UpdateSoldier(ecx, nullptr, model, ctrl, aimer);
+      ext_perf_engine(kExtPerf_FPUpdateSoldier, [&] { original_UpdateSoldier(ecx, nullptr, model, ctrl, aimer); });
       return;
    }
 
@@ -312,29 +375,19 @@ static void __fastcall hooked_UpdateSoldier(void* ecx, void* /*edx*/,
 
    // Lazy-load default sprint anims on first sprint
    if (isSprinting && !cache && !g_defaultSprintLoaded) {
+      void* none[kAnimCount] = {};
       loadSprintAnims("humanfp", g_defaultSprintAnims);
+      buildOverrideLists(none, g_defaultSprintAnims, nullptr, &g_defaultSprintOverrides);
       g_defaultSprintLoaded = true;
    }
 
-   // Save global mAnim[], apply overrides, call original, restore
+   // Overwrite only the slots this bank / sprint state replaces
+   const FPOverrideList& list = cache ? cache->overrides[isSprinting ? 1 : 0]
+                                      : g_defaultSprintOverrides;
    void* saved[kAnimCount];
-   memcpy(saved, g_mAnim, sizeof(saved));
-
-   // Bank override: overlay custom anims (non-null only)
-   if (cache) {
-      for (int i = 0; i < kAnimCount; i++) {
-         if (cache->anims[i])
-            g_mAnim[i] = cache->anims[i];
-      }
-   }
-
-   // Sprint override: swap _run slots with _sprint animations
-   if (isSprinting) {
-      void** sprintAnims = cache ? cache->sprintAnims : g_defaultSprintAnims;
-      for (int wc = 0; wc < kHumanWeaponClasses; wc++) {
-         if (sprintAnims[wc])
-            g_mAnim[wc * kStatesPerWeapon + kRunState] = sprintAnims[wc];
-      }
+   for (int k = 0; k < list.count; k++) {
+      saved[k] = g_mAnim[list.slot[k]];
+      g_mAnim[list.slot[k]] = list.anim[k];
    }
 
    // The FP state machine only calls SetAnimation when the state changes.
@@ -346,10 +399,16 @@ static void __fastcall hooked_UpdateSoldier(void* ecx, void* /*edx*/,
       g_wasSprinting = isSprinting;
    }
 
-   original_UpdateSoldier(ecx, nullptr, model, ctrl, aimer);
+   ext_perf_engine(kExtPerf_FPUpdateSoldier, [&] { original_UpdateSoldier(ecx, nullptr, model, ctrl, aimer); });
 
-   // Restore original mAnim[]
-   memcpy(g_mAnim, saved, sizeof(saved));
+   // Restore original mAnim[] slots
+   for (int k = 0; k < list.count; k++) g_mAnim[list.slot[k]] = saved[k];
+}
+
+static void __fastcall hooked_UpdateSoldier(void* ecx, void* /*edx*/,
+                                            void* model, void* ctrl, void* aimer)
+{
+   ext_perf_call(kExtPerf_FPUpdateSoldier, [&] { update_soldier(ecx, model, ctrl, aimer); });
 }
 
 // ---------------------------------------------------------------------------
@@ -359,15 +418,11 @@ static void __fastcall hooked_UpdateSoldier(void* ecx, void* /*edx*/,
 void fp_anim_bank_install(uintptr_t exe_base)
 {
    using namespace game_addrs::modtools;
-   fn_hash_string   = (fn_hash_string_t)  resolve(exe_base, hash_string);
    fn_AddBank       = (fn_AddBank_t)      resolve(exe_base, anim_add_bank);
-   fn_FindAnimation = (fn_FindAnimation_t)resolve(exe_base, anim_find_animation);
 
    g_mAnim         = (void**)       resolve(exe_base, fp_anim_array);
    g_animNameTable = (const char**) resolve(exe_base, anim_name_table);
 
-   g_fpBankPropHash = fn_hash_string("FirstPersonAnimationBank");
-
    original_SetProperty   = (fn_SetProperty_t)  resolve(exe_base, fp_anim_set_property);
    original_UpdateSoldier = (fn_UpdateSoldier_t) resolve(exe_base, fp_update_soldier);
 
@@ -396,6 +451,9 @@ void fp_anim_bank_reset()
    memset(g_bankCaches, 0, sizeof(g_bankCaches));
    g_bankCacheCount = 0;
    memset(g_defaultSprintAnims, 0, sizeof(g_defaultSprintAnims));
+   g_defaultSprintOverrides = {};
    g_defaultSprintLoaded = false;
+   g_lastClass = nullptr;
+   g_lastCache = nullptr;
    g_wasSprinting = false;
 }
@@ -1,5 +1,6 @@
 #include "pch.h"
 #include "shared.hpp"
+#include "frame_pacer.hpp"
 
 // =============================================================================
 // Config file parsing — PblConfig helpers and LoadConfig hook
@@ -122,6 +123,28 @@ static void parse_bf1_entry(const uint32_t* data_buf)
             fn_log("[BF1Ext] ERROR: AnimatedTextures base name is null\n");
         }
     }
+    else if (hash == kHash_AnimatedAtlas && argc >= 3) {
+        const char* tex  = pbl_get_str(data_buf, 0);
+        const int   cols = pbl_get_int(data_buf, 1);
+        const int   rows = pbl_get_int(data_buf, 2);
+        int         cnt  = (argc >= 4) ? pbl_get_int(data_buf, 3) : 0;
+        const float fps  = (argc >= 5) ? pbl_get_float(data_buf, 4) : 10.0f;
+        if (tex && cols > 0 && rows > 0) {
+            if (cnt <= 0 || cnt > cols * rows) cnt = cols * rows;
+            g_loadScreenCfg.atlasHash  = hash_name(tex);
+            g_loadScreenCfg.atlasCols  = cols;
+            g_loadScreenCfg.atlasRows  = rows;
+            g_loadScreenCfg.atlasCount = cnt;
+            g_loadScreenCfg.atlasFPS   = fps;
+            g_loadScreenCfg.atlasX = (argc >= 6) ? pbl_get_float(data_buf, 5) : 0.0f;
+            g_loadScreenCfg.atlasY = (argc >= 7) ? pbl_get_float(data_buf, 6) : 0.0f;
+            g_loadScreenCfg.atlasW = (argc >= 8) ? pbl_get_float(data_buf, 7) : 0.0f;
+            g_loadScreenCfg.atlasH = (argc >= 9) ? pbl_get_float(data_buf, 8) : 0.0f;
+        } else {
+            auto fn_log = get_gamelog();
+            fn_log("[BF1Ext] ERROR: AnimatedAtlas needs texName, cols > 0, rows > 0\n");
+        }
+    }
     else if (hash == kHash_XTrackingSound && argc >= 1) {
         g_loadScreenCfg.xTrackSoundHash = hash_name(pbl_get_str(data_buf, 0));
     }
@@ -140,22 +163,22 @@ static void parse_bf1_entry(const uint32_t* data_buf)
     else if (hash == kHash_BarSoundInterval && argc >= 1) {
         g_loadScreenCfg.barSoundInterval = pbl_get_int(data_buf, 0);
     }
-    else if (kHash_LoadSoundLVL && hash == kHash_LoadSoundLVL && argc >= 1) {
+    else if (hash == kHash_LoadSoundLVL && argc >= 1) {
         const char* s = pbl_get_str(data_buf, 0);
         if (s) {
             strncpy_s(g_loadScreenCfg.loadSoundLvl, sizeof(g_loadScreenCfg.loadSoundLvl), s,
                       sizeof(g_loadScreenCfg.loadSoundLvl) - 1);
         }
     }
-    else if (kHash_ZoomSelectorTileSize && hash == kHash_ZoomSelectorTileSize && argc >= 1) {
+    else if (hash == kHash_ZoomSelectorTileSize && argc >= 1) {
         g_loadScreenCfg.zoomTileHalfW = pbl_get_float(data_buf, 0);
         g_loadScreenCfg.zoomTileHalfH = (argc >= 2) ? pbl_get_float(data_buf, 1)
                                               : g_loadScreenCfg.zoomTileHalfW;
     }
-    else if (kHash_RemoveToolTips && hash == kHash_RemoveToolTips) {
+    else if (hash == kHash_RemoveToolTips) {
         g_loadScreenCfg.removeToolTips = (argc >= 1) ? (pbl_get_int(data_buf, 0) != 0) : true;
     }
-    else if (kHash_RemoveLoadingBar && hash == kHash_RemoveLoadingBar) {
+    else if (hash == kHash_RemoveLoadingBar) {
         g_loadScreenCfg.removeLoadingBar = (argc >= 1) ? (pbl_get_int(data_buf, 0) != 0) : true;
     }
     // Known-but-unimplemented / BF2-native params — silently ignored.
@@ -195,7 +218,7 @@ void __fastcall hooked_load_config(void* ecx, void* edx, uint32_t* fh)
 
     g_loadScreenCfg.reset();
     g_animStartMs    = GetTickCount(); // restart animation from PlanetLevel 0 on each new match
-    g_lastRenderMs   = 0;              // reset so first injected render fires immediately
+    load_pacer_reset();                // reset so first injected render fires immediately
     g_lastSndUpdateMs = GetTickCount(); // reset audio-tick timer so first deltaTime is ~0
     g_endProcessed   = false;          // re-arm End() hook for new loading screen
     s_sndLvlLoaded   = false;          // re-arm sound LVL loading for new loading screen
@@ -242,15 +265,15 @@ void __fastcall hooked_load_config(void* ecx, void* edx, uint32_t* fh)
                 const uint32_t hash = data_buf[0];
 
                 // PC() sub-scope — enter and parse BF1 params + PlanetLevel
-                if (kHash_PC && hash == kHash_PC) {
+                if (hash == kHash_PC) {
                     pbl_parse_bf1_scope(scope_buf, temp_buf, data_buf);
                     continue;
                 }
 
                 // Other platform / known sub-scopes — drain to keep reader in sync
                 if (hash == kHash_LoadingTextColorPallete
-                    || (kHash_PS2  && hash == kHash_PS2)
-                    || (kHash_XBOX && hash == kHash_XBOX)) {
+                    || hash == kHash_PS2
+                    || hash == kHash_XBOX) {
                     pbl_skip_next_scope(scope_buf, temp_buf, data_buf);
                     continue;
                 }
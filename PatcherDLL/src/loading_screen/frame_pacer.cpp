@@ -0,0 +1,156 @@
+#include "pch.h"
+#include "frame_pacer.hpp"
+#include "core/resolve.hpp"
+
+#include <cmath>
+
+float g_loadFrameBudgetMs = 33.3f;
+int   g_loadPacingMode    = kLoadPacingSmooth;
+
+// Throughput mode: injected renders may take at most this share of load time.
+static constexpr double kMaxRenderShare = 0.10;
+
+// Moving-average weight for slice / render cost estimates.
+static constexpr double kEmaAlpha = 0.25;
+
+// Frame-interval histogram: 1 ms buckets, last bucket is overflow.
+static constexpr int kIntervalBuckets = 256;
+
+static LARGE_INTEGER s_freq = {};
+
+static LONGLONG s_loadStart      = 0;
+static LONGLONG s_lastFrame      = 0;   // 0 = no frame yet this load
+static LONGLONG s_lastUpdateExit = 0;
+
+static double s_sliceEmaTicks  = 0.0;   // load work between Update calls
+static double s_renderEmaTicks = 0.0;   // cost of one injected render
+
+static unsigned s_intervalHist[kIntervalBuckets];
+static unsigned s_frames        = 0;
+static unsigned s_injected      = 0;
+static double   s_intervalSumMs = 0.0;
+static double   s_intervalMaxMs = 0.0;
+static LONGLONG s_renderTicks   = 0;
+
+static inline double ticks_to_ms(double ticks)
+{
+    return ticks * 1000.0 / (double)s_freq.QuadPart;
+}
+
+static inline double budget_ticks()
+{
+    const double ms = g_loadFrameBudgetMs > 1.0f ? g_loadFrameBudgetMs : 1.0;
+    return ms * (double)s_freq.QuadPart / 1000.0;
+}
+
+void load_pacer_reset()
+{
+    if (!s_freq.QuadPart) QueryPerformanceFrequency(&s_freq);
+
+    s_loadStart      = load_pacer_now();
+    s_lastFrame      = 0;
+    s_lastUpdateExit = 0;
+    s_sliceEmaTicks  = 0.0;
+    s_renderEmaTicks = 0.0;
+
+    memset(s_intervalHist, 0, sizeof(s_intervalHist));
+    s_frames        = 0;
+    s_injected      = 0;
+    s_intervalSumMs = 0.0;
+    s_intervalMaxMs = 0.0;
+    s_renderTicks   = 0;
+}
+
+void load_pacer_update_begin()
+{
+    if (!s_freq.QuadPart) load_pacer_reset();
+
+    const LONGLONG now = load_pacer_now();
+    if (s_lastUpdateExit) {
+        const double slice = (double)(now - s_lastUpdateExit);
+        s_sliceEmaTicks = s_sliceEmaTicks > 0.0
+            ? s_sliceEmaTicks + kEmaAlpha * (slice - s_sliceEmaTicks)
+            : slice;
+    }
+}
+
+void load_pacer_update_end()
+{
+    s_lastUpdateExit = load_pacer_now();
+}
+
+bool load_pacer_should_render()
+{
+    if (!s_lastFrame) return true;
+
+    const double elapsed = (double)(load_pacer_now() - s_lastFrame);
+    const double budget  = budget_ticks();
+
+    if (g_loadPacingMode == kLoadPacingThroughput) {
+        const double minInterval = s_renderEmaTicks / kMaxRenderShare;
+        return elapsed >= (budget > minInterval ? budget : minInterval);
+    }
+
+    // Smooth: the next chance to render is roughly one slice away — take the
+    // frame now if waiting for it would land past the budget.
+    return elapsed + s_sliceEmaTicks + s_renderEmaTicks >= budget;
+}
+
+bool load_pacer_interval_elapsed()
+{
+    if (!s_freq.QuadPart) load_pacer_reset();
+    return !s_lastFrame || (double)(load_pacer_now() - s_lastFrame) >= budget_ticks();
+}
+
+void load_pacer_frame(LONGLONG renderTicks, bool injected)
+{
+    const LONGLONG now = load_pacer_now();
+
+    if (s_lastFrame) {
+        const double ms = ticks_to_ms((double)(now - s_lastFrame));
+        int b = (int)ms;
+        if (b >= kIntervalBuckets) b = kIntervalBuckets - 1;
+        s_intervalHist[b]++;
+        s_intervalSumMs += ms;
+        if (ms > s_intervalMaxMs) s_intervalMaxMs = ms;
+    }
+    s_lastFrame = now;
+    s_frames++;
+
+    if (injected) {
+        s_injected++;
+        s_renderTicks += renderTicks;
+        s_renderEmaTicks = s_renderEmaTicks > 0.0
+            ? s_renderEmaTicks + kEmaAlpha * ((double)renderTicks - s_renderEmaTicks)
+            : (double)renderTicks;
+    }
+}
+
+static double interval_percentile(double p)
+{
+    const unsigned n = s_frames > 1 ? s_frames - 1 : 0;
+    if (!n) return 0.0;
+    const unsigned target = (unsigned)ceil(p * n);
+    unsigned acc = 0;
+    for (int i = 0; i < kIntervalBuckets; ++i) {
+        acc += s_intervalHist[i];
+        if (acc >= target) return (double)(i + 1);
+    }
+    return (double)kIntervalBuckets;
+}
+
+void load_pacer_report()
+{
+    if (!s_freq.QuadPart || s_frames < 2) return;
+
+    const double loadMs   = ticks_to_ms((double)(load_pacer_now() - s_loadStart));
+    const double renderMs = ticks_to_ms((double)s_renderTicks);
+
+    auto fn_log = get_gamelog();
+    fn_log("[LoadPacing] mode=%s budget=%.1fms | %u frames, interval avg %.1f p50 %.0f p95 %.0f max %.1f ms"
+           " | %u injected renders %.0fms (%.1f%% of %.1fs load)\n",
+           g_loadPacingMode == kLoadPacingThroughput ? "throughput" : "smooth", g_loadFrameBudgetMs,
+           s_frames, s_intervalSumMs / (s_frames - 1), interval_percentile(0.50),
+           interval_percentile(0.95), s_intervalMaxMs, s_injected, renderMs,
+           loadMs > 0.0 ? renderMs * 100.0 / loadMs : 0.0, loadMs / 1000.0);
+}
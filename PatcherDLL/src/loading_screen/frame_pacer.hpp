@@ -0,0 +1,59 @@
+#pragma once
+
+#include "pch.h"
+
+// =============================================================================
+// Loading-screen frame pacer (QPC)
+// =============================================================================
+// Decides when hooked_load_update injects an extra LoadDisplay render.
+// The old gate compared GetTickCount() against 33 ms, which with ~15.6 ms tick
+// resolution put frames anywhere from 16 to 47 ms apart and rendered whether
+// or not the load could afford it.
+//
+// The pacer measures each load slice (time between LoadDisplay::Update calls)
+// and each injected render with QPC, keeps short moving averages of both, and
+// renders according to [LoadScreen] PacingMode:
+//
+//   0 = Smooth     — render now if waiting for the next Update would overshoot
+//                    FrameBudgetMs, so frame intervals stay at or under budget.
+//   1 = Throughput — never render before FrameBudgetMs has elapsed, and
+//                    stretch the interval so injected renders take at most
+//                    kMaxRenderShare of load time.
+//
+// Frames presented by the engine's own 50 ms Update render count toward the
+// interval. Interval stats and time spent rendering are logged once per load.
+
+extern float g_loadFrameBudgetMs;
+extern int   g_loadPacingMode;
+
+enum LoadPacingMode : int {
+    kLoadPacingSmooth     = 0,
+    kLoadPacingThroughput = 1,
+};
+
+// New loading screen (LoadConfig) — clear timers and stats.
+void load_pacer_reset();
+
+// Bracket the original LoadDisplay::Update call.
+void load_pacer_update_begin();
+void load_pacer_update_end();
+
+// Should an extra render be injected now (inside an Update slice)?
+bool load_pacer_should_render();
+
+// Idle wait loop (LoadDisplay::End) — plain budget interval.
+bool load_pacer_interval_elapsed();
+
+// A frame was presented. renderTicks = QPC ticks of an injected render,
+// 0 for a render issued by the engine itself.
+void load_pacer_frame(LONGLONG renderTicks, bool injected);
+
+// Log interval / render-time stats for this load.
+void load_pacer_report();
+
+inline LONGLONG load_pacer_now()
+{
+    LARGE_INTEGER t;
+    QueryPerformanceCounter(&t);
+    return t.QuadPart;
+}
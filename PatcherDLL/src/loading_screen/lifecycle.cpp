@@ -1,6 +1,10 @@
 #include "pch.h"
 #include "shared.hpp"
+#include "load_profiler.hpp"
+#include "lvl_prefetch.hpp"
+#include "frame_pacer.hpp"
 #include "core/game_addrs.hpp"
+#include "render/frame_clock.hpp"
 
 #include <detours.h>
 
@@ -107,12 +111,17 @@ void loading_screen_play_sound(uint32_t sound_hash)
 
 void __fastcall hooked_load_data_file(void* ecx, void* edx, const char* lvlPath)
 {
+    lvl_prefetch_begin_load();
+    const LoadProfScope prof = load_profiler_enter();
     g_orig_load_data_file(ecx, edx, lvlPath);
+    load_profiler_data_file(prof, lvlPath);
 
     // Load the BF1-ext sound LVL once per loading screen.
     if (g_loadScreenCfg.bf1Enabled && g_loadScreenCfg.loadSoundLvl[0] && !s_sndLvlLoaded) {
         s_sndLvlLoaded = true;
+        const LoadProfScope sndProf = load_profiler_enter();
         g_orig_load_data_file(ecx, edx, g_loadScreenCfg.loadSoundLvl);
+        load_profiler_data_file(sndProf, g_loadScreenCfg.loadSoundLvl);
         s_lastAnimPhase = -1;
         s_lastAnimCycle = -1;
     }
@@ -128,6 +137,8 @@ void __fastcall hooked_load_update(void* ecx, void* edx)
         return;
     }
 
+    frame_clock_attach();
+
     // BF1 mode: redirect s_loadHeap -> RunTimeHeap for the entire Update call.
     int saved_load_heap = -1;
     if (g_loadScreenCfg.bf1Enabled && g_s_load_heap_ptr && g_runtime_heap_idx) {
@@ -135,8 +146,14 @@ void __fastcall hooked_load_update(void* ecx, void* edx)
         *g_s_load_heap_ptr   = *g_runtime_heap_idx;
     }
 
+    lvl_prefetch_begin_load();
+    const LoadProfScope prof = load_profiler_enter();
+    LONGLONG extraRenderTicks = 0;
+
+    load_pacer_update_begin();
     const DWORD qpc_before = g_qpc_stamp ? *g_qpc_stamp : 0;
     g_orig_load_update(ecx, edx);
+    const bool engineRendered = g_qpc_stamp && *g_qpc_stamp != qpc_before;
 
     if (saved_load_heap >= 0 && g_s_load_heap_ptr)
         *g_s_load_heap_ptr = saved_load_heap;
@@ -151,22 +168,27 @@ void __fastcall hooked_load_update(void* ecx, void* edx)
         g_lastSndUpdateMs = now;
     }
 
-    if (!g_loadScreenCfg.bf1Enabled || !g_orig_load_render) return;
-
-    if (g_qpc_stamp && *g_qpc_stamp != qpc_before) {
-        g_lastRenderMs = GetTickCount();
-    } else if (ecx && *(const uint8_t*)ecx != 0
-               && GetTickCount() - g_lastRenderMs >= 33u) {
-        g_lastRenderMs = GetTickCount();
-        {
-            int prevRenderHeap = -1;
-            if (g_set_current_heap && g_runtime_heap_idx)
-                prevRenderHeap = g_set_current_heap(*g_runtime_heap_idx);
-            g_orig_load_render(ecx, nullptr);
-            if (prevRenderHeap >= 0 && g_set_current_heap)
-                g_set_current_heap(prevRenderHeap);
-        }
+    if (!g_loadScreenCfg.bf1Enabled || !g_orig_load_render) {
+        load_profiler_update(prof, engineRendered, 0);
+        return;
     }
+
+    if (engineRendered) {
+        load_pacer_frame(0, false);
+    } else if (ecx && *(const uint8_t*)ecx != 0 && load_pacer_should_render()) {
+        const LONGLONG r0 = load_pacer_now();
+        int prevRenderHeap = -1;
+        if (g_set_current_heap && g_runtime_heap_idx)
+            prevRenderHeap = g_set_current_heap(*g_runtime_heap_idx);
+        g_orig_load_render(ecx, nullptr);
+        if (prevRenderHeap >= 0 && g_set_current_heap)
+            g_set_current_heap(prevRenderHeap);
+        extraRenderTicks = load_pacer_now() - r0;
+        load_pacer_frame(extraRenderTicks, true);
+    }
+
+    load_pacer_update_end();
+    load_profiler_update(prof, engineRendered, extraRenderTicks);
 }
 
 // =============================================================================
@@ -214,7 +236,7 @@ void __fastcall hooked_load_end(void* ecx, void* edx)
                     if (saved_load_heap_end >= 0 && g_s_load_heap_ptr)
                         *g_s_load_heap_ptr = saved_load_heap_end;
                     if (g_qpc_stamp && *g_qpc_stamp != qpc_before)
-                        g_lastRenderMs = GetTickCount();
+                        load_pacer_frame(0, false);
 
                     if (g_snd_update) {
                         const DWORD sndNow = GetTickCount();
@@ -224,25 +246,31 @@ void __fastcall hooked_load_end(void* ecx, void* edx)
                         g_lastSndUpdateMs = sndNow;
                     }
                 }
-                if (g_orig_load_render && GetTickCount() - g_lastRenderMs >= 33u) {
-                    g_lastRenderMs = GetTickCount();
+                if (g_orig_load_render && load_pacer_interval_elapsed()) {
+                    const LONGLONG r0 = load_pacer_now();
                     int prevRenderHeap = -1;
                     if (g_set_current_heap && g_runtime_heap_idx)
                         prevRenderHeap = g_set_current_heap(*g_runtime_heap_idx);
                     g_orig_load_render(ecx, nullptr);
                     if (prevRenderHeap >= 0 && g_set_current_heap)
                         g_set_current_heap(prevRenderHeap);
+                    load_pacer_frame(load_pacer_now() - r0, true);
                 }
                 Sleep(1);
             }
         }
     }
 
+    if (g_loadScreenCfg.bf1Enabled) load_pacer_report();
+
     tracking_sound_stop();
     g_endProcessed = true;
     g_inRealEnd = true;
     g_orig_load_end(ecx, edx);
     g_inRealEnd = false;
+
+    load_profiler_end_load();
+    lvl_prefetch_end_load();
 }
 
 // =============================================================================
@@ -270,20 +298,9 @@ void loading_screen_install(uintptr_t exe_base)
     g_runtime_heap_idx = (int*)                  resolve(exe_base, runtime_heap_global);
     g_s_load_heap_ptr  = (int*)                  resolve(exe_base, s_loadheap_global);
 
-    g_hash_string = (fn_hash_string_t)resolve(exe_base, hash_string);
     g_pbl_find    = (fn_pbl_find_t)   resolve(exe_base, pbl_hash_table_find);
     g_tex_table   =                   resolve(exe_base, tex_hash_table);
 
-    if (g_hash_string) {
-        kHash_ZoomSelectorTileSize = g_hash_string("ZoomSelectorTileSize");
-        kHash_LoadSoundLVL         = g_hash_string("LoadSoundLVL");
-        kHash_PC               = g_hash_string("PC");
-        kHash_PS2              = g_hash_string("PS2");
-        kHash_XBOX             = g_hash_string("XBOX");
-        kHash_RemoveToolTips   = g_hash_string("RemoveToolTips");
-        kHash_RemoveLoadingBar = g_hash_string("RemoveLoadingBar");
-    }
-
     g_orig_load_data_file = (fn_load_data_file_t)resolve(exe_base, load_data_file_real);
     g_orig_load_config    = (fn_load_config_t)   resolve(exe_base, load_config_real);
     g_orig_render_screen  = (fn_render_screen_t) resolve(exe_base, render_screen_real);
@@ -301,6 +318,9 @@ void loading_screen_install(uintptr_t exe_base)
     DetourAttach(&(PVOID&)g_orig_load_end,       hooked_load_end);
     DetourAttach(&(PVOID&)g_orig_load_update,    hooked_load_update);
     DetourTransactionCommit();
+
+    load_profiler_install(exe_base);
+    lvl_prefetch_install(exe_base);
 }
 
 void loading_screen_uninstall()
@@ -313,4 +333,7 @@ void loading_screen_uninstall()
     if (g_orig_load_end)       DetourDetach(&(PVOID&)g_orig_load_end,       hooked_load_end);
     if (g_orig_load_update)    DetourDetach(&(PVOID&)g_orig_load_update,    hooked_load_update);
     DetourTransactionCommit();
+
+    load_profiler_uninstall();
+    lvl_prefetch_uninstall();
 }
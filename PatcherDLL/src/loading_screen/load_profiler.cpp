@@ -0,0 +1,454 @@
+#include "pch.h"
+#include "load_profiler.hpp"
+#include "shared.hpp"
+#include "core/game_addrs.hpp"
+
+#include <detours.h>
+#include <climits>
+#include <stdio.h>
+
+bool g_loadProfilerEnabled = false;
+
+// =============================================================================
+// Engine functions / constants
+// =============================================================================
+
+typedef int (__cdecl* fn_red_get_heap_free_t)(int heapIndex);
+static fn_red_get_heap_free_t g_red_get_heap_free = nullptr;
+
+// TempLoadHeap is built over a 2 MB block from RunTimeHeap (see RedHeapSystem.md)
+static constexpr int kTempHeapBlockSize = 2 * 1024 * 1024;
+
+// =============================================================================
+// Session storage — fixed-size, dropped events are counted and reported
+// =============================================================================
+
+enum ProfEventKind : uint8_t {
+    kEvDataFile = 0,   // LoadDisplay::LoadDataFile
+    kEvUpdate   = 1,   // LoadDisplay::Update slice
+    kEvFile     = 2,   // .lvl CreateFileA -> CloseHandle
+};
+
+static constexpr uint8_t kEvFlag_EngineRender = 0x01;
+static constexpr uint8_t kEvFlag_ExtraRender  = 0x02;
+
+struct ProfEvent {
+    LONGLONG t0, t1;
+    LONGLONG aux;          // update: extra render ticks, file: ticks inside ReadFile
+    uint64_t bytes;
+    int      runtimeFree;  // -1 = not sampled
+    int      tempFree;
+    uint16_t path;         // index into s_paths (kEvDataFile / kEvFile)
+    uint8_t  kind;
+    uint8_t  flags;
+};
+
+static constexpr int kMaxEvents   = 16384;
+static constexpr int kMaxPaths    = 512;
+static constexpr int kMaxPathLen  = 128;
+
+static ProfEvent s_events[kMaxEvents];
+static int       s_eventCount   = 0;
+static int       s_eventsDropped = 0;
+
+static char      s_paths[kMaxPaths][kMaxPathLen];
+static int       s_pathCount = 0;
+
+static bool      s_active      = false;
+static LONGLONG  s_sessionT0   = 0;
+static int       s_sessionNum  = 0;
+static DWORD     s_mainThread  = 0;
+static LARGE_INTEGER s_freq    = {};
+
+static GameLog_t g_log = nullptr;
+
+// Main-thread ReadFile byte total (all files), used for per-scope byte counts.
+static uint64_t  s_mainBytesRead = 0;
+
+static inline LONGLONG qpc_now()
+{
+    LARGE_INTEGER t;
+    QueryPerformanceCounter(&t);
+    return t.QuadPart;
+}
+
+static inline double ticks_to_us(LONGLONG ticks)
+{
+    return (double)ticks * 1000000.0 / (double)s_freq.QuadPart;
+}
+
+static inline double ticks_to_ms(LONGLONG ticks)
+{
+    return (double)ticks * 1000.0 / (double)s_freq.QuadPart;
+}
+
+static uint16_t intern_path(const char* path)
+{
+    if (!path) path = "(null)";
+
+    // Keep the tail — the interesting part of a long absolute path.
+    const size_t len = strlen(path);
+    if (len >= kMaxPathLen) path += len - (kMaxPathLen - 1);
+
+    for (int i = 0; i < s_pathCount; ++i)
+        if (strcmp(s_paths[i], path) == 0) return (uint16_t)i;
+
+    if (s_pathCount >= kMaxPaths) return (uint16_t)(kMaxPaths - 1);
+    strncpy_s(s_paths[s_pathCount], kMaxPathLen, path, _TRUNCATE);
+    return (uint16_t)s_pathCount++;
+}
+
+static void sample_heaps(ProfEvent* ev)
+{
+    ev->runtimeFree = -1;
+    ev->tempFree    = -1;
+    if (!g_red_get_heap_free) return;
+
+    // The free-list walk faults on a torn-down TempLoadHeap (0xDE fill) —
+    // a failed sample is recorded as -1 rather than taking the load down.
+    __try {
+        if (g_runtime_heap_idx)
+            ev->runtimeFree = g_red_get_heap_free(*g_runtime_heap_idx);
+    } __except (EXCEPTION_EXECUTE_HANDLER) {}
+
+    __try {
+        if (g_s_load_heap_ptr && g_runtime_heap_idx && *g_s_load_heap_ptr != *g_runtime_heap_idx)
+            ev->tempFree = g_red_get_heap_free(*g_s_load_heap_ptr);
+    } __except (EXCEPTION_EXECUTE_HANDLER) {}
+}
+
+static void begin_session_if_needed(LONGLONG t0)
+{
+    if (s_active) return;
+    s_active        = true;
+    s_sessionT0     = t0;
+    s_eventCount    = 0;
+    s_eventsDropped = 0;
+    s_pathCount     = 0;
+    s_mainThread    = GetCurrentThreadId();
+}
+
+static ProfEvent* push_event(uint8_t kind, LONGLONG t0, LONGLONG t1)
+{
+    if (s_eventCount >= kMaxEvents) {
+        s_eventsDropped++;
+        return nullptr;
+    }
+    ProfEvent* ev = &s_events[s_eventCount++];
+    memset(ev, 0, sizeof(*ev));
+    ev->kind = kind;
+    ev->t0   = t0;
+    ev->t1   = t1;
+    return ev;
+}
+
+// =============================================================================
+// kernel32 file hooks — .lvl open/read/close accounting (main thread only)
+// =============================================================================
+
+struct TrackedFile {
+    HANDLE   handle;
+    LONGLONG t0;
+    LONGLONG readTicks;
+    uint64_t bytes;
+    uint16_t path;
+};
+
+static constexpr int kMaxOpenFiles = 16;
+static TrackedFile s_openFiles[kMaxOpenFiles];
+
+static decltype(&CreateFileA) s_origCreateFileA = CreateFileA;
+static decltype(&ReadFile)    s_origReadFile    = ReadFile;
+static decltype(&CloseHandle) s_origCloseHandle = CloseHandle;
+
+static bool is_lvl_path(const char* path)
+{
+    if (!path) return false;
+    const size_t len = strlen(path);
+    return len > 4 && _stricmp(path + len - 4, ".lvl") == 0;
+}
+
+static TrackedFile* find_open_file(HANDLE h)
+{
+    for (auto& f : s_openFiles)
+        if (f.handle == h) return &f;
+    return nullptr;
+}
+
+static HANDLE WINAPI hooked_CreateFileA(LPCSTR name, DWORD access, DWORD share,
+                                        LPSECURITY_ATTRIBUTES sa, DWORD disposition,
+                                        DWORD flags, HANDLE tmpl)
+{
+    const LONGLONG t0 = qpc_now();
+    HANDLE h = s_origCreateFileA(name, access, share, sa, disposition, flags, tmpl);
+
+    if (s_active && h != INVALID_HANDLE_VALUE && GetCurrentThreadId() == s_mainThread
+        && is_lvl_path(name)) {
+        TrackedFile* slot = find_open_file(nullptr);
+        if (slot) {
+            slot->handle    = h;
+            slot->t0        = t0;
+            slot->readTicks = 0;
+            slot->bytes     = 0;
+            slot->path      = intern_path(name);
+        }
+    }
+    return h;
+}
+
+static BOOL WINAPI hooked_ReadFile(HANDLE h, LPVOID buf, DWORD toRead, LPDWORD read,
+                                  LPOVERLAPPED ov)
+{
+    if (!s_active || GetCurrentThreadId() != s_mainThread)
+        return s_origReadFile(h, buf, toRead, read, ov);
+
+    DWORD localRead = 0;
+    if (!read && !ov) read = &localRead;
+
+    const LONGLONG t0 = qpc_now();
+    const BOOL ok = s_origReadFile(h, buf, toRead, read, ov);
+    const LONGLONG dt = qpc_now() - t0;
+
+    const DWORD got = (ok && read) ? *read : 0;
+    s_mainBytesRead += got;
+    if (TrackedFile* f = find_open_file(h)) {
+        f->readTicks += dt;
+        f->bytes     += got;
+    }
+    return ok;
+}
+
+static BOOL WINAPI hooked_CloseHandle(HANDLE h)
+{
+    if (s_active && GetCurrentThreadId() == s_mainThread) {
+        if (TrackedFile* f = find_open_file(h)) {
+            if (ProfEvent* ev = push_event(kEvFile, f->t0, qpc_now())) {
+                ev->aux   = f->readTicks;
+                ev->bytes = f->bytes;
+                ev->path  = f->path;
+                sample_heaps(ev);
+            }
+            f->handle = nullptr;
+        }
+    }
+    return s_origCloseHandle(h);
+}
+
+// =============================================================================
+// Scope API (called from lifecycle.cpp hooks)
+// =============================================================================
+
+LoadProfScope load_profiler_enter()
+{
+    if (!g_loadProfilerEnabled) return {0, 0};
+    const LONGLONG t0 = qpc_now();
+    begin_session_if_needed(t0);
+    return {t0, s_mainBytesRead};
+}
+
+void load_profiler_data_file(const LoadProfScope& scope, const char* lvlPath)
+{
+    if (!scope.t0) return;
+    if (ProfEvent* ev = push_event(kEvDataFile, scope.t0, qpc_now())) {
+        ev->bytes = s_mainBytesRead - scope.bytes0;
+        ev->path  = intern_path(lvlPath);
+        sample_heaps(ev);
+    }
+}
+
+void load_profiler_update(const LoadProfScope& scope, bool engineRendered, LONGLONG renderTicks)
+{
+    if (!scope.t0) return;
+    if (ProfEvent* ev = push_event(kEvUpdate, scope.t0, qpc_now())) {
+        ev->bytes = s_mainBytesRead - scope.bytes0;
+        ev->aux   = renderTicks;
+        ev->flags = (engineRendered ? kEvFlag_EngineRender : 0)
+                  | (renderTicks    ? kEvFlag_ExtraRender  : 0);
+        sample_heaps(ev);
+    }
+}
+
+// =============================================================================
+// Trace / summary output
+// =============================================================================
+
+static void write_json_string(FILE* f, const char* s)
+{
+    fputc('"', f);
+    for (; *s; ++s) {
+        const char c = *s;
+        if (c == '"' || c == '\\') { fputc('\\', f); fputc(c, f); }
+        else if ((unsigned char)c < 0x20) fprintf(f, "\\u%04x", (unsigned char)c);
+        else fputc(c, f);
+    }
+    fputc('"', f);
+}
+
+static void write_trace(const char* filename)
+{
+    FILE* f = nullptr;
+    if (fopen_s(&f, filename, "w") != 0 || !f) return;
+
+    fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(f, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"LoadDisplay\"}},\n");
+    fprintf(f, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\".lvl I/O\"}}");
+
+    for (int i = 0; i < s_eventCount; ++i) {
+        const ProfEvent& ev = s_events[i];
+        const double ts  = ticks_to_us(ev.t0 - s_sessionT0);
+        const double dur = ticks_to_us(ev.t1 - ev.t0);
+
+        switch (ev.kind) {
+        case kEvDataFile:
+            fprintf(f, ",\n{\"name\":\"LoadDataFile\",\"cat\":\"lvl\",\"ph\":\"X\",\"pid\":1,\"tid\":1,"
+                       "\"ts\":%.1f,\"dur\":%.1f,\"args\":{\"path\":", ts, dur);
+            write_json_string(f, s_paths[ev.path]);
+            fprintf(f, ",\"bytes\":%llu}}", (unsigned long long)ev.bytes);
+            break;
+        case kEvUpdate:
+            fprintf(f, ",\n{\"name\":\"Update\",\"cat\":\"display\",\"ph\":\"X\",\"pid\":1,\"tid\":1,"
+                       "\"ts\":%.1f,\"dur\":%.1f,\"args\":{\"engineRender\":%d,\"extraRenderMs\":%.3f,"
+                       "\"bytes\":%llu}}",
+                    ts, dur, (ev.flags & kEvFlag_EngineRender) ? 1 : 0, ticks_to_ms(ev.aux),
+                    (unsigned long long)ev.bytes);
+            break;
+        case kEvFile:
+            fprintf(f, ",\n{\"name\":");
+            write_json_string(f, s_paths[ev.path]);
+            fprintf(f, ",\"cat\":\"io\",\"ph\":\"X\",\"pid\":1,\"tid\":2,\"ts\":%.1f,\"dur\":%.1f,"
+                       "\"args\":{\"bytes\":%llu,\"readMs\":%.3f}}",
+                    ts, dur, (unsigned long long)ev.bytes, ticks_to_ms(ev.aux));
+            break;
+        }
+
+        if (ev.runtimeFree >= 0 || ev.tempFree >= 0) {
+            fprintf(f, ",\n{\"name\":\"RedHeap free\",\"ph\":\"C\",\"pid\":1,\"ts\":%.1f,\"args\":{", ts + dur);
+            fprintf(f, "\"RunTimeHeap\":%d", ev.runtimeFree >= 0 ? ev.runtimeFree : 0);
+            if (ev.tempFree >= 0)
+                fprintf(f, ",\"TempLoadHeap\":%d,\"TempLoadHeapUsed\":%d",
+                        ev.tempFree, kTempHeapBlockSize - ev.tempFree);
+            fprintf(f, "}}");
+        }
+    }
+
+    fprintf(f, "\n]}\n");
+    fclose(f);
+}
+
+void load_profiler_end_load()
+{
+    if (!g_loadProfilerEnabled || !s_active) return;
+
+    const LONGLONG tEnd = qpc_now();
+    s_active = false;
+    s_sessionNum++;
+
+    // Anything still open at End is closed in the trace at End time.
+    for (auto& of : s_openFiles) {
+        if (!of.handle) continue;
+        if (ProfEvent* ev = push_event(kEvFile, of.t0, tEnd)) {
+            ev->aux   = of.readTicks;
+            ev->bytes = of.bytes;
+            ev->path  = of.path;
+            ev->runtimeFree = ev->tempFree = -1;
+        }
+        of.handle = nullptr;
+    }
+
+    // Aggregate
+    double   dataFileMs = 0.0, updateMs = 0.0, renderMs = 0.0, ioReadMs = 0.0;
+    int      nDataFiles = 0, nUpdates = 0, nFiles = 0;
+    uint64_t ioBytes = 0;
+    int      minRuntimeFree = INT_MAX, minTempFree = INT_MAX;
+    int      slow[3] = {-1, -1, -1};
+
+    for (int i = 0; i < s_eventCount; ++i) {
+        const ProfEvent& ev = s_events[i];
+        const double ms = ticks_to_ms(ev.t1 - ev.t0);
+        if (ev.runtimeFree >= 0 && ev.runtimeFree < minRuntimeFree) minRuntimeFree = ev.runtimeFree;
+        if (ev.tempFree    >= 0 && ev.tempFree    < minTempFree)    minTempFree    = ev.tempFree;
+
+        if (ev.kind == kEvDataFile) { dataFileMs += ms; nDataFiles++; }
+        else if (ev.kind == kEvUpdate) { updateMs += ms; renderMs += ticks_to_ms(ev.aux); nUpdates++; }
+        else if (ev.kind == kEvFile) {
+            nFiles++;
+            ioBytes  += ev.bytes;
+            ioReadMs += ticks_to_ms(ev.aux);
+
+            // Keep the three longest-open .lvl files
+            for (int k = 0; k < 3; ++k) {
+                if (slow[k] < 0 || ms > ticks_to_ms(s_events[slow[k]].t1 - s_events[slow[k]].t0)) {
+                    for (int m = 2; m > k; --m) slow[m] = slow[m - 1];
+                    slow[k] = i;
+                    break;
+                }
+            }
+        }
+    }
+
+    char traceName[64];
+    snprintf(traceName, sizeof(traceName), "BF2GameExt_load_%d.json", s_sessionNum);
+    write_trace(traceName);
+
+    char slowest[3 * (kMaxPathLen + 16)] = {};
+    for (int k = 0; k < 3 && slow[k] >= 0; ++k) {
+        const ProfEvent& ev = s_events[slow[k]];
+        char part[kMaxPathLen + 24];
+        snprintf(part, sizeof(part), "%s%s %.0fms", k ? ", " : "", s_paths[ev.path],
+                 ticks_to_ms(ev.t1 - ev.t0));
+        strncat_s(slowest, sizeof(slowest), part, _TRUNCATE);
+    }
+
+    char line[1024];
+    snprintf(line, sizeof(line),
+             "[LoadProf] load #%d: %.0fms total | %d .lvl files %.1f MB (read %.0fms) | "
+             "LoadDataFile x%d %.0fms | Update x%d %.0fms (extra render %.0fms) | "
+             "RunTimeHeap min free %d KB | TempLoadHeap peak %d KB | slowest: %s%s -> %s\n",
+             s_sessionNum, ticks_to_ms(tEnd - s_sessionT0), nFiles, (double)ioBytes / (1024.0 * 1024.0),
+             ioReadMs, nDataFiles, dataFileMs, nUpdates, updateMs, renderMs,
+             minRuntimeFree == INT_MAX ? -1 : minRuntimeFree / 1024,
+             minTempFree == INT_MAX ? -1 : (kTempHeapBlockSize - minTempFree) / 1024,
+             slowest[0] ? slowest : "-", s_eventsDropped ? " (events dropped)" : "", traceName);
+
+    FILE* f = nullptr;
+    if (fopen_s(&f, "BF2GameExt.log", "a") == 0 && f) {
+        fputs(line, f);
+        fclose(f);
+    }
+    if (g_log) g_log("%s", line);
+}
+
+// =============================================================================
+// Install / Uninstall
+// =============================================================================
+
+void load_profiler_install(uintptr_t exe_base)
+{
+    if (!g_loadProfilerEnabled) return;
+
+    g_log = get_gamelog();
+    QueryPerformanceFrequency(&s_freq);
+    g_red_get_heap_free = (fn_red_get_heap_free_t)resolve(exe_base, game_addrs::modtools::red_get_heap_free);
+
+    DetourTransactionBegin();
+    DetourUpdateThread(GetCurrentThread());
+    DetourAttach(&(PVOID&)s_origCreateFileA, hooked_CreateFileA);
+    DetourAttach(&(PVOID&)s_origReadFile,    hooked_ReadFile);
+    DetourAttach(&(PVOID&)s_origCloseHandle, hooked_CloseHandle);
+    LONG rc = DetourTransactionCommit();
+
+    if (g_log) g_log("[LoadProf] Installed (file hooks commit=%ld)\n", rc);
+}
+
+void load_profiler_uninstall()
+{
+    if (!g_loadProfilerEnabled) return;
+
+    s_active = false;
+    DetourTransactionBegin();
+    DetourUpdateThread(GetCurrentThread());
+    DetourDetach(&(PVOID&)s_origCreateFileA, hooked_CreateFileA);
+    DetourDetach(&(PVOID&)s_origReadFile,    hooked_ReadFile);
+    DetourDetach(&(PVOID&)s_origCloseHandle, hooked_CloseHandle);
+    DetourTransactionCommit();
+}
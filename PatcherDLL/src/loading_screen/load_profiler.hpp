@@ -0,0 +1,46 @@
+#pragma once
+
+#include "pch.h"
+
+// =============================================================================
+// Level-load timeline profiler
+// =============================================================================
+// Records where a level load spends its time:
+//   - every LoadDisplay::LoadDataFile call (path, duration, bytes read)
+//   - every LoadDisplay::Update slice (duration, whether a frame was rendered)
+//   - every .lvl file opened through CreateFileA (open -> close span, bytes
+//     and time spent inside ReadFile) -- this covers mission ReadDataFile
+//     loads, which do not go through LoadDisplay
+//   - RedHeap free space (_RedGetHeapFree) for RunTimeHeap and TempLoadHeap
+//     at the end of each of the above
+//
+// When LoadDisplay::End runs, the session is written to
+// BF2GameExt_load_<n>.json (Chrome trace_event format -- open in
+// chrome://tracing or ui.perfetto.dev) and a one-line summary is appended to
+// BF2GameExt.log.
+//
+// Gated on [Profiling] LoadProfiler=1; every entry point is a single branch
+// when disabled.
+
+extern bool g_loadProfilerEnabled;
+
+// Opaque start token for a timed scope. t0 == 0 when the profiler is off.
+struct LoadProfScope {
+    LONGLONG t0;
+    uint64_t bytes0;
+};
+
+LoadProfScope load_profiler_enter();
+
+// Close a LoadDataFile scope.
+void load_profiler_data_file(const LoadProfScope& scope, const char* lvlPath);
+
+// Close a LoadDisplay::Update scope. renderTicks = QPC ticks of the slice
+// spent in extra renders issued by hooked_load_update.
+void load_profiler_update(const LoadProfScope& scope, bool engineRendered, LONGLONG renderTicks);
+
+// LoadDisplay::End -- flush the trace and summary for this load.
+void load_profiler_end_load();
+
+void load_profiler_install(uintptr_t exe_base);
+void load_profiler_uninstall();
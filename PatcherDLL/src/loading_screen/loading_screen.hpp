@@ -38,6 +38,16 @@ struct LoadScreenConfig {
     float    animFPS;
     float    animX, animY, animW, animH; // optional rect; w==0 means full-screen
 
+    // AnimatedAtlas: texName, cols, rows, count, fps[, x, y, w, h]
+    // Flipbook packed into one texture: frame i is the sub-rect at column
+    // i % cols, row i / cols (row 0 at the top). count <= 0 means cols*rows.
+    // One texture and one hash lookup regardless of frame count.
+    uint32_t atlasHash;
+    int      atlasCols, atlasRows;
+    int      atlasCount;
+    float    atlasFPS;
+    float    atlasX, atlasY, atlasW, atlasH; // optional rect; w==0 means full-screen
+
     // Sound hashes (play on specific loading screen events)
     uint32_t xTrackSoundHash;
     uint32_t yTrackSoundHash;
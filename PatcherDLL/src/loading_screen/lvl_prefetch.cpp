@@ -0,0 +1,479 @@
+#include "pch.h"
+#include "lvl_prefetch.hpp"
+#include "core/resolve.hpp"
+
+#include <detours.h>
+#include <stdio.h>
+
+bool g_lvlPrefetchEnabled   = false;
+int  g_lvlPrefetchLookahead = 3;
+int  g_lvlPrefetchBudgetMB  = 256;
+
+static GameLog_t g_log = nullptr;
+
+static const char* const kManifestName = "BF2GameExt_prefetch.txt";
+
+// =============================================================================
+// Learned sequences
+// =============================================================================
+
+static constexpr int kMaxSeqs     = 8;
+static constexpr int kMaxSeqFiles = 128;
+static constexpr int kMaxPathLen  = 192;
+
+// How far ahead of a sequence's cursor an observed open may land and still
+// count as a match (tolerates an optional .lvl appearing or disappearing).
+static constexpr int kMatchWindow = 4;
+
+struct LvlSequence {
+    int      count;
+    int      lastLoadMs;
+    int      coldLoadMs;    // last load with nothing warmed, 0 = none yet
+    int      warmLoadMs;    // last load with warmed opens, 0 = none yet
+    uint32_t lastUse;
+    char     files[kMaxSeqFiles][kMaxPathLen];
+};
+
+static LvlSequence s_seqs[kMaxSeqs];
+static int         s_seqCount = 0;
+static uint32_t    s_useClock = 0;
+
+// Current load
+static bool     s_loading     = false;
+static DWORD    s_mainThread  = 0;
+static LONGLONG s_loadT0      = 0;
+static char     s_cur[kMaxSeqFiles][kMaxPathLen];
+static int      s_curCount    = 0;
+static int      s_cursor[kMaxSeqs];     // next expected index, -1 = no longer matching
+static int      s_statPredicted = 0;    // opens that had been queued for prefetch
+static int      s_statWarm      = 0;    // opens whose prefetch had finished
+static uint64_t s_statBytes     = 0;
+
+// =============================================================================
+// Prefetch jobs — shared with the worker thread under s_lock
+// =============================================================================
+
+enum JobState : int { kJobFree = 0, kJobQueued, kJobReading, kJobDone };
+
+struct PrefetchJob {
+    volatile LONG state;
+    volatile LONG opened;     // engine has opened this file — stop / release budget
+    uint64_t      bytes;      // warmed so far
+    char          path[kMaxPathLen];
+};
+
+static constexpr int kMaxJobs = 32;
+static PrefetchJob      s_jobs[kMaxJobs];
+static CRITICAL_SECTION s_lock;
+static uint64_t         s_outstanding = 0;   // warmed bytes not yet opened by the engine
+
+static HANDLE s_thread    = nullptr;
+static HANDLE s_wakeEvent = nullptr;
+static HANDLE s_stopEvent = nullptr;
+
+static decltype(&CreateFileA) s_origCreateFileA = CreateFileA;
+
+static inline LONGLONG qpc_now()
+{
+    LARGE_INTEGER t;
+    QueryPerformanceCounter(&t);
+    return t.QuadPart;
+}
+
+static inline uint64_t budget_bytes()
+{
+    return (uint64_t)(g_lvlPrefetchBudgetMB > 0 ? g_lvlPrefetchBudgetMB : 0) * 1024u * 1024u;
+}
+
+static bool is_lvl_path(const char* path)
+{
+    if (!path) return false;
+    const size_t len = strlen(path);
+    return len > 4 && _stricmp(path + len - 4, ".lvl") == 0;
+}
+
+// =============================================================================
+// Worker thread — sequential-scan reads into a scratch buffer
+// =============================================================================
+
+static constexpr DWORD kChunkSize = 1024 * 1024;
+
+static PrefetchJob* take_next_job()
+{
+    PrefetchJob* job = nullptr;
+    EnterCriticalSection(&s_lock);
+    if (s_outstanding < budget_bytes()) {
+        for (auto& j : s_jobs) {
+            if (j.state == kJobQueued && !j.opened) {
+                j.state = kJobReading;
+                job = &j;
+                break;
+            }
+        }
+    }
+    LeaveCriticalSection(&s_lock);
+    return job;
+}
+
+static void warm_file(PrefetchJob* job, void* scratch)
+{
+    HANDLE h = s_origCreateFileA(job->path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                 FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (h == INVALID_HANDLE_VALUE) return;
+
+    for (;;) {
+        if (job->opened || WaitForSingleObject(s_stopEvent, 0) == WAIT_OBJECT_0) break;
+
+        EnterCriticalSection(&s_lock);
+        const bool overBudget = s_outstanding >= budget_bytes();
+        LeaveCriticalSection(&s_lock);
+        if (overBudget) {
+            // Wait for the engine to consume something before reading further.
+            WaitForSingleObject(s_wakeEvent, 20);
+            continue;
+        }
+
+        DWORD got = 0;
+        if (!ReadFile(h, scratch, kChunkSize, &got, nullptr) || got == 0) break;
+
+        EnterCriticalSection(&s_lock);
+        job->bytes += got;
+        if (!job->opened) s_outstanding += got;
+        s_statBytes += got;
+        LeaveCriticalSection(&s_lock);
+    }
+    CloseHandle(h);
+}
+
+static DWORD WINAPI prefetch_thread(LPVOID)
+{
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+
+    void* scratch = VirtualAlloc(nullptr, kChunkSize, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    if (!scratch) return 1;
+
+    HANDLE waits[2] = { s_stopEvent, s_wakeEvent };
+    for (;;) {
+        if (WaitForMultipleObjects(2, waits, FALSE, 50) == WAIT_OBJECT_0) break;
+
+        while (PrefetchJob* job = take_next_job()) {
+            warm_file(job, scratch);
+            InterlockedExchange(&job->state, kJobDone);
+            if (WaitForSingleObject(s_stopEvent, 0) == WAIT_OBJECT_0) break;
+        }
+    }
+
+    VirtualFree(scratch, 0, MEM_RELEASE);
+    return 0;
+}
+
+// =============================================================================
+// Prediction (main thread)
+// =============================================================================
+
+static PrefetchJob* find_job(const char* path)
+{
+    for (auto& j : s_jobs)
+        if (j.state != kJobFree && _stricmp(j.path, path) == 0) return &j;
+    return nullptr;
+}
+
+static bool already_opened(const char* path)
+{
+    for (int i = 0; i < s_curCount; ++i)
+        if (_stricmp(s_cur[i], path) == 0) return true;
+    return false;
+}
+
+static void queue_job(const char* path)
+{
+    if (find_job(path) || already_opened(path)) return;
+    for (auto& j : s_jobs) {
+        // Finished jobs the engine has already consumed are reusable.
+        if (j.state == kJobFree || (j.state == kJobDone && j.opened)) {
+            strncpy_s(j.path, kMaxPathLen, path, _TRUNCATE);
+            j.bytes  = 0;
+            j.opened = 0;
+            InterlockedExchange(&j.state, kJobQueued);
+            return;
+        }
+    }
+}
+
+// Queue the next files every still-matching sequence agrees on.
+static void schedule_lookahead()
+{
+    const int lookahead = g_lvlPrefetchLookahead > 0 ? g_lvlPrefetchLookahead : 0;
+
+    EnterCriticalSection(&s_lock);
+    for (int k = 0; k < lookahead; ++k) {
+        const char* next = nullptr;
+        bool agree = true;
+        for (int i = 0; i < s_seqCount && agree; ++i) {
+            if (s_cursor[i] < 0) continue;
+            const int idx = s_cursor[i] + k;
+            if (idx >= s_seqs[i].count) { agree = false; break; }
+            if (!next) next = s_seqs[i].files[idx];
+            else if (_stricmp(next, s_seqs[i].files[idx]) != 0) agree = false;
+        }
+        if (!agree || !next) break;
+        queue_job(next);
+    }
+    LeaveCriticalSection(&s_lock);
+
+    SetEvent(s_wakeEvent);
+}
+
+static void on_lvl_open(const char* path)
+{
+    // Release the budget held by a warmed file and count the hit.
+    EnterCriticalSection(&s_lock);
+    if (PrefetchJob* job = find_job(path)) {
+        if (!job->opened) {
+            job->opened = 1;
+            s_outstanding -= (job->bytes <= s_outstanding) ? job->bytes : s_outstanding;
+            s_statPredicted++;
+            if (job->state == kJobDone) s_statWarm++;
+        }
+    }
+    LeaveCriticalSection(&s_lock);
+
+    if (s_curCount < kMaxSeqFiles)
+        strncpy_s(s_cur[s_curCount++], kMaxPathLen, path, _TRUNCATE);
+
+    // Advance each candidate's cursor or drop it.
+    for (int i = 0; i < s_seqCount; ++i) {
+        if (s_cursor[i] < 0) continue;
+        int found = -1;
+        const int end = s_cursor[i] + kMatchWindow;
+        for (int j = s_cursor[i]; j < end && j < s_seqs[i].count; ++j) {
+            if (_stricmp(s_seqs[i].files[j], path) == 0) { found = j; break; }
+        }
+        s_cursor[i] = found >= 0 ? found + 1 : -1;
+    }
+
+    schedule_lookahead();
+}
+
+static HANDLE WINAPI hooked_CreateFileA(LPCSTR name, DWORD access, DWORD share,
+                                        LPSECURITY_ATTRIBUTES sa, DWORD disposition,
+                                        DWORD flags, HANDLE tmpl)
+{
+    HANDLE h = s_origCreateFileA(name, access, share, sa, disposition, flags, tmpl);
+
+    if (s_loading && h != INVALID_HANDLE_VALUE && GetCurrentThreadId() == s_mainThread
+        && is_lvl_path(name)) {
+        char full[kMaxPathLen];
+        const DWORD n = GetFullPathNameA(name, kMaxPathLen, full, nullptr);
+        on_lvl_open(n > 0 && n < (DWORD)kMaxPathLen ? full : name);
+    }
+    return h;
+}
+
+// =============================================================================
+// Manifest
+// =============================================================================
+
+static void load_manifest()
+{
+    FILE* f = nullptr;
+    if (fopen_s(&f, kManifestName, "r") != 0 || !f) return;
+
+    char line[kMaxPathLen + 32];
+    LvlSequence* seq = nullptr;
+    while (fgets(line, sizeof(line), f)) {
+        line[strcspn(line, "\r\n")] = 0;
+        if (!line[0] || line[0] == '#') continue;
+
+        int ms = 0, coldMs = 0, warmMs = 0;
+        unsigned use = 0;
+        if (sscanf_s(line, "seq %d %u %d %d", &ms, &use, &coldMs, &warmMs) >= 2) {
+            seq = s_seqCount < kMaxSeqs ? &s_seqs[s_seqCount++] : nullptr;
+            if (seq) {
+                seq->count      = 0;
+                seq->lastLoadMs = ms;
+                seq->coldLoadMs = coldMs;
+                seq->warmLoadMs = warmMs;
+                seq->lastUse    = use;
+                if (use > s_useClock) s_useClock = use;
+            }
+        } else if (strcmp(line, "end") == 0) {
+            seq = nullptr;
+        } else if (seq && seq->count < kMaxSeqFiles) {
+            strncpy_s(seq->files[seq->count++], kMaxPathLen, line, _TRUNCATE);
+        }
+    }
+    fclose(f);
+}
+
+static void save_manifest()
+{
+    FILE* f = nullptr;
+    if (fopen_s(&f, kManifestName, "w") != 0 || !f) return;
+
+    fprintf(f, "# BF2GameExt .lvl prefetch manifest -- generated, safe to delete\n");
+    for (int i = 0; i < s_seqCount; ++i) {
+        const LvlSequence& seq = s_seqs[i];
+        fprintf(f, "seq %d %u %d %d\n", seq.lastLoadMs, seq.lastUse, seq.coldLoadMs, seq.warmLoadMs);
+        for (int j = 0; j < seq.count; ++j) fprintf(f, "%s\n", seq.files[j]);
+        fprintf(f, "end\n");
+    }
+    fclose(f);
+}
+
+// =============================================================================
+// Load lifecycle
+// =============================================================================
+
+void lvl_prefetch_begin_load()
+{
+    if (!g_lvlPrefetchEnabled || s_loading) return;
+
+    s_loading       = true;
+    s_mainThread    = GetCurrentThreadId();
+    s_loadT0        = qpc_now();
+    s_curCount      = 0;
+    s_statPredicted = 0;
+    s_statWarm      = 0;
+
+    EnterCriticalSection(&s_lock);
+    s_statBytes = 0;
+    LeaveCriticalSection(&s_lock);
+
+    for (int i = 0; i < s_seqCount; ++i) s_cursor[i] = 0;
+    schedule_lookahead();
+}
+
+void lvl_prefetch_end_load()
+{
+    if (!g_lvlPrefetchEnabled || !s_loading) return;
+    s_loading = false;
+
+    LARGE_INTEGER freq;
+    QueryPerformanceFrequency(&freq);
+    const int loadMs = (int)((qpc_now() - s_loadT0) * 1000 / freq.QuadPart);
+
+    // Drop queued work; in-flight reads see opened and stop at the next chunk.
+    uint64_t warmedBytes;
+    EnterCriticalSection(&s_lock);
+    for (auto& j : s_jobs) {
+        j.opened = 1;
+        if (j.state != kJobReading) j.state = kJobFree;
+    }
+    s_outstanding = 0;
+    warmedBytes = s_statBytes;
+    LeaveCriticalSection(&s_lock);
+
+    if (s_curCount == 0) return;
+
+    // The still-matching sequence that got furthest is this load's sequence.
+    int match = -1;
+    for (int i = 0; i < s_seqCount; ++i)
+        if (s_cursor[i] >= 0 && (match < 0 || s_cursor[i] > s_cursor[match])) match = i;
+
+    int prevMs = -1;
+    LvlSequence* seq = nullptr;
+    if (match >= 0) {
+        seq = &s_seqs[match];
+        prevMs = seq->lastLoadMs;
+    } else {
+        if (s_seqCount < kMaxSeqs) {
+            seq = &s_seqs[s_seqCount++];
+        } else {
+            seq = &s_seqs[0];
+            for (int i = 1; i < s_seqCount; ++i)
+                if (s_seqs[i].lastUse < seq->lastUse) seq = &s_seqs[i];
+        }
+        seq->coldLoadMs = 0;
+        seq->warmLoadMs = 0;
+    }
+
+    seq->count = s_curCount;
+    for (int i = 0; i < s_curCount; ++i)
+        memcpy(seq->files[i], s_cur[i], kMaxPathLen);
+    seq->lastLoadMs = loadMs;
+    seq->lastUse    = ++s_useClock;
+    if (s_statWarm > 0) seq->warmLoadMs = loadMs;
+    else                seq->coldLoadMs = loadMs;
+    save_manifest();
+
+    if (g_log) {
+        if (prevMs > 0)
+            g_log("[Prefetch] load %dms (previous %dms, %+.1f%%) | %d .lvl opens, %d predicted, %d warm | %.1f MB prefetched\n",
+                  loadMs, prevMs, (loadMs - prevMs) * 100.0 / prevMs, s_curCount, s_statPredicted,
+                  s_statWarm, (double)warmedBytes / (1024.0 * 1024.0));
+        else
+            g_log("[Prefetch] load %dms | %d .lvl opens recorded (new sequence, nothing predicted)\n",
+                  loadMs, s_curCount);
+
+        // Cold = nothing warmed ahead of the engine, warm = prefetched opens
+        if (seq->coldLoadMs > 0 && seq->warmLoadMs > 0)
+            g_log("[Prefetch] sequence cold %dms / warm %dms (%+.1f%%)\n", seq->coldLoadMs, seq->warmLoadMs,
+                  (seq->warmLoadMs - seq->coldLoadMs) * 100.0 / seq->coldLoadMs);
+    }
+}
+
+// =============================================================================
+// Install / Uninstall
+// =============================================================================
+
+static void release_sync_objects()
+{
+    if (s_wakeEvent) { CloseHandle(s_wakeEvent); s_wakeEvent = nullptr; }
+    if (s_stopEvent) { CloseHandle(s_stopEvent); s_stopEvent = nullptr; }
+    DeleteCriticalSection(&s_lock);
+}
+
+void lvl_prefetch_install(uintptr_t /*exe_base*/)
+{
+    if (!g_lvlPrefetchEnabled) return;
+
+    g_log = get_gamelog();
+    InitializeCriticalSection(&s_lock);
+    load_manifest();
+
+    s_wakeEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+    s_stopEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    if (!s_wakeEvent || !s_stopEvent) {
+        if (g_log) g_log("[Prefetch] ERROR: CreateEvent failed (%lu)\n", GetLastError());
+        release_sync_objects();
+        g_lvlPrefetchEnabled = false;
+        return;
+    }
+
+    DetourTransactionBegin();
+    DetourUpdateThread(GetCurrentThread());
+    DetourAttach(&(PVOID&)s_origCreateFileA, hooked_CreateFileA);
+    LONG rc = DetourTransactionCommit();
+    if (rc != NO_ERROR) {
+        if (g_log) g_log("[Prefetch] ERROR: Detours commit failed (%ld)\n", rc);
+        release_sync_objects();
+        g_lvlPrefetchEnabled = false;
+        return;
+    }
+
+    s_thread = CreateThread(nullptr, 0, prefetch_thread, nullptr, 0, nullptr);
+
+    if (g_log) g_log("[Prefetch] Installed: %d learned sequences, lookahead %d, budget %d MB\n",
+                     s_seqCount, g_lvlPrefetchLookahead, g_lvlPrefetchBudgetMB);
+}
+
+void lvl_prefetch_uninstall()
+{
+    if (!g_lvlPrefetchEnabled) return;
+
+    s_loading = false;
+    if (s_thread) {
+        SetEvent(s_stopEvent);
+        WaitForSingleObject(s_thread, 2000);
+        CloseHandle(s_thread);
+        s_thread = nullptr;
+    }
+
+    DetourTransactionBegin();
+    DetourUpdateThread(GetCurrentThread());
+    DetourDetach(&(PVOID&)s_origCreateFileA, hooked_CreateFileA);
+    DetourTransactionCommit();
+
+    release_sync_objects();
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "pch.h"
+
+// =============================================================================
+// Learned .lvl read-ahead prefetcher
+// =============================================================================
+// A mission load opens a long, mostly deterministic sequence of .lvl files,
+// each read cold and synchronously on the main thread. This module records
+// the sequence of .lvl opens (CreateFileA, main thread) between the first
+// LoadDisplay activity and LoadDisplay::End, and keeps the most recent
+// sequences in BF2GameExt_prefetch.txt.
+//
+// On later loads the observed prefix is matched against the stored
+// sequences; while every matching sequence agrees on what comes next, a
+// background thread reads the next few files with FILE_FLAG_SEQUENTIAL_SCAN
+// so they are in the OS page cache by the time the engine opens them.
+// Outstanding warmed-but-unopened bytes are capped by a memory budget.
+//
+// Each load logs its duration next to the previous duration of the same
+// sequence, and how many opens were already warmed.  Each sequence also
+// keeps its last cold (nothing warmed) and warm load time; once it has
+// both, they are logged side by side.
+//
+// Gated on [LevelPrefetch] Enabled=1.
+
+extern bool g_lvlPrefetchEnabled;
+extern int  g_lvlPrefetchLookahead;  // files to stay ahead of the engine
+extern int  g_lvlPrefetchBudgetMB;   // max warmed bytes not yet opened
+
+// Idempotent — called from the LoadDisplay hooks on every slice.
+void lvl_prefetch_begin_load();
+
+// LoadDisplay::End — store the sequence and log the load comparison.
+void lvl_prefetch_end_load();
+
+void lvl_prefetch_install(uintptr_t exe_base);
+void lvl_prefetch_uninstall();
@@ -1,12 +1,13 @@
 #include "pch.h"
 #include "shared.hpp"
+#include "debug_commands/ext_perf.hpp"
 
 // =============================================================================
 // RenderScreen hook
 // =============================================================================
 // Coordinates are normalized 0-1 screen space, confirmed from BF1 Ghidra analysis.
 
-void __fastcall hooked_render_screen(void* ecx, void* edx)
+static void render_screen(void* ecx, void* edx)
 {
     // Suppress BF2's RandomBackdrop draw when BF1 mode is active.
     // LoadDisplay::RenderScreen (0x0067a1b0) ONLY draws the RandomBackdrop hash
@@ -41,7 +42,7 @@ void __fastcall hooked_render_screen(void* ecx, void* edx)
             *(uint32_t*)((uint8_t*)ecx + off + 0x14) &= ~0x100u;
     }
 
-    g_orig_render_screen(ecx, edx);
+    ext_perf_engine(kExtPerf_LoadRender, [&] { g_orig_render_screen(ecx, edx); });
 
     if (g_loadScreenCfg.bf1Enabled && ecx)
         *(uint32_t*)((uint8_t*)ecx + 0x14c0) = savedBackdropHash;
@@ -65,6 +66,7 @@ void __fastcall hooked_render_screen(void* ecx, void* edx)
             check("ZoomSelectorTextures", g_loadScreenCfg.zoomSelHashes[i]);
         for (int i = 0; i < g_loadScreenCfg.animCount; ++i)
             check("AnimatedTextures", g_loadScreenCfg.animHashes[i]);
+        check("AnimatedAtlas", g_loadScreenCfg.atlasHash);
         for (int pi = 0; pi < g_loadScreenCfg.planetCount; ++pi)
             check("PlanetLevel", g_loadScreenCfg.planets[pi].texHash);
     }
@@ -93,6 +95,25 @@ void __fastcall hooked_render_screen(void* ecx, void* edx)
         }
     }
 
+    // --- AnimatedAtlas: flipbook frames as UV sub-rects of one texture ---
+    if (g_loadScreenCfg.atlasHash && g_loadScreenCfg.atlasCount > 0 && g_loadScreenCfg.atlasFPS > 0.0f) {
+        const DWORD ms_per_frame = (DWORD)(1000.0f / g_loadScreenCfg.atlasFPS);
+        const int frame = (ms_per_frame > 0)
+                        ? (int)(GetTickCount() / ms_per_frame) % g_loadScreenCfg.atlasCount
+                        : 0;
+        const float du = 1.0f / (float)g_loadScreenCfg.atlasCols;
+        const float dv = 1.0f / (float)g_loadScreenCfg.atlasRows;
+        const float u0 = (float)(frame % g_loadScreenCfg.atlasCols) * du;
+        const float v0 = (float)(frame / g_loadScreenCfg.atlasCols) * dv;
+        const float ax = g_loadScreenCfg.atlasW > 0.0f ? g_loadScreenCfg.atlasX : 0.0f;
+        const float ay = g_loadScreenCfg.atlasW > 0.0f ? g_loadScreenCfg.atlasY : 0.0f;
+        const float aw = g_loadScreenCfg.atlasW > 0.0f ? g_loadScreenCfg.atlasW : 1.0f;
+        const float ah = g_loadScreenCfg.atlasH > 0.0f ? g_loadScreenCfg.atlasH : 1.0f;
+        g_prt(g_loadScreenCfg.atlasHash,
+              ax, ay, ax + aw, ay + ah, g_color_ptr, 0,
+              u0, v0, u0 + du, v0 + dv,  1,1,0,0);
+    }
+
     // --- BF1 zoom-sequence animation ---
     if (g_loadScreenCfg.planetCount > 0) {
         const int nLev = g_loadScreenCfg.planetCount;
@@ -264,3 +285,8 @@ void __fastcall hooked_render_screen(void* ecx, void* edx)
     if (prevHeap >= 0 && g_set_current_heap)
         g_set_current_heap(prevHeap);
 }
+
+void __fastcall hooked_render_screen(void* ecx, void* edx)
+{
+    ext_perf_call(kExtPerf_LoadRender, [&] { render_screen(ecx, edx); });
+}
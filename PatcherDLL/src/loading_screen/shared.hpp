@@ -4,6 +4,7 @@
 
 #include "loading_screen.hpp"
 #include "core/resolve.hpp"
+#include "util/pbl_hash.hpp"
 
 #include <cstring>
 
@@ -35,7 +36,6 @@ typedef void (__stdcall* fn_prt_t)(
 typedef int (__cdecl* fn_set_current_heap_t)(int heap);
 typedef void (__fastcall* fn_load_data_file_t)(void* ecx, void* edx, const char* lvlPath);
 typedef void* (__cdecl* fn_pbl_find_t)(void* table, uint32_t size, uint32_t hash);
-typedef uint32_t (__cdecl* fn_hash_string_t)(const char* str);
 
 typedef void (__fastcall* fn_load_config_t)  (void* ecx, void* edx, uint32_t* fh);
 typedef void (__fastcall* fn_render_screen_t)(void* ecx, void* edx);
@@ -68,7 +68,6 @@ inline int*                g_s_load_heap_ptr  = nullptr;
 
 inline fn_pbl_find_t       g_pbl_find        = nullptr;
 inline void*               g_tex_table       = nullptr;
-inline fn_hash_string_t    g_hash_string     = nullptr;
 
 // Hook trampolines
 inline fn_load_data_file_t g_orig_load_data_file = nullptr;
@@ -79,7 +78,6 @@ inline fn_set_all_on_t     g_orig_set_all_on     = nullptr;
 inline fn_load_update_t    g_orig_load_update    = nullptr;
 inline fn_load_render_t    g_orig_load_render    = nullptr;
 inline DWORD*              g_qpc_stamp           = nullptr;
-inline DWORD               g_lastRenderMs        = 0;
 
 // =============================================================================
 // Sound helper types
@@ -124,39 +122,44 @@ inline float anim_ease_out(float t)     { float u = 1.0f - t; return 1.0f - u *
 // Config DATA chunk hashes
 // =============================================================================
 
-inline constexpr uint32_t kHash_LoadDisplay          = 0x8689C861;
-inline constexpr uint32_t kHash_ScanLineTexture      = 0xe3dd2365;
-inline constexpr uint32_t kHash_ZoomSelectorTextures = 0x6ae7b95f;
-inline constexpr uint32_t kHash_AnimatedTextures     = 0xe83d35ac;
-inline constexpr uint32_t kHash_XTrackingSound       = 0x853656d1;
-inline constexpr uint32_t kHash_YTrackingSound       = 0x149267cc;
-inline constexpr uint32_t kHash_ZoomSound            = 0x8b73a019;
-inline constexpr uint32_t kHash_TransitionSound      = 0xd134f3a9;
-inline constexpr uint32_t kHash_BarSound             = 0x27bac391;
-inline constexpr uint32_t kHash_BarSoundInterval     = 0x18ed027c;
-inline constexpr uint32_t kHash_PlanetLevel          = 0xd7b37b83;
-inline constexpr uint32_t kHash_EnableBF1            = 0xd7436995;
-inline constexpr uint32_t kHash_Map                  = 0xdfa2efb1;
-inline constexpr uint32_t kHash_World                = 0x37a3e893;
+inline constexpr uint32_t kHash_LoadDisplay          = pbl_hash_ct("LoadDisplay");
+inline constexpr uint32_t kHash_ScanLineTexture      = pbl_hash_ct("ScanLineTexture");
+inline constexpr uint32_t kHash_ZoomSelectorTextures = pbl_hash_ct("ZoomSelectorTextures");
+inline constexpr uint32_t kHash_AnimatedTextures     = pbl_hash_ct("AnimatedTextures");
+inline constexpr uint32_t kHash_XTrackingSound       = pbl_hash_ct("XTrackingSound");
+inline constexpr uint32_t kHash_YTrackingSound       = pbl_hash_ct("YTrackingSound");
+inline constexpr uint32_t kHash_ZoomSound            = pbl_hash_ct("ZoomSound");
+inline constexpr uint32_t kHash_TransitionSound      = pbl_hash_ct("TransitionSound");
+inline constexpr uint32_t kHash_BarSound             = pbl_hash_ct("BarSound");
+inline constexpr uint32_t kHash_BarSoundInterval     = pbl_hash_ct("BarSoundInterval");
+inline constexpr uint32_t kHash_PlanetLevel          = pbl_hash_ct("PlanetLevel");
+inline constexpr uint32_t kHash_EnableBF1            = pbl_hash_ct("EnableBF1");
+inline constexpr uint32_t kHash_Map                  = pbl_hash_ct("Map");
+inline constexpr uint32_t kHash_World                = pbl_hash_ct("World");
 
 // Known but unimplemented / BF2-native params
-inline constexpr uint32_t kHash_TeamModel              = 0xd6c2b5f9;
-inline constexpr uint32_t kHash_TeamModelRotationSpeed = 0x26455a06;
-inline constexpr uint32_t kHash_ProgressBarTotalTime   = 0x31a6bc76;
+inline constexpr uint32_t kHash_TeamModel              = pbl_hash_ct("TeamModel");
+inline constexpr uint32_t kHash_TeamModelRotationSpeed = pbl_hash_ct("TeamModelRotationSpeed");
+inline constexpr uint32_t kHash_ProgressBarTotalTime   = pbl_hash_ct("ProgressBarTotalTime");
 
 // Sub-scope hashes
-inline constexpr uint32_t kHash_LoadingTextColorPallete = 0xa6fb2870;
+inline constexpr uint32_t kHash_LoadingTextColorPallete = pbl_hash_ct("LoadingTextColorPallete");
 
-// Platform sub-scope hashes (computed at runtime in install())
-inline uint32_t kHash_PC   = 0;
-inline uint32_t kHash_PS2  = 0;
-inline uint32_t kHash_XBOX = 0;
+// Platform sub-scope hashes
+inline constexpr uint32_t kHash_PC   = pbl_hash_ct("PC");
+inline constexpr uint32_t kHash_PS2  = pbl_hash_ct("PS2");
+inline constexpr uint32_t kHash_XBOX = pbl_hash_ct("XBOX");
 
-// Extension-only hashes (computed at runtime in install())
-inline uint32_t kHash_ZoomSelectorTileSize = 0;
-inline uint32_t kHash_LoadSoundLVL         = 0;
-inline uint32_t kHash_RemoveToolTips       = 0;
-inline uint32_t kHash_RemoveLoadingBar     = 0;
+// Extension-only hashes
+inline constexpr uint32_t kHash_ZoomSelectorTileSize = pbl_hash_ct("ZoomSelectorTileSize");
+inline constexpr uint32_t kHash_LoadSoundLVL         = pbl_hash_ct("LoadSoundLVL");
+inline constexpr uint32_t kHash_RemoveToolTips       = pbl_hash_ct("RemoveToolTips");
+inline constexpr uint32_t kHash_RemoveLoadingBar     = pbl_hash_ct("RemoveLoadingBar");
+inline constexpr uint32_t kHash_AnimatedAtlas        = pbl_hash_ct("AnimatedAtlas");
+
+// Spot checks against hashes taken from the engine
+static_assert(kHash_LoadDisplay == 0x8689C861);
+static_assert(kHash_PlanetLevel == 0xd7b37b83);
 
 // =============================================================================
 // PblConfig helpers
@@ -186,8 +189,7 @@ inline int pbl_get_int(const uint32_t* data_buf, int i) {
 }
 
 inline uint32_t hash_name(const char* name) {
-    if (!name || !*name) return 0u;
-    return g_hash_string ? g_hash_string(name) : 0u;
+    return pbl_hash_intern(name);
 }
 
 // =============================================================================
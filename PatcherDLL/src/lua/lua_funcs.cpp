@@ -3,6 +3,7 @@
 #include "lua_hooks.hpp"
 #include "core/resolve.hpp"
 #include "entity/flyer_carrier_fixes.hpp"
+#include "util/pbl_hash.hpp"
 #include <wininet.h>
 #pragma comment(lib, "wininet.lib")
 
@@ -667,14 +668,7 @@ static int lua_RemoveUnitClass(lua_State* L)
       // ODF name — walk g_ClassDefList to get the classDef pointer, then match by pointer.
       // Node layout: +0x04 = next, +0x0c = classDef ptr (null = end of list).
       // classDef+0x18 = integer name hash (NOT a char* — do not dereference as string).
-      //
-      // HashString: __thiscall, ECX = 8-byte stack buffer, stack arg = name string.
-      // buf[0] is the resulting integer hash.
-      typedef void* (__thiscall* HashString_t)(void* buf, const char* name);
-      const auto fn_HashString = (HashString_t)res(game_addrs::modtools::hash_string_thiscall);
-      alignas(4) int hashBuf[2] = {};
-      fn_HashString(hashBuf, unitClass);
-      const int targetHash = hashBuf[0];
+      const int targetHash = (int)pbl_hash(unitClass);
 
       uintptr_t node = *(uintptr_t*)res(game_addrs::modtools::class_def_list);
       void* classDef = nullptr;
@@ -965,13 +959,7 @@ static int lua_OnCEVName(lua_State* L)
    const char* name = g_lua.tolstring(L, 2, nullptr);
    if (!name) { g_lua.pushnil(L); return 1; }
 
-   const uintptr_t base = (uintptr_t)GetModuleHandleW(nullptr);
-   auto res = [=](uintptr_t a) -> uintptr_t { return a - kUnrelocatedBase + base; };
-   typedef void* (__thiscall* HashString_t)(void* buf, const char* s);
-   const auto fn_Hash = (HashString_t)res(game_addrs::modtools::hash_string_thiscall);
-   alignas(4) int hashBuf[2] = {};
-   fn_Hash(hashBuf, name);
-   const uint32_t nameHash = (uint32_t)hashBuf[0];
+   const uint32_t nameHash = pbl_hash(name);
 
    for (int i = 0; i < CEV_MAX_CBS; i++) {
       if (g_cevCallbacks[i].regKey == 0) {
@@ -1017,15 +1005,11 @@ static int lua_OnCEVClass(lua_State* L)
 
    const uintptr_t base = (uintptr_t)GetModuleHandleW(nullptr);
    auto res = [=](uintptr_t a) -> uintptr_t { return a - kUnrelocatedBase + base; };
-   typedef void* (__thiscall* HashString_t)(void* buf, const char* s);
-   const auto fn_Hash = (HashString_t)res(game_addrs::modtools::hash_string_thiscall);
    const auto fn_GameLog = (GameLog_t)res(game_addrs::modtools::game_log);
 
    // Hash the class name and walk the EntityClass global registry to resolve it
    // to a live EntityClass pointer. Registration fails if the class isn't loaded.
-   alignas(4) int hashBuf[2] = {};
-   fn_Hash(hashBuf, cls);
-   const uint32_t targetHash = (uint32_t)hashBuf[0];
+   const uint32_t targetHash = pbl_hash(cls);
 
    void* classPtr = nullptr;
    uintptr_t node = *(uintptr_t*)res(game_addrs::modtools::class_def_list);
@@ -9,15 +9,26 @@
 #include "entity/soldier_fp_animation_override.hpp"
 #include "entity/flyer_boost_animation.hpp"
 #include "entity/cloth_collision_fix.hpp"
+#include "entity/cloth_lod.hpp"
+#include "entity/cloth_capture.hpp"
 #include "weapon/disguise_model_override.hpp"
 #include "weapon/grappling_hook.hpp"
 #include "debug_commands/command_registry.hpp"
 #include "shell/gc_visual_limits.hpp"
 #include "entity/anim_bank_append.hpp"
+#include "entity/anim_lookup_cache.hpp"
+#include "entity/entity_sidecar.hpp"
+#include "render/red_camera.hpp"
+#include "render/frame_clock.hpp"
+#include "render/debug_draw.hpp"
 #include "weapon/shield_channel_fix.hpp"
 #include "controller/controller_support.hpp"
 #include "controller/controller_rumble.hpp"
 #include "controller/aim_assist.hpp"
+#include "controller/xinput_input.hpp"
+#include "controller/player_controller_update.hpp"
+#include "util/pbl_hash.hpp"
+#include "memory/red_heap_profiler.hpp"
 
 #include <detours.h>
 
@@ -254,6 +265,13 @@ static void __cdecl hooked_init_state()
    fp_anim_bank_reset();
    flyer_boost_anim_reset();
    disguise_ext_reset();
+   anim_bank_append_reset();
+   anim_cache_reset();
+   cloth_lod_reset();
+   cloth_capture_reset();
+   cloth_collision_fix_reset();
+   pbl_hash_intern_reset();
+   sidecar_reset();
 
    // Register debug console commands (engine is fully initialized now)
    DebugCommandRegistry::lateInit();
@@ -325,9 +343,14 @@ void lua_hooks_install(uintptr_t exe_base)
    // Resolve Weapon::ZoomFirstPerson for the barrel fire origin hook
    fn_ZoomFirstPerson = (ZoomFirstPerson_t)resolve(exe_base, weapon_zoom_first_person);
 
+   red_camera_install(exe_base);
+   player_controller_update_install(exe_base);
+   frame_clock_install(exe_base);
+   debug_draw_install(exe_base);
    loading_screen_install(exe_base);
    entity_carrier_fixes_install(exe_base);
    prone_system_install(exe_base);
+   anim_cache_install(exe_base);
    fp_anim_bank_install(exe_base);
    flyer_boost_anim_install(exe_base);
    cloth_collision_fix_install(exe_base);
@@ -338,6 +361,9 @@ void lua_hooks_install(uintptr_t exe_base)
    anim_bank_append_install(exe_base);
    shield_channel_fix_install(exe_base);
    aim_assist_install(exe_base);
+   xinput_input_install(exe_base);
+   red_heap_profiler_install(exe_base);
+   sidecar_install(exe_base);
 
    // Patch WeaponCannon vtable: replace OverrideAimer with our hook.
    // Validate that the slot currently points to the vanilla implementation.
@@ -356,9 +382,12 @@ void lua_hooks_install(uintptr_t exe_base)
 
 void lua_hooks_uninstall()
 {
+   player_controller_update_uninstall();
+   frame_clock_uninstall();
    loading_screen_uninstall();
    entity_carrier_fixes_uninstall();
    prone_system_uninstall();
+   anim_cache_uninstall();
    fp_anim_bank_uninstall();
    flyer_boost_anim_uninstall();
    cloth_collision_fix_uninstall();
@@ -369,6 +398,9 @@ void lua_hooks_uninstall()
    anim_bank_append_uninstall();
    shield_channel_fix_uninstall();
    aim_assist_uninstall();
+   xinput_input_uninstall();
+   red_heap_profiler_uninstall();
+   sidecar_uninstall();
 
    DetourTransactionBegin();
    DetourUpdateThread(GetCurrentThread());
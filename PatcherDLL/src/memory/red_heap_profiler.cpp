@@ -0,0 +1,602 @@
+#include "pch.h"
+#include "red_heap_profiler.hpp"
+#include "core/game_addrs.hpp"
+#include "core/resolve.hpp"
+
+#include <detours.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+bool g_heapProfilerEnabled = false;
+
+// =============================================================================
+// Limits / layout
+// =============================================================================
+
+static constexpr int      kMaxHeaps      = 8;          // heap index slots
+static constexpr int      kMaxSites      = 512;        // power of two
+static constexpr int      kMaxHeapStructs = 8;
+static constexpr int      kTopSites      = 12;
+static constexpr DWORD    kSampleMs      = 250;
+static constexpr int      kHistBuckets   = 16;         // <=16 B, <=32 B, ... >=256 KB
+static constexpr int      kHeadScan      = 0x40;       // heap struct bytes searched for the free-list head
+static constexpr uint32_t kResolveTries  = 64;         // samples spent looking for it
+static constexpr uint32_t kMaxWalk       = 1u << 20;   // list nodes followed before giving up
+static constexpr uint32_t kSizeVotes     = 32;         // consistent frees before the size field is trusted
+static constexpr uint32_t kMaxHeaderSlack = 64;        // free size - allocated size field
+
+// Free-list node: [0] next, [1] size (_RedGetHeapFree reads [node+4])
+static constexpr int kFreeNode_Next = 0;
+static constexpr int kFreeNode_Size = 1;
+
+// Allocated-list node: [0] prev, [1] next (FUN_007e2e80).  The size lives
+// further in and is found at runtime — see vote_alloc_size.
+static constexpr int kAllocNode_Next   = 1;
+static constexpr int kAllocHdrDwords   = 6;
+
+static const char* const kCsvName   = "BF2GameExt_heap.csv";
+
+// =============================================================================
+// Counters
+// =============================================================================
+
+// Internal caller of the list functions
+struct CallSite {
+   uintptr_t ret;                // engine return address, 0 = free slot
+   uint32_t  inserts;            // free-list inserts
+   uint32_t  unlinks;            // allocated-list unlinks
+   uint64_t  bytes;              // bytes handed to the free list
+};
+
+struct HeapStruct {
+   uintptr_t heap;               // EDI at free-list insert
+   uint32_t  inserts;
+   uint64_t  freedBytes;
+   uint32_t  freedHist[kHistBuckets];
+   uintptr_t allocHead;          // list head of the unlink paired with an insert here
+   int       index;              // heap index, -1 until resolve_heap_struct matches it
+   int       freeHeadOff;        // byte offset of the free-list head
+   uint32_t  resolveTries;
+};
+
+// Last allocated-list unlink; the free path follows it with the insert of
+// the same block, which pairs the two lists and sizes the block
+struct PendingUnlink {
+   uintptr_t block;              // 0 = none
+   uintptr_t head;
+   uint32_t  hdr[kAllocHdrDwords];
+};
+
+// One walk of a free or allocated list
+struct ListShape {
+   int      blocks;
+   int64_t  bytes;               // -1 when sizes aren't known (allocated list, size field unresolved)
+   uint32_t largest;
+   bool     complete;            // reached the end without faulting or hitting kMaxWalk
+};
+
+static CallSite     s_sites[kMaxSites] = {};
+static uint32_t     s_siteOverflow = 0;
+static HeapStruct   s_heapStructs[kMaxHeapStructs] = {};
+static uint32_t     s_freeInserts  = 0;
+static uint32_t     s_allocUnlinks = 0;
+static uint32_t     s_heapSwitches = 0;
+static PendingUnlink s_unlink    = {};
+
+// Allocated block size = hdr[s_allocSizeIdx] + s_allocSizeDelta, once voted in
+static int          s_allocSizeIdx   = -1;
+static int32_t      s_allocSizeDelta = 0;
+static int          s_voteIdx        = -1;
+static int32_t      s_voteDelta      = 0;
+static uint32_t     s_votes          = 0;
+
+static CRITICAL_SECTION s_lock;
+static FILE*        s_csv        = nullptr;
+static DWORD        s_t0         = 0;
+static DWORD        s_lastSample = 0;
+static uintptr_t    s_exeBase    = 0;
+static GameLog_t    g_log        = nullptr;
+
+static int*         s_runtimeHeapIdx = nullptr;
+static int*         s_loadHeapIdx    = nullptr;
+
+// =============================================================================
+// Engine functions
+// =============================================================================
+
+typedef int   (__cdecl* fn_SetCurrentHeap_t)(int heapIndex);
+typedef int   (__cdecl* fn_GetHeapFree_t)(int heapIndex);
+
+static fn_SetCurrentHeap_t s_origSetCurrentHeap = nullptr;
+static fn_GetHeapFree_t    s_getHeapFree        = nullptr;
+static void*               s_origFreeListInsert = nullptr;
+static void*               s_origAllocUnlink    = nullptr;
+
+// =============================================================================
+// Tables
+// =============================================================================
+
+static inline uint32_t ptr_hash(uintptr_t p, int bits)
+{
+   return ((uint32_t)p * 0x9E3779B1u) >> (32 - bits);
+}
+
+static int size_bucket(uint32_t size)
+{
+   int b = 0;
+   for (uint32_t s = size ? (size - 1) >> 4 : 0; s && b < kHistBuckets - 1; s >>= 1) b++;
+   return b;
+}
+
+static uint16_t find_site(uintptr_t ret)
+{
+   uint32_t i = ptr_hash(ret, 9) & (kMaxSites - 1);
+   for (int probe = 0; probe < kMaxSites; probe++) {
+      CallSite& s = s_sites[i];
+      if (s.ret == ret) return (uint16_t)i;
+      if (!s.ret) {
+         s.ret = ret;
+         return (uint16_t)i;
+      }
+      i = (i + 1) & (kMaxSites - 1);
+   }
+   s_siteOverflow++;
+   return 0xFFFF;
+}
+
+static inline uintptr_t unrelocate(uintptr_t addr)
+{
+   return addr - s_exeBase + kUnrelocatedBase;
+}
+
+// =============================================================================
+// Sampling
+// =============================================================================
+
+// -1 if the heap is gone (TempLoadHeap after ReleaseTempHeap faults on 0xDE)
+static int heap_free_bytes(int heap)
+{
+   if (!s_getHeapFree) return -1;
+   __try {
+      return s_getHeapFree(heap);
+   } __except (EXCEPTION_EXECUTE_HANDLER) {
+      return -1;
+   }
+}
+
+static bool read_dword(uintptr_t addr, uintptr_t* out)
+{
+   __try {
+      *out = *(const uintptr_t*)addr;
+      return true;
+   } __except (EXCEPTION_EXECUTE_HANDLER) {
+      return false;
+   }
+}
+
+// hist may be null
+static ListShape walk_free_list(uintptr_t first, uint32_t* hist)
+{
+   ListShape shape = { 0, 0, 0, false };
+   __try {
+      for (const uint32_t* node = (const uint32_t*)first; node;
+           node = (const uint32_t*)(uintptr_t)node[kFreeNode_Next]) {
+         if ((uint32_t)shape.blocks == kMaxWalk || (shape.blocks && (uintptr_t)node == first)) return shape;
+         const uint32_t size = node[kFreeNode_Size];
+         shape.blocks++;
+         shape.bytes += size;
+         if (size > shape.largest) shape.largest = size;
+         if (hist) hist[size_bucket(size)]++;
+      }
+      shape.complete = true;
+   } __except (EXCEPTION_EXECUTE_HANDLER) {
+      shape.complete = false;
+   }
+   return shape;
+}
+
+// head = the list-head pointer FUN_007e2e80 is given; hist may be null
+static ListShape walk_alloc_list(uintptr_t head, uint32_t* hist)
+{
+   ListShape shape = { 0, s_allocSizeIdx >= 0 ? 0 : -1, 0, false };
+   __try {
+      const uintptr_t first = *(const uintptr_t*)head;
+      for (const uint32_t* node = (const uint32_t*)first; node;
+           node = (const uint32_t*)(uintptr_t)node[kAllocNode_Next]) {
+         if ((uint32_t)shape.blocks == kMaxWalk || (shape.blocks && (uintptr_t)node == first)) return shape;
+         shape.blocks++;
+         if (s_allocSizeIdx < 0) continue;
+         const uint32_t size = node[s_allocSizeIdx] + s_allocSizeDelta;
+         shape.bytes += size;
+         if (size > shape.largest) shape.largest = size;
+         if (hist) hist[size_bucket(size)]++;
+      }
+      shape.complete = true;
+   } __except (EXCEPTION_EXECUTE_HANDLER) {
+      shape.complete = false;
+   }
+   return shape;
+}
+
+// The heap struct layout isn't mapped, so the free-list head is found by
+// matching: the first dword whose list sums to what _RedGetHeapFree reports
+// for a live heap is the head, and that heap is the struct's index.  Structs
+// that never match report no shape.  Caller locks.
+static void resolve_heap_struct(HeapStruct& hs, int runtime, int load)
+{
+   if (hs.index >= 0 || hs.resolveTries >= kResolveTries) return;
+   hs.resolveTries++;
+
+   const int heaps[2]     = { runtime, load != runtime ? load : -1 };
+   const int freeBytes[2] = { heap_free_bytes(heaps[0]), heaps[1] >= 0 ? heap_free_bytes(heaps[1]) : -1 };
+
+   for (int off = 0; off < kHeadScan; off += 4) {
+      uintptr_t first;
+      if (!read_dword(hs.heap + off, &first) || !first) continue;
+
+      ListShape shape = walk_free_list(first, nullptr);
+      if (!shape.complete) continue;
+
+      for (int h = 0; h < 2; h++) {
+         if (heaps[h] < 0 || freeBytes[h] <= 0 || shape.bytes != freeBytes[h]) continue;
+
+         for (int i = 0; i < kMaxHeapStructs; i++)
+            if (s_heapStructs[i].index == heaps[h]) s_heapStructs[i].index = -1;
+         hs.index       = heaps[h];
+         hs.freeHeadOff = off;
+         if (g_log) g_log("[HeapProf] Heap struct %08x is heap %d, free-list head at +0x%x\n",
+                          (unsigned)hs.heap, hs.index, off);
+         return;
+      }
+   }
+}
+
+static HeapStruct* heap_struct_for(int heap)
+{
+   for (int i = 0; i < kMaxHeapStructs && s_heapStructs[i].heap; i++)
+      if (s_heapStructs[i].index == heap) return &s_heapStructs[i];
+   return nullptr;
+}
+
+// Caller locks; histograms may be null
+static void heap_shape(int heap, ListShape* freeList, ListShape* allocList,
+                       uint32_t* freeHist, uint32_t* liveHist)
+{
+   *freeList  = { -1, -1, 0, false };
+   *allocList = { -1, -1, 0, false };
+
+   HeapStruct* hs = heap_struct_for(heap);
+   if (!hs) return;
+
+   uintptr_t first;
+   if (read_dword(hs->heap + hs->freeHeadOff, &first)) *freeList = walk_free_list(first, freeHist);
+   if (hs->allocHead) *allocList = walk_alloc_list(hs->allocHead, liveHist);
+}
+
+static void sample_heap(DWORD ms, int heap)
+{
+   if (heap < 0 || heap >= kMaxHeaps) return;
+
+   ListShape fl, al;
+   heap_shape(heap, &fl, &al, nullptr, nullptr);
+   fprintf(s_csv, "%lu,%d,%d,%lld,%d,%d,%lld,%u,%u,%u\n",
+           ms, heap, heap_free_bytes(heap),
+           al.complete ? (long long)al.bytes : -1LL, al.complete ? al.blocks : -1,
+           fl.complete ? fl.blocks : -1, fl.complete ? (long long)fl.largest : -1LL,
+           s_heapSwitches, s_freeInserts, s_allocUnlinks);
+}
+
+// Outside the allocator only — _RedGetHeapFree walks the free list
+static void maybe_sample()
+{
+   DWORD now = GetTickCount();
+   if (now - s_lastSample < kSampleMs || !s_csv) return;
+   s_lastSample = now;
+
+   EnterCriticalSection(&s_lock);
+   const DWORD ms = now - s_t0;
+   const int runtime = s_runtimeHeapIdx ? *s_runtimeHeapIdx : -1;
+   const int load    = s_loadHeapIdx ? *s_loadHeapIdx : -1;
+   for (int i = 0; i < kMaxHeapStructs && s_heapStructs[i].heap; i++)
+      resolve_heap_struct(s_heapStructs[i], runtime, load);
+   sample_heap(ms, runtime);
+   if (load != runtime) sample_heap(ms, load);
+   fflush(s_csv);
+   LeaveCriticalSection(&s_lock);
+}
+
+// =============================================================================
+// Hooks
+// =============================================================================
+
+static int __cdecl hooked_SetCurrentHeap(int heapIndex)
+{
+   int prev = s_origSetCurrentHeap(heapIndex);
+   s_heapSwitches++;
+   maybe_sample();
+   return prev;
+}
+
+// The allocated header keeps the size somewhere past prev / next; by the
+// time the block reaches the free list it sits in [1].  Each paired free
+// votes for the header dword (and fixed header difference) that matches,
+// and a run of kSizeVotes agreeing frees settles it.  Caller locks.
+static void vote_alloc_size(const uint32_t* hdr, uint32_t freeSize)
+{
+   if (s_allocSizeIdx >= 0 || !freeSize) return;
+
+   for (int k = 2; k < kAllocHdrDwords; k++) {
+      if (!hdr[k] || hdr[k] > freeSize || freeSize - hdr[k] > kMaxHeaderSlack) continue;
+
+      const int32_t delta = (int32_t)(freeSize - hdr[k]);
+      if (k == s_voteIdx && delta == s_voteDelta) {
+         if (++s_votes >= kSizeVotes) {
+            s_allocSizeIdx   = k;
+            s_allocSizeDelta = delta;
+            if (g_log) g_log("[HeapProf] Allocated block size is header dword %d %+d\n", k, delta);
+         }
+      } else {
+         s_voteIdx   = k;
+         s_voteDelta = delta;
+         s_votes     = 1;
+      }
+      return;
+   }
+   s_votes = 0;
+}
+
+static uint32_t read_free_size(void* block)
+{
+   __try {
+      return ((const uint32_t*)block)[kFreeNode_Size];
+   } __except (EXCEPTION_EXECUTE_HANDLER) {
+      return 0;
+   }
+}
+
+static void snapshot_header(void* block, uint32_t* hdr)
+{
+   __try {
+      memcpy(hdr, block, kAllocHdrDwords * sizeof(uint32_t));
+   } __except (EXCEPTION_EXECUTE_HANDLER) {
+      memset(hdr, 0, kAllocHdrDwords * sizeof(uint32_t));
+   }
+}
+
+// List traffic is charged to the internal caller.  The size is read on
+// entry, before the block coalesces with its neighbours.
+static void __cdecl on_free_list_insert(uintptr_t ret, void* block, uintptr_t heap)
+{
+   const uint32_t size = read_free_size(block);
+
+   EnterCriticalSection(&s_lock);
+   s_freeInserts++;
+   uint16_t site = find_site(ret);
+   if (site != 0xFFFF) {
+      s_sites[site].inserts++;
+      s_sites[site].bytes += size;
+   }
+
+   for (int i = 0; i < kMaxHeapStructs; i++) {
+      HeapStruct& hs = s_heapStructs[i];
+      if (!hs.heap) {
+         hs.heap  = heap;
+         hs.index = -1;
+      }
+      if (hs.heap == heap) {
+         hs.inserts++;
+         hs.freedBytes += size;
+         hs.freedHist[size_bucket(size)]++;
+         if (s_unlink.block == (uintptr_t)block) {
+            hs.allocHead = s_unlink.head;
+            vote_alloc_size(s_unlink.hdr, size);
+         }
+         break;
+      }
+   }
+   s_unlink.block = 0;
+   LeaveCriticalSection(&s_lock);
+}
+
+static void __cdecl on_alloc_list_unlink(uintptr_t ret, void* block, uintptr_t head)
+{
+   EnterCriticalSection(&s_lock);
+   s_allocUnlinks++;
+   uint16_t site = find_site(ret);
+   if (site != 0xFFFF) s_sites[site].unlinks++;
+
+   s_unlink.block = (uintptr_t)block;
+   s_unlink.head  = head;
+   snapshot_header(block, s_unlink.hdr);
+   LeaveCriticalSection(&s_lock);
+}
+
+// FUN_007e2e00: EDI = heap struct, [esp+4] = block header
+static __declspec(naked) void hooked_FreeListInsert()
+{
+   __asm {
+      pushad
+      push edi                          // heap
+      push dword ptr [esp + 0x28]       // block header
+      push dword ptr [esp + 0x28]       // return address
+      call on_free_list_insert
+      add  esp, 12
+      popad
+      jmp  dword ptr [s_origFreeListInsert]
+   }
+}
+
+// FUN_007e2e80: EAX = block header, [esp+4] = list head
+static __declspec(naked) void hooked_AllocListUnlink()
+{
+   __asm {
+      pushad
+      push dword ptr [esp + 0x24]       // list head
+      push eax                          // block header
+      push dword ptr [esp + 0x28]       // return address
+      call on_alloc_list_unlink
+      add  esp, 12
+      popad
+      jmp  dword ptr [s_origAllocUnlink]
+   }
+}
+
+// =============================================================================
+// Report
+// =============================================================================
+
+static int compare_site_traffic(const void* a, const void* b)
+{
+   const CallSite& sa = s_sites[*(const int*)a];
+   const CallSite& sb = s_sites[*(const int*)b];
+   uint32_t ta = sa.inserts + sa.unlinks, tb = sb.inserts + sb.unlinks;
+   return (ta < tb) - (ta > tb);
+}
+
+// Bucket counts, one per power of two from 16 B
+static void log_hist(const char* label, const uint32_t* hist)
+{
+   char line[256];
+   int n = sprintf_s(line, sizeof(line), "[HeapStats]   %-11s:", label);
+   for (int b = 0; b < kHistBuckets && n > 0; b++)
+      n += sprintf_s(line + n, sizeof(line) - n, " %u", hist[b]);
+   g_log("%s  (<=16 B .. >=256 KB)\n", line);
+}
+
+void red_heap_profiler_report(bool reset)
+{
+   if (!g_log) return;
+   if (!g_heapProfilerEnabled) {
+      g_log("[HeapStats] Profiler is off — set [Profiling] HeapProfiler=1\n");
+      return;
+   }
+
+   EnterCriticalSection(&s_lock);
+
+   const int runtime = s_runtimeHeapIdx ? *s_runtimeHeapIdx : -1;
+   const int load    = s_loadHeapIdx ? *s_loadHeapIdx : -1;
+
+   g_log("[HeapStats] %u heap switches, %u free-list inserts, %u allocated-list unlinks\n",
+         s_heapSwitches, s_freeInserts, s_allocUnlinks);
+
+   for (int i = 0; i < kMaxHeaps; i++) {
+      if (i != runtime && i != load) continue;
+      int freeBytes = heap_free_bytes(i);
+      g_log("[HeapStats] heap %d %-12s free %d KB\n",
+            i, i == runtime ? "RunTimeHeap" : "TempLoadHeap", freeBytes >= 0 ? freeBytes / 1024 : -1);
+
+      uint32_t freeHist[kHistBuckets] = {}, liveHist[kHistBuckets] = {};
+      ListShape fl, al;
+      heap_shape(i, &fl, &al, freeHist, liveHist);
+
+      if (!fl.complete) {
+         g_log("[HeapStats]   free list not resolved (no heap struct matched _RedGetHeapFree yet)\n");
+      } else {
+         g_log("[HeapStats]   free list %d blocks, largest %u KB\n", fl.blocks, fl.largest / 1024);
+         log_hist("free blocks", freeHist);
+      }
+
+      if (!al.complete) {
+         g_log("[HeapStats]   allocated list not seen yet (no paired free)\n");
+      } else if (al.bytes < 0) {
+         g_log("[HeapStats]   live %d blocks (size field not settled, %u/%u votes)\n",
+               al.blocks, s_votes, kSizeVotes);
+      } else {
+         g_log("[HeapStats]   live %lld KB in %d blocks, largest %u KB\n",
+               al.bytes / 1024, al.blocks, al.largest / 1024);
+         log_hist("live blocks", liveHist);
+      }
+   }
+
+   for (int i = 0; i < kMaxHeapStructs && s_heapStructs[i].heap; i++) {
+      const HeapStruct& hs = s_heapStructs[i];
+      g_log("[HeapStats] heap struct %08x (index %d): %u free-list inserts, %llu KB freed\n",
+            (unsigned)hs.heap, hs.index, hs.inserts, (unsigned long long)(hs.freedBytes / 1024));
+      log_hist("freed", hs.freedHist);
+   }
+
+   static int order[kMaxSites];
+   int count = 0;
+   for (int i = 0; i < kMaxSites; i++)
+      if (s_sites[i].ret) order[count++] = i;
+   qsort(order, count, sizeof(int), compare_site_traffic);
+
+   for (int k = 0; k < count && k < kTopSites; k++) {
+      const CallSite& s = s_sites[order[k]];
+      g_log("[HeapStats]   %08x  %u inserts (%llu KB) %u unlinks\n",
+            (unsigned)unrelocate(s.ret), s.inserts, (unsigned long long)(s.bytes / 1024), s.unlinks);
+   }
+   if (s_siteOverflow)
+      g_log("[HeapStats] %u call sites dropped\n", s_siteOverflow);
+
+   if (reset) {
+      memset(s_sites, 0, sizeof(s_sites));
+      s_siteOverflow = 0;
+      for (int i = 0; i < kMaxHeapStructs; i++) {
+         HeapStruct& hs = s_heapStructs[i];
+         hs.inserts    = 0;
+         hs.freedBytes = 0;
+         memset(hs.freedHist, 0, sizeof(hs.freedHist));
+      }
+      s_freeInserts = s_allocUnlinks = s_heapSwitches = 0;
+      g_log("[HeapStats] Reset\n");
+   }
+
+   LeaveCriticalSection(&s_lock);
+}
+
+// =============================================================================
+// Install / Uninstall
+// =============================================================================
+
+void red_heap_profiler_install(uintptr_t exe_base)
+{
+   using namespace game_addrs::modtools;
+
+   if (!g_heapProfilerEnabled) return;
+
+   g_log     = get_gamelog();
+   s_exeBase = exe_base;
+   InitializeCriticalSection(&s_lock);
+
+   s_runtimeHeapIdx     = (int*)resolve(exe_base, runtime_heap_global);
+   s_loadHeapIdx        = (int*)resolve(exe_base, s_loadheap_global);
+   s_getHeapFree        = (fn_GetHeapFree_t)resolve(exe_base, red_get_heap_free);
+   s_origSetCurrentHeap = (fn_SetCurrentHeap_t)resolve(exe_base, red_set_current_heap);
+   s_origFreeListInsert = resolve(exe_base, red_free_list_insert);
+   s_origAllocUnlink    = resolve(exe_base, red_alloc_list_unlink);
+
+   if (fopen_s(&s_csv, kCsvName, "w") != 0 || !s_csv) s_csv = nullptr;
+   if (s_csv)
+      fprintf(s_csv, "ms,heap,free_bytes,live_bytes,live_blocks,free_blocks,largest_free,"
+                     "heap_switches,free_list_inserts,alloc_list_unlinks\n");
+   s_t0 = GetTickCount();
+
+   DetourTransactionBegin();
+   DetourUpdateThread(GetCurrentThread());
+   DetourAttach(&(PVOID&)s_origSetCurrentHeap, hooked_SetCurrentHeap);
+   DetourAttach(&(PVOID&)s_origFreeListInsert, hooked_FreeListInsert);
+   DetourAttach(&(PVOID&)s_origAllocUnlink,    hooked_AllocListUnlink);
+   LONG rc = DetourTransactionCommit();
+
+   if (g_log) g_log("[HeapProf] Installed (commit=%ld)\n", rc);
+}
+
+void red_heap_profiler_uninstall()
+{
+   if (!g_heapProfilerEnabled) return;
+
+   DetourTransactionBegin();
+   DetourUpdateThread(GetCurrentThread());
+   if (s_origSetCurrentHeap) DetourDetach(&(PVOID&)s_origSetCurrentHeap, hooked_SetCurrentHeap);
+   if (s_origFreeListInsert) DetourDetach(&(PVOID&)s_origFreeListInsert, hooked_FreeListInsert);
+   if (s_origAllocUnlink)    DetourDetach(&(PVOID&)s_origAllocUnlink,    hooked_AllocListUnlink);
+   DetourTransactionCommit();
+
+   if (s_csv) {
+      fclose(s_csv);
+      s_csv = nullptr;
+   }
+   DeleteCriticalSection(&s_lock);
+}
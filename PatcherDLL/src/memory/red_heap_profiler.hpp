@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stdint.h>
+
+// =============================================================================
+// RedHeap allocation profiler
+//
+// Watches the mapped RedHeap entry points in docs/RedHeapSystem.md:
+//
+//   FUN_007e2e00 (free-list insert) / FUN_007e2e80 (allocated-list unlink)
+//       — list traffic and freed bytes per engine caller and per heap
+//       struct.  Register-arg functions, hooked through naked thunks.
+//   _RedSetCurrentHeap — heap switches; also the sampling point, since it
+//       is never called from inside the allocator.
+//
+// Every 250 ms a row per live heap (RunTimeHeap, TempLoadHeap) is appended
+// to BF2GameExt_heap.csv: _RedGetHeapFree, live bytes / blocks, free-list
+// length, largest free block and the running switch / list counters.
+// "HeapStats" in the ~ console writes the full report, with live, free and
+// freed size histograms, to BF2GameExt.log ("HeapStats reset" clears the
+// counters and call sites).
+//
+// The heap struct and allocated header layouts aren't mapped, so the two
+// fields the walks need are found at runtime: the free-list head is the
+// struct dword whose list sums to _RedGetHeapFree, and the allocated size
+// is the header dword that matches the free-list size of the same block
+// across an unlink / insert pair.  Until then those columns read -1.
+//
+// Gated on [Profiling] HeapProfiler=1; nothing is hooked when it is off.
+// =============================================================================
+
+extern bool g_heapProfilerEnabled;
+
+void red_heap_profiler_install(uintptr_t exe_base);
+void red_heap_profiler_uninstall();
+
+// Log the report; reset = clear freed-size histograms and call sites afterwards
+void red_heap_profiler_report(bool reset);
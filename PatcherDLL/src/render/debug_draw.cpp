@@ -0,0 +1,204 @@
+#include "pch.h"
+#include "debug_draw.hpp"
+#include "red_camera.hpp"
+#include "core/resolve.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdarg>
+#include <cstring>
+
+// ---------------------------------------------------------------------------
+// Limits
+// ---------------------------------------------------------------------------
+
+static constexpr int   kMaxLines    = 8192;
+static constexpr int   kMaxLabels   = 256;
+static constexpr int   kLabelLen    = 48;
+static constexpr float kMaxDistance = 250.0f;
+static constexpr float kLabelRadius = 1.0f;
+
+// Unit circle, kCircleSegs + 1 points so segment i is [i, i + 1]
+static constexpr int kCircleSegs = 64;
+
+// ---------------------------------------------------------------------------
+// Engine draw functions
+// ---------------------------------------------------------------------------
+
+using DrawLine3D_t = void(__cdecl*)(float, float, float, float, float, float, uint32_t);
+using Printf3D_t   = void(__cdecl*)(const float*, const char*, ...);
+
+static DrawLine3D_t s_drawLine3D = nullptr;
+static Printf3D_t   s_printf3D   = nullptr;
+
+// ---------------------------------------------------------------------------
+// Batch
+// ---------------------------------------------------------------------------
+
+struct BatchLine {
+   float    a[3];
+   float    b[3];
+   uint32_t color;
+};
+
+struct BatchLabel {
+   float pos[3];
+   char  text[kLabelLen];
+};
+
+static BatchLine  s_lines[kMaxLines];
+static BatchLabel s_labels[kMaxLabels];
+static int        s_lineCount  = 0;
+static int        s_labelCount = 0;
+
+static float      s_cos[kCircleSegs + 1];
+static float      s_sin[kCircleSegs + 1];
+
+// Camera matrix snapshot, refreshed on the first primitive of each batch
+static float s_camMatrix[16];
+static bool  s_haveCamera = false;
+
+// ---------------------------------------------------------------------------
+// Culling
+// ---------------------------------------------------------------------------
+
+static void refresh_camera()
+{
+   const float* m = red_camera_matrix();
+   s_haveCamera = m != nullptr;
+   if (m) memcpy(s_camMatrix, m, sizeof(s_camMatrix));
+}
+
+// Bounding sphere vs. view cone and draw distance.  Returns the distance
+// to the camera (0 if there is no camera), or a negative value if culled.
+static float cull(float x, float y, float z, float radius)
+{
+   if (!s_lineCount && !s_labelCount) refresh_camera();
+   if (!s_haveCamera) return 0.0f;
+
+   const float* m = s_camMatrix;
+   float rx = x - m[12], ry = y - m[13], rz = z - m[14];
+   float d2 = rx * rx + ry * ry + rz * rz;
+   float reach = kMaxDistance + radius;
+   if (d2 > reach * reach) return -1.0f;
+
+   const float pos[3] = { x, y, z };
+   if (!camera_cone_test(pos, radius)) return -1.0f;
+   return sqrtf(d2);
+}
+
+// Table stride for a circle of this radius at this distance
+static int circle_step(float radius, float dist)
+{
+   if (dist <= radius) return 1;
+   float size = radius / dist;
+   if (size > 0.5f)  return 1;    // 64 segments
+   if (size > 0.15f) return 2;    // 32
+   if (size > 0.05f) return 4;    // 16
+   return 8;                      // 8
+}
+
+static inline void push_line(float x0, float y0, float z0, float x1, float y1, float z1, uint32_t color)
+{
+   if (s_lineCount >= kMaxLines) return;
+   BatchLine& l = s_lines[s_lineCount++];
+   l.a[0] = x0; l.a[1] = y0; l.a[2] = z0;
+   l.b[0] = x1; l.b[1] = y1; l.b[2] = z1;
+   l.color = color;
+}
+
+// Circle in the plane spanned by axes u and v (0 = X, 1 = Y, 2 = Z)
+static void push_ring(const float c[3], float radius, int u, int v, int step, uint32_t color)
+{
+   float p0[3] = { c[0], c[1], c[2] };
+   float p1[3] = { c[0], c[1], c[2] };
+   p0[u] += radius;
+   for (int i = step; i <= kCircleSegs; i += step) {
+      p1[u] = c[u] + radius * s_cos[i];
+      p1[v] = c[v] + radius * s_sin[i];
+      push_line(p0[0], p0[1], p0[2], p1[0], p1[1], p1[2], color);
+      p0[u] = p1[u];
+      p0[v] = p1[v];
+   }
+}
+
+// ---------------------------------------------------------------------------
+// Public
+// ---------------------------------------------------------------------------
+
+void debug_draw_line(float x0, float y0, float z0, float x1, float y1, float z1, uint32_t color)
+{
+   float cx = (x0 + x1) * 0.5f, cy = (y0 + y1) * 0.5f, cz = (z0 + z1) * 0.5f;
+   float dx = x1 - x0, dy = y1 - y0, dz = z1 - z0;
+   float half = 0.5f * sqrtf(dx * dx + dy * dy + dz * dz);
+   if (cull(cx, cy, cz, half) < 0.0f) return;
+   push_line(x0, y0, z0, x1, y1, z1, color);
+}
+
+void debug_draw_circle_xz(float cx, float cy, float cz, float radius, uint32_t color)
+{
+   if (radius <= 0.01f) return;
+   float dist = cull(cx, cy, cz, radius);
+   if (dist < 0.0f) return;
+   const float c[3] = { cx, cy, cz };
+   push_ring(c, radius, 0, 2, circle_step(radius, dist), color);
+}
+
+void debug_draw_sphere(float cx, float cy, float cz, float radius, uint32_t color)
+{
+   if (radius <= 0.0f) return;
+   float dist = cull(cx, cy, cz, radius);
+   if (dist < 0.0f) return;
+   const float c[3] = { cx, cy, cz };
+   int step = circle_step(radius, dist);
+   push_ring(c, radius, 0, 2, step, color);
+   push_ring(c, radius, 0, 1, step, color);
+   push_ring(c, radius, 2, 1, step, color);
+}
+
+void debug_draw_text(float x, float y, float z, const char* fmt, ...)
+{
+   if (s_labelCount >= kMaxLabels) return;
+   if (cull(x, y, z, kLabelRadius) < 0.0f) return;
+
+   BatchLabel& l = s_labels[s_labelCount++];
+   l.pos[0] = x; l.pos[1] = y; l.pos[2] = z;
+   va_list ap;
+   va_start(ap, fmt);
+   _vsnprintf_s(l.text, sizeof(l.text), _TRUNCATE, fmt, ap);
+   va_end(ap);
+}
+
+void debug_draw_submit()
+{
+   if (s_drawLine3D) {
+      for (int i = 0; i < s_lineCount; ++i) {
+         const BatchLine& l = s_lines[i];
+         s_drawLine3D(l.a[0], l.a[1], l.a[2], l.b[0], l.b[1], l.b[2], l.color);
+      }
+   }
+   if (s_printf3D) {
+      for (int i = 0; i < s_labelCount; ++i)
+         s_printf3D(s_labels[i].pos, "%s", s_labels[i].text);
+   }
+   s_lineCount  = 0;
+   s_labelCount = 0;
+}
+
+void debug_draw_install(uintptr_t exe_base)
+{
+   using namespace game_addrs::modtools;
+
+   s_drawLine3D = (DrawLine3D_t)resolve(exe_base, draw_line_3d);
+   s_printf3D   = (Printf3D_t)  resolve(exe_base, printf_3d);
+
+   constexpr float PI2 = 6.283185307f;
+   for (int i = 0; i <= kCircleSegs; ++i) {
+      float a = PI2 * (float)i / (float)kCircleSegs;
+      s_cos[i] = cosf(a);
+      s_sin[i] = sinf(a);
+   }
+   // Close the loop exactly
+   s_cos[kCircleSegs] = 1.0f;
+   s_sin[kCircleSegs] = 0.0f;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stdint.h>
+
+// =============================================================================
+// Debug draw — batched, culled debug geometry for console visualizations.
+//
+// Debug commands add lines, circles, spheres and labels during a frame;
+// debug_draw_submit() hands the whole batch to the engine in one pass and
+// clears it.
+//
+//   - Circles and spheres are built from a precomputed unit-circle table.
+//     The segment count follows the shape's apparent size (8 to 64).
+//   - Every primitive is tested against the render camera first.  Anything
+//     behind it, outside the view cone or beyond kMaxDistance is dropped
+//     before it costs a vertex.
+//   - Spheres are three great circles, so they share the line batch.
+//
+// The engine has no multi-line submit, so debug_draw_submit() is one
+// DrawLine3D per line — but only for what survived culling, and only once
+// per frame.
+// =============================================================================
+
+void debug_draw_line(float x0, float y0, float z0, float x1, float y1, float z1, uint32_t color);
+void debug_draw_circle_xz(float cx, float cy, float cz, float radius, uint32_t color);
+void debug_draw_sphere(float cx, float cy, float cz, float radius, uint32_t color);
+void debug_draw_text(float x, float y, float z, const char* fmt, ...);
+
+// Draw everything batched since the last submit, then clear
+void debug_draw_submit();
+
+// Resolve the engine draw functions and build the circle table
+void debug_draw_install(uintptr_t exe_base);
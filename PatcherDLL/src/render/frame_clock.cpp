@@ -0,0 +1,135 @@
+#include "pch.h"
+#include "frame_clock.hpp"
+#include "core/resolve.hpp"
+#include "controller/player_controller_update.hpp"
+
+#include <d3d9.h>
+#include <detours.h>
+
+static constexpr int kMaxCallbacks      = 8;
+static constexpr int kDevicePresentSlot = 17;   // IDirect3DDevice9::Present
+
+using Present_t = HRESULT(__stdcall*)(IDirect3DDevice9* device, const RECT* src, const RECT* dst,
+                                      HWND window, const RGNDATA* dirty);
+using Direct3DCreate9_t = IDirect3D9*(WINAPI*)(UINT sdkVersion);
+
+static Present_t  s_origPresent  = nullptr;
+static bool       s_attachTried  = false;
+
+static uint32_t         s_frameId = 1;
+static FrameEndCallback s_callbacks[kMaxCallbacks] = {};
+static int              s_callbackCount = 0;
+
+uint32_t frame_clock_id()
+{
+   return s_frameId;
+}
+
+void frame_clock_on_frame_end(FrameEndCallback fn)
+{
+   for (int i = 0; i < s_callbackCount; i++)
+      if (s_callbacks[i] == fn) return;
+   if (s_callbackCount < kMaxCallbacks) s_callbacks[s_callbackCount++] = fn;
+}
+
+// ---------------------------------------------------------------------------
+// Hook: IDirect3DDevice9::Present
+// ---------------------------------------------------------------------------
+
+static HRESULT __stdcall hooked_Present(IDirect3DDevice9* device, const RECT* src, const RECT* dst,
+                                        HWND window, const RGNDATA* dirty)
+{
+   HRESULT hr = s_origPresent(device, src, dst, window, dirty);
+
+   s_frameId++;
+   for (int i = 0; i < s_callbackCount; i++) {
+      __try { s_callbacks[i](); }
+      __except (EXCEPTION_EXECUTE_HANDLER) {}
+   }
+   return hr;
+}
+
+// Present's address, from the vtable of a windowed NULLREF device
+static void* find_present()
+{
+   HMODULE d3d9 = GetModuleHandleA("d3d9.dll");
+   auto create = d3d9 ? (Direct3DCreate9_t)GetProcAddress(d3d9, "Direct3DCreate9") : nullptr;
+   IDirect3D9* d3d = create ? create(D3D_SDK_VERSION) : nullptr;
+   if (!d3d) return nullptr;
+
+   void* present = nullptr;
+   HWND window = CreateWindowExA(0, "STATIC", "", WS_POPUP, 0, 0, 1, 1,
+                                 nullptr, nullptr, nullptr, nullptr);
+   if (window) {
+      D3DPRESENT_PARAMETERS pp = {};
+      pp.Windowed         = TRUE;
+      pp.SwapEffect       = D3DSWAPEFFECT_DISCARD;
+      pp.hDeviceWindow    = window;
+      pp.BackBufferFormat = D3DFMT_UNKNOWN;
+
+      IDirect3DDevice9* device = nullptr;
+      if (SUCCEEDED(d3d->CreateDevice(D3DADAPTER_DEFAULT, D3DDEVTYPE_NULLREF, window,
+                                      D3DCREATE_SOFTWARE_VERTEXPROCESSING, &pp, &device)) && device) {
+         present = (*(void***)device)[kDevicePresentSlot];
+         device->Release();
+      }
+      DestroyWindow(window);
+   }
+   d3d->Release();
+   return present;
+}
+
+void frame_clock_attach()
+{
+   if (s_attachTried) return;
+   s_attachTried = true;
+
+   s_origPresent = (Present_t)find_present();
+   if (!s_origPresent) {
+      get_gamelog()("[FrameClock] IDirect3DDevice9::Present not found - frame id stays at 1\n");
+      return;
+   }
+
+   DetourTransactionBegin();
+   DetourUpdateThread(GetCurrentThread());
+   LONG r = DetourAttach(&(PVOID&)s_origPresent, hooked_Present);
+   LONG rc = DetourTransactionCommit();
+   get_gamelog()("[FrameClock] Present hook attach=%ld commit=%ld\n", r, rc);
+
+   if (r != NO_ERROR || rc != NO_ERROR) s_origPresent = nullptr;
+}
+
+// ---------------------------------------------------------------------------
+// PlayerController::Update — attach trigger when play starts without a
+// loading screen having run first
+// ---------------------------------------------------------------------------
+
+static void on_pc_update(void* /*controller*/, float /*dt*/)
+{
+   frame_clock_attach();
+}
+
+// ---------------------------------------------------------------------------
+// Install / Uninstall
+// ---------------------------------------------------------------------------
+
+void frame_clock_install(uintptr_t /*exe_base*/)
+{
+   pc_update_before(on_pc_update);
+}
+
+void frame_clock_uninstall()
+{
+   pc_update_remove(on_pc_update);
+
+   if (s_origPresent) {
+      DetourTransactionBegin();
+      DetourUpdateThread(GetCurrentThread());
+      DetourDetach(&(PVOID&)s_origPresent, hooked_Present);
+      DetourTransactionCommit();
+      s_origPresent = nullptr;
+   }
+
+   s_callbackCount = 0;
+   s_attachTried   = false;
+}
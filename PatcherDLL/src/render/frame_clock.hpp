@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stdint.h>
+
+// =============================================================================
+// Frame clock — one frame boundary for every subsystem
+//
+// IDirect3DDevice9::Present ends every frame the game shows, in play and on
+// the loading screen alike, so the clock ticks there.  Code with per-frame
+// state (stats windows, once-per-frame passes) registers an end-of-frame
+// callback or compares against frame_clock_id() rather than guessing where
+// frames start from its own call pattern.
+//
+// Present is read from the vtable of a throwaway NULLREF device — d3d9.dll
+// shares the function across devices, so detouring it covers the game's.
+// The device can't be created under the loader lock, so frame_clock_attach()
+// runs from the first LoadDisplay::Update / PlayerController::Update rather
+// than at install.  Until then frame_clock_id() stays at 1.
+// =============================================================================
+
+using FrameEndCallback = void(*)();
+
+// Frames presented so far, starting at 1
+uint32_t frame_clock_id();
+
+// Call fn after every Present, in registration order.  Up to 8.
+void frame_clock_on_frame_end(FrameEndCallback fn);
+
+// Hook Present if it isn't yet.  Needs the game loop running, not DllMain.
+void frame_clock_attach();
+
+void frame_clock_install(uintptr_t exe_base);
+void frame_clock_uninstall();
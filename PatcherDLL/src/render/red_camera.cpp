@@ -0,0 +1,10 @@
+#include "pch.h"
+#include "red_camera.hpp"
+#include "core/resolve.hpp"
+
+uintptr_t g_redCameraGlobal = 0;
+
+void red_camera_install(uintptr_t exe_base)
+{
+   g_redCameraGlobal = (uintptr_t)resolve(exe_base, game_addrs::modtools::m_camera_global);
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdint.h>
+#include <math.h>
+
+// =============================================================================
+// RedCamera — the current render camera, for culling and LOD decisions
+//
+// m_camera_global holds the RedCamera* the frame is rendered from.  Its
+// world matrix (4x4 row-major: right, up, back, position) sits at +0x30 and
+// tan(half horizontal FOV) at +0x144.
+//
+// camera_cone_test() is the one bounding-sphere vs. view test everything
+// shares.  It checks a square cone of half-width tanHFov — wider than the
+// real frustum vertically, so it never rejects anything on screen.
+// =============================================================================
+
+static constexpr uintptr_t kCam_Matrix  = 0x30;    // 4x4 row-major
+static constexpr uintptr_t kCam_TanHFov = 0x144;
+
+// RedCamera** — resolved by red_camera_install
+extern uintptr_t g_redCameraGlobal;
+
+void red_camera_install(uintptr_t exe_base);
+
+// Current RedCamera*, 0 before the first camera exists
+inline uintptr_t red_camera()
+{
+   return g_redCameraGlobal ? *(uintptr_t*)g_redCameraGlobal : 0;
+}
+
+// World matrix of the current camera, nullptr if there is none
+inline const float* red_camera_matrix()
+{
+   uintptr_t cam = red_camera();
+   return cam ? (const float*)(cam + kCam_Matrix) : nullptr;
+}
+
+// Could a sphere at pos be on screen?  True when there's no camera to test
+// against, so callers fall back to treating everything as visible.
+inline bool camera_cone_test(const float* pos, float radius)
+{
+   uintptr_t cam = red_camera();
+   if (!cam) return true;
+
+   float tanHFov = *(float*)(cam + kCam_TanHFov);
+   if (tanHFov <= 0.0f) return true;
+
+   const float* m = (const float*)(cam + kCam_Matrix);
+   float rx = pos[0] - m[12], ry = pos[1] - m[13], rz = pos[2] - m[14];
+
+   float z = -(rx * m[8] + ry * m[9] + rz * m[10]);
+   if (z < -radius) return false;
+
+   float x = rx * m[0] + ry * m[1] + rz * m[2];
+   float y = rx * m[4] + ry * m[5] + rz * m[6];
+   float extent = (z > 0.0f ? z : 0.0f) * tanHFov + radius;
+   return fabsf(x) <= extent && fabsf(y) <= extent;
+}
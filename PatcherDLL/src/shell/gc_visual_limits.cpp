@@ -1,6 +1,8 @@
 #include "pch.h"
 #include "gc_visual_limits.hpp"
 #include "core/resolve.hpp"
+#include "util/pbl_hash.hpp"
+#include "debug_commands/ext_perf.hpp"
 
 #include <detours.h>
 #include <cstring>
@@ -65,43 +67,82 @@ typedef bool (__thiscall* fn_ParticleAdd_t)(
     void* ecx, const float* pos, const char* texName,
     float size, uint32_t color, float rotation);
 
-typedef uint32_t* (__fastcall* fn_PblHash_t)(uint32_t* out, void* edx, const char* str);
-
 // ---------------------------------------------------------------------------
 // Resolved pointers
 // ---------------------------------------------------------------------------
 
 static fn_BeamAdd_t     g_origBeamAdd     = nullptr;
 static fn_ParticleAdd_t g_origParticleAdd = nullptr;
-static fn_PblHash_t     g_pblHash         = nullptr;
 
 // ---------------------------------------------------------------------------
 // Debug stats — per-frame high-water marks + periodic logging
 // ---------------------------------------------------------------------------
-static uint32_t g_beamAddCalls      = 0;
-static uint32_t g_beamDropped       = 0;
-static uint32_t g_particleAddCalls  = 0;
-static uint32_t g_particleDropped   = 0;
-static uint32_t g_beamHighWater     = 0;
-static uint32_t g_particleHighWater = 0;
-static uint32_t g_frameCount        = 0;
-static bool     g_loggedOnce        = false;
+
+struct ListStats {
+    uint32_t addCalls;
+    uint32_t dropped;
+    uint32_t highWater;       // max per frame since the last STATS line
+};
+
+static ListStats g_beams      = {};
+static ListStats g_particles  = {};
+static uint32_t  g_frameCount = 0;
+static bool      g_loggedOnce = false;
+
+static void stats_frame()
+{
+    g_frameCount++;
+    if (!g_loggedOnce || (g_frameCount % 120 == 0)) {
+        log("[GC_VIS] STATS: beams=%u/%u particles=%u/%u (vanilla limits: %u/%u) dropped: b=%u p=%u",
+            g_beams.highWater, kNewBeamLimit, g_particles.highWater, kNewParticleLimit,
+            kVanillaBeamLimit, kVanillaParticleLimit, g_beams.dropped, g_particles.dropped);
+        g_beams.highWater     = 0;
+        g_particles.highWater = 0;
+        g_loggedOnce = true;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Entry layout
+// ---------------------------------------------------------------------------
+
+static inline void write_beam(uint32_t* entry, const float* pos1, const float* pos2, const char* texName,
+                              float size, uint32_t color, float shift, float repetitions)
+{
+    memcpy(entry, pos1, 12);
+    memcpy(entry + 3, pos2, 12);
+    entry[6] = pbl_hash_intern(texName);
+    memcpy(entry + 7, &size, 4);
+    entry[8] = color;
+    memcpy(entry + 9, &shift, 4);
+    memcpy(entry + 10, &repetitions, 4);
+}
+
+static inline void write_particle(uint32_t* entry, const float* pos, const char* texName,
+                                  float size, uint32_t color, float rotation)
+{
+    memcpy(entry, pos, 12);
+    entry[3] = pbl_hash_intern(texName);
+    memcpy(entry + 4, &size, 4);
+    entry[5] = color;
+    memcpy(entry + 6, &rotation, 4);
+}
 
 // ---------------------------------------------------------------------------
 // Hooked Add functions
 // ---------------------------------------------------------------------------
 
-static bool __fastcall hooked_beam_add(
-    void* ecx, void* /*edx*/, const float* pos1, const float* pos2, const char* texName,
+static bool beam_add(
+    void* ecx, const float* pos1, const float* pos2, const char* texName,
     float size, uint32_t color, float shift, float repetitions)
 {
     auto base = reinterpret_cast<uint8_t*>(ecx);
     auto count = reinterpret_cast<uint32_t*>(base + kNewBeamCountOff);
 
-    g_beamAddCalls++;
+    g_beams.addCalls++;
 
     if (*count >= kNewBeamLimit) {
-        g_beamDropped++;
+        g_beams.dropped++;
         return false;
     }
 
@@ -109,73 +150,64 @@ static bool __fastcall hooked_beam_add(
     *count = idx + 1;
 
     // Track per-frame high-water mark
-    if (idx + 1 > g_beamHighWater)
-        g_beamHighWater = idx + 1;
+    if (idx + 1 > g_beams.highWater)
+        g_beams.highWater = idx + 1;
 
     auto entry = reinterpret_cast<uint32_t*>(base + kArrayStart + idx * kBeamEntrySize);
-
-    memcpy(entry, pos1, 12);
-    memcpy(entry + 3, pos2, 12);
-
-    uint32_t hash;
-    g_pblHash(&hash, nullptr, texName);
-    entry[6] = hash;
-
-    memcpy(entry + 7, &size, 4);
-    entry[8] = color;
-    memcpy(entry + 9, &shift, 4);
-    memcpy(entry + 10, &repetitions, 4);
+    write_beam(entry, pos1, pos2, texName, size, color, shift, repetitions);
 
     return true;
 }
 
-static bool __fastcall hooked_particle_add(
-    void* ecx, void* /*edx*/, const float* pos, const char* texName,
+static bool __fastcall hooked_beam_add(
+    void* ecx, void* /*edx*/, const float* pos1, const float* pos2, const char* texName,
+    float size, uint32_t color, float shift, float repetitions)
+{
+    return ext_perf_call(kExtPerf_GCBeamAdd, [&] {
+        return beam_add(ecx, pos1, pos2, texName, size, color, shift, repetitions);
+    });
+}
+
+static bool particle_add(
+    void* ecx, const float* pos, const char* texName,
     float size, uint32_t color, float rotation)
 {
     auto base = reinterpret_cast<uint8_t*>(ecx);
     auto count = reinterpret_cast<uint32_t*>(base + kNewParticleCountOff);
 
-    g_particleAddCalls++;
+    g_particles.addCalls++;
 
     if (*count >= kNewParticleLimit) {
-        g_particleDropped++;
+        g_particles.dropped++;
         return false;
     }
 
     uint32_t idx = *count;
     *count = idx + 1;
 
+    // First particle of a frame — the engine cleared the count after drawing
+    if (idx == 0)
+        stats_frame();
+
     // Track per-frame high-water mark
-    if (idx + 1 > g_particleHighWater)
-        g_particleHighWater = idx + 1;
+    if (idx + 1 > g_particles.highWater)
+        g_particles.highWater = idx + 1;
 
     auto entry = reinterpret_cast<uint32_t*>(base + (idx + 1) * kParticleEntrySize);
-
-    memcpy(entry, pos, 12);
-
-    uint32_t hash;
-    g_pblHash(&hash, nullptr, texName);
-    entry[3] = hash;
-
-    memcpy(entry + 4, &size, 4);
-    entry[5] = color;
-    memcpy(entry + 6, &rotation, 4);
-
-    // Log high-water marks periodically (every ~120 frames)
-    if (idx == 0) {
-        g_frameCount++;
-        if (!g_loggedOnce || (g_frameCount % 120 == 0)) {
-            log("[GC_VIS] STATS: beams=%u/%u particles=%u/%u (vanilla limits: %u/%u) dropped: b=%u p=%u",
-                g_beamHighWater, kNewBeamLimit, g_particleHighWater, kNewParticleLimit,
-                kVanillaBeamLimit, kVanillaParticleLimit, g_beamDropped, g_particleDropped);
-            g_loggedOnce = true;
-        }
-    }
+    write_particle(entry, pos, texName, size, color, rotation);
 
     return true;
 }
 
+static bool __fastcall hooked_particle_add(
+    void* ecx, void* /*edx*/, const float* pos, const char* texName,
+    float size, uint32_t color, float rotation)
+{
+    return ext_perf_call(kExtPerf_GCParticleAdd, [&] {
+        return particle_add(ecx, pos, texName, size, color, rotation);
+    });
+}
+
 // ---------------------------------------------------------------------------
 // Runtime patching helpers
 // ---------------------------------------------------------------------------
@@ -204,7 +236,6 @@ void gc_visual_limits_install(uintptr_t exe_base)
 {
     using namespace game_addrs::modtools;
     g_log = reinterpret_cast<GameLog_t>(resolve(exe_base, game_log));
-    g_pblHash = reinterpret_cast<fn_PblHash_t>(resolve(exe_base, hash_string_thiscall));
 
     // Append to the install log alongside the other patch sets
     FILE* f = nullptr;
@@ -245,7 +276,7 @@ void gc_visual_limits_uninstall()
     // Log final stats
     if (g_log) {
         log("[GC_VIS] Final stats: beam_add=%u (dropped=%u) particle_add=%u (dropped=%u)",
-            g_beamAddCalls, g_beamDropped, g_particleAddCalls, g_particleDropped);
+            g_beams.addCalls, g_beams.dropped, g_particles.addCalls, g_particles.dropped);
     }
 
     if (g_origBeamAdd) {
@@ -25,6 +25,12 @@
 //   Beams:     64  -> 256
 //   Particles: 128 -> 512
 //
+// The limits are still fixed: entries past them are dropped and counted.
+// Moving the lists into growable buffers needs the engine's Render loops
+// redirected, and those functions aren't mapped yet.  Until then the
+// [GC_VIS] STATS log line reports each list's per-frame high-water mark
+// since the previous line, to show how close a map gets to the limits.
+//
 // TODO: The beam limit extension is experimental and might not fully work yet.
 //       The particle limit is confirmed working. The beam Add hook and Render
 //       displacement patches are in place, but users report no visible increase
@@ -73,6 +73,36 @@ inline constexpr IniEntry g_ini_registry[] = {
    INI_ENTRY("AimAssist", "ProximityFriction",         "1",   "Slow stick when crosshair is near any enemy"),
    INI_ENTRY("AimAssist", "ProximityFrictionRadius",   "0.5", "Screen-space radius for proximity slowdown"),
    INI_ENTRY("AimAssist", "ProximityFrictionScale",    "0.4", "Min friction at dead center (0 = full stop, 1 = none)"),
+
+   // [LoadScreen] — loading screen frame pacing (EnableBF1 loading screens)
+   INI_ENTRY("LoadScreen", "FrameBudgetMs", "33.3", "Target interval between loading screen frames in ms"),
+   INI_ENTRY("LoadScreen", "PacingMode",    "0",    "0 = smooth animation, 1 = favor load throughput"),
+
+   // [LevelPrefetch] — learned .lvl read-ahead during level loads
+   INI_ENTRY("LevelPrefetch", "Enabled",   "0",   "Warm the OS file cache for upcoming .lvl files using learned load sequences"),
+   INI_ENTRY("LevelPrefetch", "Lookahead", "3",   "Number of .lvl files to read ahead of the engine"),
+   INI_ENTRY("LevelPrefetch", "BudgetMB",  "256", "Max prefetched MB not yet opened by the engine"),
+
+   // [FlyerBoost] — flyer boost animation blend LOD
+   INI_ENTRY("FlyerBoost", "LodDistance",       "150", "Distance beyond which the boost blend updates at a reduced rate (0 = off)"),
+   INI_ENTRY("FlyerBoost", "FarUpdateInterval", "4",   "Past LodDistance, re-evaluate the blend every Nth frame"),
+   INI_ENTRY("FlyerBoost", "CullOffscreen",     "1",   "Skip the boost blend for flyers outside the camera view"),
+   // [ClothLOD] — EntityCloth sleep and distance / visibility LOD
+   INI_ENTRY("ClothLOD", "Enabled",         "0",  "Skip the cloth solve for settled, distant or off-screen cloth"),
+   INI_ENTRY("ClothLOD", "SleepFrames",     "30", "Frames a cloth must stay still before it sleeps"),
+   INI_ENTRY("ClothLOD", "LodDistance",     "60", "Distance beyond which cloth solves at a reduced rate (0 = off)"),
+   INI_ENTRY("ClothLOD", "FarTickInterval", "3",  "Distant / off-screen cloth solves every Nth frame"),
+   INI_ENTRY("ClothLOD", "CullOffscreen",   "1",  "Throttle cloth outside the camera view"),
+   // [Memory] — RedHeap allocator changes
+   // [Profiling] — diagnostics, all off by default
+   INI_ENTRY("Profiling", "LoadProfiler", "0", "Write a Chrome trace (BF2GameExt_load_<n>.json) and log summary per level load"),
+   INI_ENTRY("Profiling", "ClothCapture", "0", "Record cloth solves and collision primitives to BF2GameExt_cloth_<n>.txt for offline replay"),
+   INI_ENTRY("Profiling", "ClothKernelCheck", "0", "Run the engine's cloth cylinder collision alongside the SSE kernel and log mismatches per level"),
+   INI_ENTRY("Profiling", "ExtPerf", "0", "Time BF2GameExt hooks from startup (same as ShowExtPerf in the ModTools console)"),
+   INI_ENTRY("Profiling", "ExtPerfCsv", "0", "With hook timing on, append 1 s summaries to BF2GameExt_perf.csv"),
+   INI_ENTRY("Profiling", "XInputLatency", "0", "Poll the gamepad through XInput on its own thread and log input age per frame (measurement only)"),
+   INI_ENTRY("Profiling", "XInputPollHz", "250", "XInput latency probe poll rate in Hz (60-8000)"),
+   INI_ENTRY("Profiling", "HeapProfiler", "0", "Track RedHeap usage to BF2GameExt_heap.csv; HeapStats in the ModTools console logs a report"),
 };
 // END_REGISTRY
 
@@ -0,0 +1,152 @@
+#include "pch.h"
+#include "pbl_hash.hpp"
+#include "core/resolve.hpp"
+
+#include <cstring>
+
+// =============================================================================
+// PblHash interning service
+//
+// Two open-addressed tables over one string arena:
+//   pointer table — str pointer -> hash
+//   content table — hash        -> arena offset, probed with strcmp
+// A level's working set is a few hundred names; the arena and both tables
+// are cleared on every level transition.
+// =============================================================================
+
+static constexpr int      kPointerBits  = 12;
+static constexpr int      kPointerSize  = 1 << kPointerBits;
+static constexpr int      kPointerProbe = 8;
+static constexpr int      kContentSize  = 2048;              // power of two
+static constexpr int      kContentMax   = kContentSize * 3 / 4;
+static constexpr uint32_t kArenaSize    = 64 * 1024;
+
+struct PointerSlot {
+   const char* ptr;       // nullptr = free
+   uint32_t    hash;
+};
+
+struct ContentSlot {
+   uint32_t hash;
+   uint32_t off;          // 0 = free (offset 0 is never handed out)
+};
+
+static PointerSlot        s_pointers[kPointerSize] = {};
+static ContentSlot        s_content[kContentSize]  = {};
+static char               s_arena[kArenaSize];
+static uint32_t           s_arenaUsed = 1;
+static PblHashInternStats s_stats     = {};
+
+static inline uint32_t pointer_index(const char* str)
+{
+   return ((uint32_t)(uintptr_t)str * 0x9E3779B1u) >> (32 - kPointerBits);
+}
+
+// Existing arena offset for this text, or a new copy.  0 = no room.
+static uint32_t intern_text(const char* str, uint32_t hash)
+{
+   uint32_t i = hash & (kContentSize - 1);
+   for (;;) {
+      ContentSlot& s = s_content[i];
+      if (!s.off) break;
+      if (s.hash == hash && strcmp(s_arena + s.off, str) == 0) {
+         s_stats.contentHits++;
+         return s.off;
+      }
+      i = (i + 1) & (kContentSize - 1);
+   }
+
+   const uint32_t len = (uint32_t)strlen(str) + 1;
+   if ((int)s_stats.strings >= kContentMax || s_arenaUsed + len > kArenaSize) return 0;
+
+   ContentSlot& s = s_content[i];
+   s.hash = hash;
+   s.off  = s_arenaUsed;
+   memcpy(s_arena + s_arenaUsed, str, len);
+   s_arenaUsed += len;
+   s_stats.strings++;
+   s_stats.misses++;
+   return s.off;
+}
+
+// Slot holding str, else the first free slot in its probe window; with
+// none free, the home slot is recycled.
+static PointerSlot* pointer_slot(const char* str)
+{
+   const uint32_t home = pointer_index(str);
+   PointerSlot* freeSlot = nullptr;
+   for (int p = 0; p < kPointerProbe; p++) {
+      PointerSlot& s = s_pointers[(home + p) & (kPointerSize - 1)];
+      if (s.ptr == str) return &s;
+      if (!s.ptr && !freeSlot) freeSlot = &s;
+   }
+   return freeSlot ? freeSlot : &s_pointers[home];
+}
+
+uint32_t pbl_hash_intern(const char* str)
+{
+   if (!str || !*str) return 0;
+
+   // Pointer fast path — the caller guarantees the text behind a known
+   // pointer hasn't changed, so there is nothing to compare
+   PointerSlot* slot = pointer_slot(str);
+   if (slot->ptr == str) {
+      s_stats.pointerHits++;
+      return slot->hash;
+   }
+
+   const uint32_t hash = pbl_hash(str);
+   const uint32_t off  = intern_text(str, hash);
+   if (!off) {
+      s_stats.uncached++;
+      return hash;
+   }
+
+   slot->ptr  = str;
+   slot->hash = hash;
+   return hash;
+}
+
+uint32_t pbl_hash_intern_copy(const char* str, const char** outCopy)
+{
+   *outCopy = str;
+   if (!str || !*str) return 0;
+
+   const uint32_t hash = pbl_hash(str);
+   const uint32_t off  = intern_text(str, hash);
+   if (!off) {
+      s_stats.uncached++;
+      return hash;
+   }
+
+   // Remember the copy so later pbl_hash_intern calls on it are pointer hits
+   const char* copy = s_arena + off;
+   PointerSlot* slot = pointer_slot(copy);
+   slot->ptr  = copy;
+   slot->hash = hash;
+
+   *outCopy = copy;
+   return hash;
+}
+
+void pbl_hash_intern_get_stats(PblHashInternStats* out)
+{
+   *out = s_stats;
+   out->arenaBytes = s_arenaUsed - 1;
+}
+
+void pbl_hash_intern_reset()
+{
+   const uint32_t lookups = s_stats.pointerHits + s_stats.contentHits + s_stats.misses + s_stats.uncached;
+   if (lookups) {
+      get_gamelog()("[PblHash] %u lookups: %u pointer hits, %u content hits, %u hashed, %u uncached "
+                    "(%.1f%% hit) | %u strings, %u bytes\n",
+                    lookups, s_stats.pointerHits, s_stats.contentHits, s_stats.misses, s_stats.uncached,
+                    (s_stats.pointerHits + s_stats.contentHits) * 100.0 / lookups,
+                    s_stats.strings, s_arenaUsed - 1);
+   }
+   memset(s_pointers, 0, sizeof(s_pointers));
+   memset(s_content, 0, sizeof(s_content));
+   memset(&s_stats, 0, sizeof(s_stats));
+   s_arenaUsed = 1;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <stdint.h>
+
+// =============================================================================
+// PblHash
+//
+// FNV-1a over the string with bit 5 forced on — the engine's case-insensitive
+// PblHash::calcHash ('_' hashes as 0x7F, the same as the game).  Null and
+// empty strings hash to 0, which every caller treats as "no name".
+//
+//   pbl_hash        — plain routine, usable at compile time or run time
+//   pbl_hash_ct     — consteval; for names known at build time
+//   pbl_hash_intern — run-time strings that are hashed over and over
+//   pbl_hash_intern_copy — run-time text in a transient buffer
+// =============================================================================
+
+constexpr uint32_t pbl_hash(const char* str)
+{
+   if (!str || !*str) return 0;
+   uint32_t hash = 0x811c9dc5;
+   while (*str) {
+      hash = (hash ^ ((uint8_t)*str | 0x20)) * 0x1000193;
+      str++;
+   }
+   return hash;
+}
+
+consteval uint32_t pbl_hash_ct(const char* str)
+{
+   return pbl_hash(str);
+}
+
+// =============================================================================
+// Interning service
+//
+// Most run-time names are stable pointers — string literals, ODF property
+// strings, texture names handed to the same draw call every frame.  The
+// service looks the pointer up first, and a hit is a pointer compare only:
+// no strcmp, no hashing.  A pointer it hasn't seen is hashed once, the
+// content is interned (deduplicated against every other pointer with the
+// same text), and the pointer is remembered.
+//
+// So pbl_hash_intern's argument must keep the same text at the same address
+// until the next level transition, when the tables are dropped.  Text in a
+// stack buffer, a Lua string or anything else that can be rewritten goes
+// through pbl_hash_intern_copy, which returns the interned copy — a stable
+// pointer for the rest of the level — or through plain pbl_hash.
+// Main thread only.
+// =============================================================================
+
+struct PblHashInternStats {
+   uint32_t pointerHits;
+   uint32_t contentHits;     // new pointer, text already interned
+   uint32_t misses;          // hashed and interned
+   uint32_t uncached;        // hashed, but the table or arena was full
+   uint32_t strings;         // distinct texts interned
+   uint32_t arenaBytes;
+};
+
+uint32_t pbl_hash_intern(const char* str);
+
+// Hash of transient text.  *outCopy gets the interned copy of str (already
+// known to the pointer table, so pbl_hash_intern on it is a pointer hit), or
+// str itself if the arena is full.
+uint32_t pbl_hash_intern_copy(const char* str, const char** outCopy);
+
+void pbl_hash_intern_get_stats(PblHashInternStats* out);
+
+// Level transition — log this level's counters and drop every entry.
+void pbl_hash_intern_reset();
@@ -1,6 +1,7 @@
 #include "pch.h"
 #include "disguise_model_override.hpp"
 #include "core/resolve.hpp"
+#include "util/pbl_hash.hpp"
 
 #include <cstring>
 #include <detours.h>
@@ -29,7 +30,6 @@
 // Game function types
 // ---------------------------------------------------------------------------
 
-using fn_hash_string_t = uint32_t(__cdecl*)(const char*);
 
 // WeaponDisguiseClass::SetProperty
 using fn_SetProperty_t = void(__fastcall*)(void* ecx, void* edx,
@@ -49,7 +49,6 @@ static constexpr int kEntityGeom_mModel_offset = 0x130;
 // Resolved pointers
 // ---------------------------------------------------------------------------
 
-static fn_hash_string_t    fn_hash_string     = nullptr;
 static fn_HashTableFind_t  fn_hashtable_find   = nullptr;
 static uint32_t*           g_gameModelTable    = nullptr;
 
@@ -65,7 +64,7 @@ static fn_DisguiseFunc_t   original_DisguiseDrop     = nullptr;
 // Custom property hash
 // ---------------------------------------------------------------------------
 
-static uint32_t g_disguiseModelPropHash = 0;
+static constexpr uint32_t kDisguiseModelPropHash = pbl_hash_ct("DisguiseModel");
 
 // ---------------------------------------------------------------------------
 // Per-class configuration
@@ -158,7 +157,7 @@ static void* getWeaponClass(void* weaponThis)
 static void __fastcall hooked_SetProperty(void* ecx, void* /*edx*/,
                                           unsigned int hash, const char* value)
 {
-    if (hash == g_disguiseModelPropHash && g_disguiseModelPropHash != 0) {
+    if (hash == kDisguiseModelPropHash) {
         if (!value) return;
         DisguiseConfig* cfg = findOrCreateConfig(ecx);
         if (!cfg) return;
@@ -170,7 +169,7 @@ static void __fastcall hooked_SetProperty(void* ecx, void* /*edx*/,
         } else {
             cfg->suppressModel = false;
             strncpy_s(cfg->modelName, sizeof(cfg->modelName), value, _TRUNCATE);
-            cfg->modelNameHash = fn_hash_string(value);
+            cfg->modelNameHash = pbl_hash(value);
         }
         return;
     }
@@ -250,12 +249,9 @@ static void __fastcall hooked_DisguiseDrop(void* ecx, void* edx)
 void disguise_ext_install(uintptr_t exe_base)
 {
     using namespace game_addrs::modtools;
-    fn_hash_string    = (fn_hash_string_t)resolve(exe_base, hash_string);
     fn_hashtable_find = (fn_HashTableFind_t)resolve(exe_base, pbl_hash_table_find);
     g_gameModelTable  = (uint32_t*)resolve(exe_base, game_model_table);
 
-    g_disguiseModelPropHash = fn_hash_string("DisguiseModel");
-
     original_SetProperty    = (fn_SetProperty_t)resolve(exe_base, disguise_set_property);
     original_DisguiseRaise  = (fn_DisguiseFunc_t)resolve(exe_base, disguise_raise);
     original_DisguiseDrop   = (fn_DisguiseFunc_t)resolve(exe_base, disguise_drop);
@@ -1,6 +1,8 @@
 #include "pch.h"
 #include "grappling_hook.hpp"
 #include "core/resolve.hpp"
+#include "entity/entity_sidecar.hpp"
+#include "util/pbl_hash.hpp"
 
 #include <detours.h>
 #include <cmath>
@@ -18,6 +20,16 @@
 //   - Slingshot mechanic: press jump mid-pull to launch with momentum
 //   - Rope cable rendering using OrdnanceTowCable's spline pipeline
 //   - Configurable max range (ODF: MaxRange on ordnance)
+//   - Any number of soldiers, AI included, grappling at once
+//
+// Each grapple's state is a sidecar component on its ordnance
+// (entity_sidecar.hpp), at most kMaxGrapples at a time, so a soldier with
+// two hooks out, or an ordnance at a reused address, gets its own pull.
+// The ordnance's dtor detaches it.  The soldier can be freed first, so its
+// handle key is checked before every use.  The pull — move, stuck / arrival
+// checks, slingshot — is stepped in the ordnance's own Update on the game
+// thread, and a grapple that finishes ends on that same Update.  The cable
+// spline is rebuilt only when one of its endpoints has moved.
 // =============================================================================
 
 // Ordnance offsets
@@ -26,6 +38,7 @@ static constexpr int kOrd_SoldierKey  = 0x58;
 static constexpr int kOrd_Position    = 0x48;   // PblVector3 (hook attachment point)
 static constexpr int kOrd_State       = 0x12C;
 static constexpr int kOrd_ClassPtr    = 0x30;   // OrdnanceClass* pointer
+static constexpr int kOrd_Rso         = 0x98;   // embedded RSO (render hook's this)
 
 // Soldier offsets (from struct_base)
 // The confirmed runtime offsets were found by hooking Trigger::Update
@@ -50,6 +63,9 @@ static constexpr float kArrivalDist   = 3.5f;
 static constexpr float kMaxPullTime   = 10.0f;
 static constexpr int kMaxStuckFrames  = 30;
 
+static constexpr int   kMaxGrapples      = 64;
+static constexpr float kCableRebuildEpsSq = 0.005f * 0.005f;
+
 // ---------------------------------------------------------------------------
 // Function types
 // ---------------------------------------------------------------------------
@@ -64,7 +80,6 @@ typedef unsigned int (__fastcall* fn_CheckFire_t)(void* weapon, void* edx);
 typedef void (__fastcall* fn_TriggerUpdate_t)(uint32_t* trigger, void* edx, uint32_t dt, char buttonDown);
 typedef void (__fastcall* fn_OrdRender_t)(void* rso, void* edx, uint32_t p2, uint32_t p3, uint32_t p4);
 typedef void (__fastcall* fn_SetProperty_t)(void* ecx, void* edx, uint32_t hash, const char* value);
-typedef uint32_t (__cdecl* fn_HashString_t)(const char*);
 
 // Spline builder: __thiscall — ECX = output, RET 0x14 cleans 5 stack params
 typedef void (__fastcall* fn_SplineBuild_t)(float* coefs_out, void* edx, float* start, float* end, float* tan_start, float* tan_end, float length);
@@ -84,18 +99,18 @@ static fn_CheckFire_t   original_CheckFire = nullptr;
 static fn_TriggerUpdate_t original_TriggerUpdate = nullptr;
 static fn_OrdRender_t   original_OrdRender = nullptr;
 static fn_SetProperty_t original_SetProperty = nullptr;
-static fn_HashString_t  fn_HashString      = nullptr;
 static fn_SplineBuild_t fn_SplineBuild     = nullptr;
 static fn_CableRender_t fn_CableRender     = nullptr;
 static fn_VecScale_t    fn_VecScale        = nullptr;
 static uint32_t*        g_rttiHashPtr      = nullptr;
+static void*            g_rsoVtable        = nullptr;
 
 // ---------------------------------------------------------------------------
-// ODF property hashes (computed at install time)
+// ODF property hashes
 // ---------------------------------------------------------------------------
 
-static uint32_t g_hashPullSpeed    = 0;
-static uint32_t g_hashGrappleRange = 0;
+static constexpr uint32_t kHashPullSpeed    = pbl_hash_ct("PullSpeed");
+static constexpr uint32_t kHashGrappleRange = pbl_hash_ct("GrappleRange");
 
 // ODF-configurable values (stored per class, but only one grapple class exists)
 static float g_odfPullSpeed = kDefaultPullSpeed;
@@ -108,14 +123,14 @@ static float g_odfMaxRange  = kDefaultMaxRange;
 static void __fastcall hooked_SetProperty(void* ecx, void* /*edx*/,
                                           uint32_t hash, const char* value)
 {
-   if (hash == g_hashPullSpeed && g_hashPullSpeed != 0 && value && value[0]) {
+   if (hash == kHashPullSpeed && value && value[0]) {
       g_odfPullSpeed = (float)atof(value);
       if (g_odfPullSpeed < 0.1f) g_odfPullSpeed = kDefaultPullSpeed;
       // Still pass to base class in case it uses a property with the same hash
       original_SetProperty(ecx, nullptr, hash, value);
       return;
    }
-   if (hash == g_hashGrappleRange && g_hashGrappleRange != 0 && value && value[0]) {
+   if (hash == kHashGrappleRange && value && value[0]) {
       g_odfMaxRange = (float)atof(value);
       if (g_odfMaxRange < 0.0f) g_odfMaxRange = 0.0f;
       original_SetProperty(ecx, nullptr, hash, value);
@@ -137,48 +152,69 @@ static void __fastcall hooked_005297b0(void* soldier, void* /*edx*/, int value)
 }
 
 // ---------------------------------------------------------------------------
-// State
+// State — one per grapple ordnance
 // ---------------------------------------------------------------------------
 
-static bool    g_grappleActive  = false;
-static bool    g_wasPulling     = false;
-static void*   g_soldierPtr     = nullptr;
-static int     g_soldierKey     = 0;
-static float   g_pullTimer      = 0.0f;
-static float   g_lastDist       = 999999.0f;
-static int     g_stuckFrames    = 0;
-static uint8_t g_savedFlagByte  = 0;
-static bool    g_arrivedClean   = false;
-static bool    g_slingshotRequested = false;
-
-// Current pull direction (normalized) — used for slingshot momentum
-static float g_pullDirX = 0.0f;
-static float g_pullDirY = 0.0f;
-static float g_pullDirZ = 0.0f;
-
-// Hook head position — cached during Update for the render hook
-static float g_hookPosX = 0.0f;
-static float g_hookPosY = 0.0f;
-static float g_hookPosZ = 0.0f;
-
-// Fire origin — cached when grapple first fires, for max range check
-static float g_fireOriginX = 0.0f;
-static float g_fireOriginY = 0.0f;
-static float g_fireOriginZ = 0.0f;
-
-// Dummy soldier buffer
+struct GrappleState {
+   void*    soldier;              // firing soldier; check soldierKey before use
+   int      soldierKey;
+   float    pullTimer;
+   float    lastDist;
+   int      stuckFrames;
+   uint8_t  savedFlagByte;
+   bool     wasPulling;
+   bool     finished;             // Update returns 0 (ends the grapple)
+   bool     arrivedClean;
+   bool     slingshotRequested;
+
+   // Current pull direction (normalized) — used for slingshot momentum
+   float    pullDir[3];
+
+   // Hook head position — cached during Update for the pull and render
+   float    hookPos[3];
+
+   // Fire origin — cached when grapple first fires, for max range check
+   float    fireOrigin[3];
+
+   // Cable spline, rebuilt when an endpoint moves
+   bool     cableValid;
+   float    cableStart[3];
+   float    cableEnd[3];
+   float    cableCoefs[12];
+};
+
+static SidecarComponent<GrappleState> s_grapple;
+
+// Dummy soldier buffer.  The engine only sees it for the duration of one
+// original Update / Dtor call, so a single buffer serves every grapple.
 static uint8_t g_dummySoldier[0x500] = {};
 
+// Soldier still the one that fired (its handle key hasn't moved on)
+static bool soldier_alive(const GrappleState* g)
+{
+   __try {
+      return *(int*)((char*)g->soldier + kSol_HandleKey) == g->soldierKey;
+   } __except (EXCEPTION_EXECUTE_HANDLER) {
+      return false;
+   }
+}
+
 // ---------------------------------------------------------------------------
 // Hook: Trigger::Update — intercepts jump button input at the source.
 // ---------------------------------------------------------------------------
 
 static void __fastcall hooked_TriggerUpdate(uint32_t* trigger, void* /*edx*/, uint32_t dt, char buttonDown)
 {
-   if (g_grappleActive && g_soldierPtr && g_wasPulling && buttonDown) {
-      uint32_t* jumpTriggerPtr = (uint32_t*)((char*)g_soldierPtr + kSol_JumpTrigger);
-      if (trigger == jumpTriggerPtr) {
-         g_slingshotRequested = true;
+   if (buttonDown && s_grapple.count()) {
+      // A soldier's jump trigger lives at +kSol_JumpTrigger; anything else
+      // matches no grapple.  Every hook the soldier is pulling on lets go.
+      void* soldierPtr = (char*)trigger - kSol_JumpTrigger;
+      const int count = s_grapple.count();
+      for (int i = 0; i < count; i++) {
+         GrappleState* g = s_grapple.at(i);
+         if (g->soldier == soldierPtr && g->wasPulling) {
+            g->slingshotRequested = true;
+         }
       }
    }
    original_TriggerUpdate(trigger, nullptr, dt, buttonDown);
@@ -188,24 +224,36 @@ static void __fastcall hooked_TriggerUpdate(uint32_t* trigger, void* /*edx*/, ui
 // Hook: OrdnanceGrapplingHook RSO Render — draws hook model + rope cable.
 // ---------------------------------------------------------------------------
 
+static inline bool moved(const float* a, const float* b)
+{
+   float dx = a[0] - b[0], dy = a[1] - b[1], dz = a[2] - b[2];
+   return dx * dx + dy * dy + dz * dz > kCableRebuildEpsSq;
+}
+
 static void __fastcall hooked_OrdRender(void* rso, void* /*edx*/, uint32_t p2, uint32_t p3, uint32_t p4)
 {
    original_OrdRender(rso, nullptr, p2, p3, p4);
 
-   if (!g_grappleActive || !g_soldierPtr)
-      return;
-   if (g_hookPosX == 0.0f && g_hookPosY == 0.0f && g_hookPosZ == 0.0f)
+   if (!s_grapple.count())
       return;
 
    __try {
-      float* solPos = (float*)((char*)g_soldierPtr + kSol_Position);
+      char* ord = (char*)rso - kOrd_Rso;
+      GrappleState* g = s_grapple.get(ord);
+      if (!g || !soldier_alive(g))
+         return;
+      void* soldierPtr = g->soldier;
+      if (g->hookPos[0] == 0.0f && g->hookPos[1] == 0.0f && g->hookPos[2] == 0.0f)
+         return;
+
+      float* solPos = (float*)((char*)soldierPtr + kSol_Position);
       // Get cable start from weapon's mFirePointMatrix (hp_fire world position).
       // Same approach as SetBarrelFireOrigin: weapon+0x50 = mFirePointMatrix.trans
       float startPos[3] = { solPos[0], solPos[1] + 1.5f, solPos[2] };  // fallback
       {
-         uint8_t slotIdx = *(uint8_t*)((char*)g_soldierPtr + 0x752);
+         uint8_t slotIdx = *(uint8_t*)((char*)soldierPtr + 0x752);
          if (slotIdx < 8) {
-            void* weapon = *(void**)((char*)g_soldierPtr + 0x730 + slotIdx * 4);
+            void* weapon = *(void**)((char*)soldierPtr + 0x730 + slotIdx * 4);
             if (weapon) {
                float* firePos = (float*)((char*)weapon + 0x50);
                uint32_t raw = *(uint32_t*)&firePos[0];
@@ -217,16 +265,20 @@ static void __fastcall hooked_OrdRender(void* rso, void* /*edx*/, uint32_t p2, u
             }
          }
       }
-      float hookPos[3] = { g_hookPosX, g_hookPosY, g_hookPosZ };
-
-      float startTangent[3] = { 0.0f, 0.0f, 0.0f };
-      float upDir[3] = { 0.0f, 1.0f, 0.0f };
-      float endTangent[3];
-      fn_VecScale(endTangent, -15.0f, upDir);
 
-      float coefs[12];
-      fn_SplineBuild(coefs, nullptr, startPos, hookPos, startTangent, endTangent, 1.0f);
-      fn_CableRender(coefs, p2, p3, 0.3f);
+      if (!g->cableValid || moved(startPos, g->cableStart) || moved(g->hookPos, g->cableEnd)) {
+         float startTangent[3] = { 0.0f, 0.0f, 0.0f };
+         float upDir[3] = { 0.0f, 1.0f, 0.0f };
+         float endTangent[3];
+         fn_VecScale(endTangent, -15.0f, upDir);
+
+         float hookPos[3] = { g->hookPos[0], g->hookPos[1], g->hookPos[2] };
+         fn_SplineBuild(g->cableCoefs, nullptr, startPos, hookPos, startTangent, endTangent, 1.0f);
+         memcpy(g->cableStart, startPos, sizeof(startPos));
+         memcpy(g->cableEnd, hookPos, sizeof(hookPos));
+         g->cableValid = true;
+      }
+      fn_CableRender(g->cableCoefs, p2, p3, 0.3f);
    }
    __except (EXCEPTION_EXECUTE_HANDLER) {}
 }
@@ -244,7 +296,7 @@ static unsigned int __fastcall hooked_CheckFire(void* weapon, void* /*edx*/)
 // Helpers
 // ---------------------------------------------------------------------------
 
-static float distance_to_hook(void* soldierPtr, float* hookPos)
+static float distance_to_hook(void* soldierPtr, const float* hookPos)
 {
    float* solPos = (float*)((char*)soldierPtr + kSol_Position);
    float dx = hookPos[0] - solPos[0];
@@ -253,20 +305,20 @@ static float distance_to_hook(void* soldierPtr, float* hookPos)
    return sqrtf(dx * dx + dy * dy + dz * dz);
 }
 
-static void move_soldier_toward(void* soldierPtr, float* hookPos, float dt)
+static void move_soldier_toward(GrappleState* g, void* soldierPtr, float dt)
 {
    float* solPos = (float*)((char*)soldierPtr + kSol_Position);
 
-   float dx = hookPos[0] - solPos[0];
-   float dy = hookPos[1] - solPos[1];
-   float dz = hookPos[2] - solPos[2];
+   float dx = g->hookPos[0] - solPos[0];
+   float dy = g->hookPos[1] - solPos[1];
+   float dz = g->hookPos[2] - solPos[2];
 
    float dist = sqrtf(dx * dx + dy * dy + dz * dz);
    if (dist < 0.01f) return;
 
-   g_pullDirX = dx / dist;
-   g_pullDirY = dy / dist;
-   g_pullDirZ = dz / dist;
+   g->pullDir[0] = dx / dist;
+   g->pullDir[1] = dy / dist;
+   g->pullDir[2] = dz / dist;
 
    float move = g_odfPullSpeed * dt;
    if (move > dist) move = dist;
@@ -289,13 +341,13 @@ static void move_soldier_toward(void* soldierPtr, float* hookPos, float dt)
 
 static constexpr float kSlingshotMultiplier = 1.8f;
 
-static void apply_slingshot(void* soldierPtr)
+static void apply_slingshot(const GrappleState* g, void* soldierPtr)
 {
    float speed = g_odfPullSpeed * kSlingshotMultiplier;
    float vel[3] = {
-      g_pullDirX * speed,
-      g_pullDirY * speed,
-      g_pullDirZ * speed
+      g->pullDir[0] * speed,
+      g->pullDir[1] * speed,
+      g->pullDir[2] * speed
    };
 
    __try {
@@ -310,6 +362,48 @@ static void apply_slingshot(void* soldierPtr)
    }
 }
 
+// ---------------------------------------------------------------------------
+// Pull step — one grapple, from its ordnance's Update
+// ---------------------------------------------------------------------------
+
+static void step_pull(GrappleState* g, void* soldierPtr, float dt)
+{
+   g->pullTimer += dt;
+
+   float dist = distance_to_hook(soldierPtr, g->hookPos);
+   uint8_t* flagPtr = (uint8_t*)((char*)soldierPtr + kSol_FlagByte);
+
+   // Slingshot: jump during pull
+   if (g->slingshotRequested && g->pullTimer > 0.2f) {
+      *flagPtr = g->savedFlagByte;
+      g->finished = true;
+      return;
+   }
+
+   move_soldier_toward(g, soldierPtr, dt);
+
+   // Stuck detection — tolerance scales with pull speed to avoid
+   // false positives at low speeds (at 1 m/s, per-frame movement
+   // is ~0.017m which would always fail a fixed 0.1m check)
+   float stuckTolerance = g_odfPullSpeed * dt * 0.5f;
+   if (stuckTolerance < 0.01f) stuckTolerance = 0.01f;
+   if (dist >= g->lastDist - stuckTolerance)
+      g->stuckFrames++;
+   else
+      g->stuckFrames = 0;
+   g->lastDist = dist;
+
+   // Arrival / stuck / timeout (timeout scales so slow pulls aren't cut short)
+   float maxTime = (g_odfMaxRange > 0.0f)
+      ? (g_odfMaxRange / g_odfPullSpeed) + 2.0f
+      : kMaxPullTime;
+   if (dist < kArrivalDist || g->stuckFrames > kMaxStuckFrames || g->pullTimer > maxTime) {
+      *flagPtr = g->savedFlagByte;
+      g->arrivedClean = true;
+      g->finished = true;
+   }
+}
+
 // ---------------------------------------------------------------------------
 // Hook: OrdnanceGrapplingHook destructor body
 // ---------------------------------------------------------------------------
@@ -321,10 +415,12 @@ static void __fastcall hooked_Dtor(void* ecx, void* /*edx*/)
    void* savedHandle = *(void**)(ord + kOrd_SoldierPtr);
    int   savedKey    = *(int*)(ord + kOrd_SoldierKey);
 
-   if (savedHandle && g_soldierPtr) {
+   GrappleState* g = s_grapple.get(ord);
+
+   if (savedHandle && g) {
       memset(g_dummySoldier, 0, sizeof(g_dummySoldier));
       *(int*)(g_dummySoldier + kSol_HandleKey) = savedKey;
-      *(void**)g_dummySoldier = *(void**)g_soldierPtr;
+      *(void**)g_dummySoldier = *(void**)savedHandle;
       *(void**)(ord + kOrd_SoldierPtr) = g_dummySoldier;
    }
 
@@ -333,14 +429,14 @@ static void __fastcall hooked_Dtor(void* ecx, void* /*edx*/)
    *(void**)(ord + kOrd_SoldierPtr) = savedHandle;
    *(int*)(ord + kOrd_SoldierKey) = savedKey;
 
-   if (!g_grappleActive || !g_soldierPtr) {
-      g_grappleActive = false;
+   // Sidecar blobs can move while the engine runs; look it up again
+   g = s_grapple.get(ord);
+   if (!g)
       return;
-   }
 
    __try {
-      void* soldierPtr = g_soldierPtr;
-      if (*(int*)((char*)soldierPtr + kSol_HandleKey) != g_soldierKey)
+      void* soldierPtr = g->soldier;
+      if (!soldier_alive(g))
          goto done;
 
       void** vtable = *(void***)soldierPtr;
@@ -348,14 +444,14 @@ static void __fastcall hooked_Dtor(void* ecx, void* /*edx*/)
       bool isSoldier = ((fn_IsRtti_t)vtable[0])(soldierPtr, nullptr, *g_rttiHashPtr);
       if (!isSoldier) goto done;
 
-      *(uint8_t*)((char*)soldierPtr + kSol_FlagByte) = g_savedFlagByte;
+      *(uint8_t*)((char*)soldierPtr + kSol_FlagByte) = g->savedFlagByte;
 
       void* collBody = (char*)soldierPtr + kSol_CollBody;
       fn_RemoveBody(collBody);
       fn_AddItemBody(collBody);
 
-      if (!g_arrivedClean && (g_pullDirX != 0 || g_pullDirY != 0 || g_pullDirZ != 0)) {
-         apply_slingshot(soldierPtr);
+      if (!g->arrivedClean && (g->pullDir[0] != 0 || g->pullDir[1] != 0 || g->pullDir[2] != 0)) {
+         apply_slingshot(g, soldierPtr);
       }
    }
    __except (EXCEPTION_EXECUTE_HANDLER) {
@@ -363,11 +459,7 @@ static void __fastcall hooked_Dtor(void* ecx, void* /*edx*/)
    }
 
 done:
-   g_grappleActive = false;
-   g_wasPulling = false;
-   g_arrivedClean = false;
-   g_soldierPtr = nullptr;
-   g_soldierKey = 0;
+   s_grapple.detach(ord);
 }
 
 // ---------------------------------------------------------------------------
@@ -378,43 +470,38 @@ static unsigned int __fastcall hooked_Update(void* ecx, void* /*edx*/, float dt)
 {
    char* ord = (char*)ecx;
 
-   int   stateBefore = *(int*)(ord + kOrd_State);
    void* soldierPtr  = *(void**)(ord + kOrd_SoldierPtr);
    int   soldierKey  = *(int*)(ord + kOrd_SoldierKey);
 
-   // Track the soldier across frames
-   if (soldierPtr && !g_grappleActive) {
-      g_soldierPtr = soldierPtr;
-      g_soldierKey = soldierKey;
-      g_grappleActive = true;
-      g_wasPulling = false;
-      g_arrivedClean = false;
-      g_slingshotRequested = false;
-      g_pullTimer = 0.0f;
-      g_lastDist = 999999.0f;
-      g_stuckFrames = 0;
-      g_pullDirX = g_pullDirY = g_pullDirZ = 0.0f;
-      g_hookPosX = g_hookPosY = g_hookPosZ = 0.0f;
-      __try {
-         g_savedFlagByte = *(uint8_t*)((char*)soldierPtr + kSol_FlagByte);
-         // Cache fire origin for max range check
-         float* solPos = (float*)((char*)soldierPtr + kSol_Position);
-         g_fireOriginX = solPos[0];
-         g_fireOriginY = solPos[1];
-         g_fireOriginZ = solPos[2];
-      } __except (EXCEPTION_EXECUTE_HANDLER) {}
+   // Track the grapple across frames.  Each ordnance owns its own pull, so
+   // a soldier with two hooks out is pulled by both.
+   GrappleState* g = nullptr;
+   if (soldierPtr) {
+      bool created = false;
+      g = s_grapple.attach(ord, &created);
+      if (created) {
+         g->soldier    = soldierPtr;
+         g->soldierKey = soldierKey;
+         g->lastDist   = 999999.0f;
+         __try {
+            g->savedFlagByte = *(uint8_t*)((char*)soldierPtr + kSol_FlagByte);
+            // Cache fire origin for max range check
+            float* solPos = (float*)((char*)soldierPtr + kSol_Position);
+            g->fireOrigin[0] = solPos[0];
+            g->fireOrigin[1] = solPos[1];
+            g->fireOrigin[2] = solPos[2];
+         } __except (EXCEPTION_EXECUTE_HANDLER) {}
+      }
    }
 
+   if (g && g->finished)
+      return 0;
+
    // Fix RSO vtable: the constructor sets 0x00A50E98 (with the grapple render
    // at slot 19) but something post-construction overwrites it to 0x00A50D40
    // (base class vtable without the grapple render). Force the correct vtable.
-   {
-      void** rsoVtable = *(void***)(ord + 0x98);
-      uintptr_t base = (uintptr_t)GetModuleHandleW(nullptr);
-      void* correctVtable = resolve(base, game_addrs::modtools::grapple_rso_vtable);
-      if (rsoVtable != (void**)correctVtable) {
-         *(void**)(ord + 0x98) = correctVtable;
-      }
+   if (*(void**)(ord + kOrd_Rso) != g_rsoVtable) {
+      *(void**)(ord + kOrd_Rso) = g_rsoVtable;
    }
 
    // Force collision-enabled flag bit0 on
@@ -434,8 +521,8 @@ static unsigned int __fastcall hooked_Update(void* ecx, void* /*edx*/, float dt)
 
    memset(g_dummySoldier, 0, sizeof(g_dummySoldier));
    *(int*)(g_dummySoldier + kSol_HandleKey) = savedKey;
-   if (g_soldierPtr) {
-      *(void**)g_dummySoldier = *(void**)g_soldierPtr;
+   if (savedHandle) {
+      *(void**)g_dummySoldier = *(void**)savedHandle;
    }
 
    *(void**)(ord + kOrd_SoldierPtr) = g_dummySoldier;
@@ -446,28 +533,31 @@ static unsigned int __fastcall hooked_Update(void* ecx, void* /*edx*/, float dt)
    *(void**)(ord + kOrd_SoldierPtr) = savedHandle;
    *(int*)(ord + kOrd_SoldierKey) = savedKey;
 
+   // Sidecar blobs can move while the engine runs; look it up again
+   if (g) g = s_grapple.get(ord);
+   if (!g)
+      return result;
+
    int stateAfter = *(int*)(ord + kOrd_State);
 
-   // Cache hook position every frame for the render hook
+   // Cache hook position every frame for the pull and render hook
    {
       float* hookPos = (float*)(ord + kOrd_Position);
-      g_hookPosX = hookPos[0];
-      g_hookPosY = hookPos[1];
-      g_hookPosZ = hookPos[2];
+      g->hookPos[0] = hookPos[0];
+      g->hookPos[1] = hookPos[1];
+      g->hookPos[2] = hookPos[2];
    }
 
    // --- Safety checks ---
 
-   if (g_grappleActive && g_soldierPtr) {
-      __try {
-         if (*(int*)((char*)g_soldierPtr + kSol_HandleKey) != g_soldierKey)
-            return 0;
-         int solState = *(int*)((char*)g_soldierPtr + 0x754);
-         if (solState >= 10)
-            return 0;
-      } __except (EXCEPTION_EXECUTE_HANDLER) {
+   if (!soldier_alive(g))
+      return 0;
+   __try {
+      int solState = *(int*)((char*)g->soldier + 0x754);
+      if (solState >= 10)
          return 0;
-      }
+   } __except (EXCEPTION_EXECUTE_HANDLER) {
+      return 0;
    }
 
    // State 4 (failure/retraction): kill immediately
@@ -475,63 +565,27 @@ static unsigned int __fastcall hooked_Update(void* ecx, void* /*edx*/, float dt)
       return 0;
 
    // Max range check during flight (before pull)
-   if (g_odfMaxRange > 0.0f && stateAfter != kState_Pulling && g_grappleActive) {
-      float dx = g_hookPosX - g_fireOriginX;
-      float dy = g_hookPosY - g_fireOriginY;
-      float dz = g_hookPosZ - g_fireOriginZ;
+   if (g_odfMaxRange > 0.0f && stateAfter != kState_Pulling) {
+      float dx = g->hookPos[0] - g->fireOrigin[0];
+      float dy = g->hookPos[1] - g->fireOrigin[1];
+      float dz = g->hookPos[2] - g->fireOrigin[2];
       float rangeSq = dx*dx + dy*dy + dz*dz;
       if (rangeSq > g_odfMaxRange * g_odfMaxRange)
          return 0;
    }
 
-   // Track if we're in pull state (for slingshot detection in destructor)
+   // Pulling: move the soldier now; arrival ends the grapple this Update
    if (stateAfter == kState_Pulling) {
-      g_wasPulling = true;
-   }
-
-   // Custom pull logic during state 2
-   if (stateAfter == kState_Pulling && g_soldierPtr) {
-      g_pullTimer += dt;
-
+      g->wasPulling = true;
       __try {
-         float* hookPos = (float*)(ord + kOrd_Position);
-         float dist = distance_to_hook(g_soldierPtr, hookPos);
-
-         uint8_t* flagPtr = (uint8_t*)((char*)g_soldierPtr + kSol_FlagByte);
-
-         // Slingshot: jump during pull
-         if (g_slingshotRequested && g_pullTimer > 0.2f) {
-            *flagPtr = g_savedFlagByte;
-            return 0;
-         }
-
-         move_soldier_toward(g_soldierPtr, hookPos, dt);
-
-         // Stuck detection — tolerance scales with pull speed to avoid
-         // false positives at low speeds (at 1 m/s, per-frame movement
-         // is ~0.017m which would always fail a fixed 0.1m check)
-         float stuckTolerance = g_odfPullSpeed * dt * 0.5f;
-         if (stuckTolerance < 0.01f) stuckTolerance = 0.01f;
-         if (dist >= g_lastDist - stuckTolerance)
-            g_stuckFrames++;
-         else
-            g_stuckFrames = 0;
-         g_lastDist = dist;
-
-         // Arrival / stuck / timeout (timeout scales so slow pulls aren't cut short)
-         float maxTime = (g_odfMaxRange > 0.0f)
-            ? (g_odfMaxRange / g_odfPullSpeed) + 2.0f
-            : kMaxPullTime;
-         if (dist < kArrivalDist || g_stuckFrames > kMaxStuckFrames || g_pullTimer > maxTime) {
-            *flagPtr = g_savedFlagByte;
-            g_arrivedClean = true;
-            return 0;
-         }
+         step_pull(g, g->soldier, dt);
       }
       __except (EXCEPTION_EXECUTE_HANDLER) {
          get_gamelog()("[Grapple] EXCEPTION in pull logic\n");
-         return 0;
+         g->finished = true;
       }
+      if (g->finished)
+         return 0;
    }
 
    return result;
@@ -554,14 +608,13 @@ void grapple_fix_install(uintptr_t exe_base)
    original_TriggerUpdate = (fn_TriggerUpdate_t) resolve(exe_base, trigger_update);
    original_OrdRender = (fn_OrdRender_t) resolve(exe_base, grapple_ord_render);
    original_SetProperty = (fn_SetProperty_t) resolve(exe_base, grapple_set_property);
-   fn_HashString    = (fn_HashString_t)  resolve(exe_base, hash_string);
    fn_SplineBuild   = (fn_SplineBuild_t) resolve(exe_base, spline_build);
    fn_CableRender   = (fn_CableRender_t) resolve(exe_base, cable_render);
    fn_VecScale      = (fn_VecScale_t)    resolve(exe_base, vec_scale);
+   g_rsoVtable      = resolve(exe_base, grapple_rso_vtable);
 
-   // Compute property hashes
-   g_hashPullSpeed    = fn_HashString("PullSpeed");
-   g_hashGrappleRange = fn_HashString("GrappleRange");
+   // Ordnance isn't an Entity (no handle id); hooked_Dtor detaches it
+   s_grapple.init("Grapple", kMaxGrapples, nullptr, false);
 
    DetourTransactionBegin();
    DetourUpdateThread(GetCurrentThread());
@@ -8,7 +8,8 @@
 // The engine's OrdnanceGrapplingHook::Update removes the soldier's collision
 // body on arrival and replaces it with a soft body, leaving the soldier stuck.
 // This hook wraps Update and restores normal collision after a successful
-// grapple arrival.
+// grapple arrival.  State is kept per grapple ordnance, so players and AI
+// can all grapple at once.
 //
 // Call grapple_fix_install()   from lua_hooks_install().
 // Call grapple_fix_uninstall() from lua_hooks_uninstall().
@@ -16,8 +16,12 @@ int main(int arg_count, const char** args)
 
    init_cstdio();
 
+   if (arg_count == 3 and strcmp(args[1], "/batch") == 0) {
+      return apply_batch(args[2], printf) ? 0 : 1;
+   }
+
    if (arg_count != 2 or strcmp(args[1], "/?") == 0) {
-      printf("Usage: <file>\r\n");
+      printf("Usage: <file>\r\n       /batch <directory>\r\n");
 
       return 1;
    }
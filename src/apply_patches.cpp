@@ -1,63 +1,97 @@
+#ifdef _MSC_VER
+#pragma warning(disable : 4530)
+#endif
+
+#include "apply_patches.hpp"
 #include "compatibility_list.hpp"
 #include "exe_patcher.hpp"
-#include "file_helpers.hpp"
 
+#include <stdarg.h>
 #include <stdio.h>
 #include <string.h>
 
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
 const char* PATCH_DLL_NAME = "BF2GameExt.dll";
 
-bool apply(const char* file_path, int (*print)(const char* format, ...)) noexcept
+namespace fs = std::filesystem;
+
+static bool file_exists(const char* file)
 {
-   if (not print) print = printf;
+   std::error_code error;
 
-   if (not file_exists(PATCH_DLL_NAME)) {
-      print("%s is missing. Patching depends on this file and can't not work without.\r\n", PATCH_DLL_NAME);
+   return fs::exists(file, error);
+}
 
-      return false;
-   }
+static bool copy_next_to(const char* src_file, const char* dest_file_name)
+{
+   std::error_code error;
+
+   const fs::path dest_path = fs::path{dest_file_name}.parent_path() / src_file;
+
+   if (fs::equivalent(src_file, dest_path, error)) return true;
+
+   return fs::copy_file(src_file, dest_path, fs::copy_options::overwrite_existing, error);
+}
 
+enum class patch_result { patched, unidentified, failed };
+
+static patch_result patch_executable(const char* file_path, int (*print)(const char* format, ...),
+                                     bool copy_dll) noexcept
+{
    exe_patcher editor;
+   bool not_an_image = false;
+
+   if (not editor.load(file_path, &not_an_image)) {
+      if (not_an_image) {
+         print("%s isn't a PE32 executable. Unable to patch.\r\n", file_path);
+
+         return patch_result::unidentified;
+      }
 
-   if (not editor.load(file_path)) {
       print("Failed to open %s for patching.\r\n", file_path);
 
-      return false;
+      return patch_result::failed;
    }
 
    bool is_compatible = false;
 
    for (const compatibile_exe& exe : compatibility_list) {
-      if (not editor.compatible(exe.id_address, exe.expected_id)) {
+      if (editor.compatible(exe.id_address, exe.expected_id)) {
+         print("Identified executable as: %s. Applying patches.\r\n", exe.name);
 
-         continue;
-      }
-
-      print("Identified executable as: %s. Applying patches.\r\n", exe.name);
-
-      is_compatible = true;
+         is_compatible = true;
 
-      break;
+         break;
+      }
    }
 
    if (not is_compatible) {
       print("Couldn't identify executable. Unable to patch.\r\n");
 
-      return false;
+      return patch_result::unidentified;
    }
 
    if (not editor.add_dll(PATCH_DLL_NAME)) {
       print("Failed to add DLL import to executable.\r\n");
 
-      return false;
+      return patch_result::failed;
    }
 
-   print("Copying %s to game directory.\r\n", PATCH_DLL_NAME);
+   if (copy_dll) {
+      print("Copying %s to game directory.\r\n", PATCH_DLL_NAME);
 
-   if (not copy_next_to(PATCH_DLL_NAME, file_path)) {
-      print("Failed to copy patch DLL (%s) to game directory.\r\n", PATCH_DLL_NAME);
+      if (not copy_next_to(PATCH_DLL_NAME, file_path)) {
+         print("Failed to copy patch DLL (%s) to game directory.\r\n", PATCH_DLL_NAME);
 
-      return false;
+         return patch_result::failed;
+      }
    }
 
    print("Saving patched game executable.\r\n");
@@ -65,10 +99,158 @@ bool apply(const char* file_path, int (*print)(const char* format, ...)) noexcep
    if (not editor.save(file_path)) {
       print("Failed to save %s after patching.\r\n", file_path);
 
-      return false;
+      return patch_result::failed;
    }
 
    print("Patching succeeded.\r\n");
 
+   return patch_result::patched;
+}
+
+bool apply(const char* file_path, int (*print)(const char* format, ...)) noexcept
+{
+   if (not print) print = printf;
+
+   if (not file_exists(PATCH_DLL_NAME)) {
+      print("%s is missing. Patching depends on this file and can't not work without.\r\n", PATCH_DLL_NAME);
+
+      return false;
+   }
+
+   return patch_executable(file_path, print, true) == patch_result::patched;
+}
+
+// Each batch worker collects a file's log here and prints it in one go.
+static thread_local std::string batch_log;
+
+static int batch_print(const char* format, ...)
+{
+   va_list args;
+   va_start(args, format);
+
+   va_list measure_args;
+   va_copy(measure_args, args);
+   const int length = vsnprintf(nullptr, 0, format, measure_args);
+   va_end(measure_args);
+
+   if (length > 0) {
+      const size_t start = batch_log.size();
+
+      batch_log.resize(start + (size_t)length + 1);
+      vsnprintf(&batch_log[start], (size_t)length + 1, format, args);
+      batch_log.resize(start + (size_t)length);
+   }
+
+   va_end(args);
+
+   return length;
+}
+
+static bool is_executable(const fs::directory_entry& entry)
+{
+   std::error_code error;
+
+   if (not entry.is_regular_file(error)) return false;
+
+   const std::string extension = entry.path().extension().string();
+   const std::string file_name = entry.path().filename().string();
+
+   if (extension.size() != 4) return false;
+   if (file_name == "BF2GameExt.exe") return false; // the patcher itself
+
+   for (size_t i = 0; i < 4; ++i) {
+      const char c = extension[i] >= 'A' and extension[i] <= 'Z' ? extension[i] + ('a' - 'A') : extension[i];
+
+      if (c != ".exe"[i]) return false;
+   }
+
    return true;
-}
\ No newline at end of file
+}
+
+bool apply_batch(const char* directory_path, int (*print)(const char* format, ...)) noexcept
+{
+   using clock = std::chrono::steady_clock;
+
+   if (not print) print = printf;
+
+   if (not file_exists(PATCH_DLL_NAME)) {
+      print("%s is missing. Patching depends on this file and can't not work without.\r\n", PATCH_DLL_NAME);
+
+      return false;
+   }
+
+   std::vector<std::string> files;
+   std::error_code error;
+
+   for (fs::directory_iterator it{directory_path, error}, end; not error and it != end; it.increment(error)) {
+      if (is_executable(*it)) files.push_back(it->path().string());
+   }
+
+   if (error) {
+      print("Failed to list %s.\r\n", directory_path);
+
+      return false;
+   }
+
+   if (files.empty()) {
+      print("No executables found in %s.\r\n", directory_path);
+
+      return false;
+   }
+
+   print("Copying %s to %s.\r\n", PATCH_DLL_NAME, directory_path);
+
+   if (not copy_next_to(PATCH_DLL_NAME, files[0].c_str())) {
+      print("Failed to copy patch DLL (%s) to %s.\r\n", PATCH_DLL_NAME, directory_path);
+
+      return false;
+   }
+
+   const size_t hardware_threads = std::thread::hardware_concurrency();
+   const size_t thread_count = hardware_threads == 0             ? 1
+                               : hardware_threads < files.size() ? hardware_threads
+                                                                 : files.size();
+
+   std::atomic<size_t> next_file = 0;
+   std::atomic<size_t> patched_count = 0;
+   std::atomic<size_t> skipped_count = 0;
+   std::mutex print_mutex;
+
+   const auto batch_start = clock::now();
+
+   auto worker = [&] {
+      for (size_t i = next_file++; i < files.size(); i = next_file++) {
+         batch_log.clear();
+
+         const auto start = clock::now();
+         const patch_result result = patch_executable(files[i].c_str(), batch_print, false);
+         const double ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+
+         if (result == patch_result::patched) patched_count += 1;
+         if (result == patch_result::unidentified) skipped_count += 1;
+
+         std::lock_guard lock{print_mutex};
+
+         print("%s\r\n%s%s in %.1f ms\r\n\r\n", files[i].c_str(), batch_log.c_str(),
+               result == patch_result::patched ? "Patched"
+               : result == patch_result::unidentified ? "Skipped"
+                                                      : "Failed",
+               ms);
+      }
+   };
+
+   std::vector<std::thread> threads;
+
+   for (size_t i = 1; i < thread_count; ++i) threads.emplace_back(worker);
+
+   worker();
+
+   for (std::thread& thread : threads) thread.join();
+
+   const double batch_ms = std::chrono::duration<double, std::milli>(clock::now() - batch_start).count();
+
+   print("%zu of %zu executables patched, %zu skipped as unidentified, in %.1f ms (%zu threads).\r\n",
+         patched_count.load(), files.size(), skipped_count.load(), batch_ms, thread_count);
+
+   return patched_count + skipped_count == files.size();
+}
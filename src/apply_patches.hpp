@@ -1,3 +1,9 @@
 #pragma once
 
 [[nodiscard]] bool apply(const char* file_path, int (*print)(const char* format, ...)) noexcept;
+
+/// @brief Patch every .exe in a directory, several at a time, printing each file's log and timing.
+/// @param directory_path The directory to patch executables in.
+/// @param print The function to print with. Calls are serialized.
+/// @return If no executable failed to patch. Ones that aren't a supported build are skipped.
+[[nodiscard]] bool apply_batch(const char* directory_path, int (*print)(const char* format, ...)) noexcept;
@@ -1,129 +1,127 @@
 #include "exe_patcher.hpp"
-#include "file_helpers.hpp"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-#define WIN32_LEAN_AND_MEAN
-#include <Windows.h>
+static char* copy_string(const char* string)
+{
+   const size_t size = strlen(string) + 1;
+   char* copy = (char*)malloc(size);
+
+   if (copy) memcpy(copy, string, size);
 
-#include <detours.h>
+   return copy;
+}
 
 exe_patcher::~exe_patcher()
 {
-   if (_data) delete[] _data;
-   if (_detour_binary) DetourBinaryClose(_detour_binary);
+   if (_file_path) free(_file_path);
 }
 
-bool exe_patcher::load(const char* file_path)
+bool exe_patcher::load(const char* file_path, bool* not_an_image)
 {
-   HANDLE file = CreateFileA(file_path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
-                             FILE_ATTRIBUTE_NORMAL, nullptr);
-
-   if (file == INVALID_HANDLE_VALUE) return false;
-
-   bool result = false;
-   LARGE_INTEGER file_size = {};
-   DWORD read_bytes = 0;
+   if (not_an_image) *not_an_image = false;
 
-   _detour_binary = DetourBinaryOpen(file);
+   if (not _file.open_read(file_path)) return false;
 
-   if (_detour_binary == nullptr) goto cleanup;
+   if (not _image.parse(_file.data(), _file.size())) {
+      _file.close();
 
-   if (SetFilePointer(file, 0, nullptr, FILE_BEGIN) == INVALID_SET_FILE_POINTER) {
-      goto cleanup;
-   }
+      if (not_an_image) *not_an_image = true;
 
-   if (not GetFileSizeEx(file, &file_size)) {
-      goto cleanup;
-   }
-
-   if (file_size.QuadPart > UINT32_MAX) goto cleanup;
-
-   _size = (size_t)file_size.QuadPart;
-   _data = new uint8_t[_size];
-
-   if (not ReadFile(file, _data, (DWORD)file_size.QuadPart, &read_bytes, nullptr)) {
-      goto cleanup;
+      return false;
    }
 
-   result = true;
+   if (_file_path) free(_file_path);
 
-cleanup:
-   if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+   _file_path = copy_string(file_path);
+   _dll_name = nullptr;
+   _edit_imports = false;
 
-   return result;
+   return _file_path != nullptr;
 }
 
 bool exe_patcher::add_dll(const char* dll_name)
 {
-   DetourBinaryResetImports(_detour_binary);
+   if (not _file.data()) return false;
 
-   struct context {
-      const char* dll_name = nullptr;
-      bool added_dll = false;
-   };
+   // Already patched, by this or by the Detours based patcher before it.
+   if (_image.imports(dll_name)) {
+      _dll_name = nullptr;
+      _edit_imports = false;
 
-   context edit_context{.dll_name = dll_name};
-
-   if (not DetourBinaryEditImports(
-          _detour_binary, &edit_context,
-          [](PVOID pContext, LPCSTR pszFile, LPCSTR* ppszOutFile) -> BOOL {
-             context* edit_context = (context*)pContext;
+      return true;
+   }
 
-             if (not pszFile && not edit_context->added_dll) { // Add new byway.
-                edit_context->added_dll = true;
-                *ppszOutFile = edit_context->dll_name;
-             }
+   if (_image.edited_size(dll_name) == 0) return false;
 
-             return TRUE;
-          },
-          nullptr, nullptr, nullptr)) {
-      return false;
-   }
+   _dll_name = dll_name;
+   _edit_imports = true;
 
    return true;
 }
 
-bool exe_patcher::reset_dlls()
-{
-   return DetourBinaryResetImports(_detour_binary) != FALSE;
-}
-
 bool exe_patcher::save(const char* file_path)
 {
-   if (not _detour_binary) return false;
+   if (not _file.data()) return false;
+
+   const bool in_place = strcmp(file_path, _file_path) == 0;
+
+   if (in_place and not _edit_imports) return true;
+
+   const size_t loaded_size = _file.size();
+   const size_t edited_size = _edit_imports ? _image.edited_size(_dll_name) : loaded_size;
+
+   if (edited_size == 0) return false;
+
+   const size_t mapped_size = edited_size > loaded_size ? edited_size : loaded_size;
 
-   char* temp_file_name = aquire_temp_file(file_path, "BF2Patch");
+   // Build the output next to the target and move it over once complete, so a
+   // failure part way through leaves the original file untouched.
+   const size_t path_size = strlen(file_path);
+   char* temp_path = (char*)malloc(path_size + sizeof(".tmp"));
 
-   if (not temp_file_name) return false;
+   if (not temp_path) return false;
 
+   memcpy(temp_path, file_path, path_size);
+   memcpy(temp_path + path_size, ".tmp", sizeof(".tmp"));
+
+   mapped_file output;
+   pe_image output_image;
    bool result = false;
 
-   HANDLE file = CreateFileA(temp_file_name, GENERIC_READ | GENERIC_WRITE, 0, nullptr,
-                             CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+   if (not output.open_write(temp_path, mapped_size)) goto cleanup;
+
+   memcpy(output.data(), _file.data(), loaded_size);
 
-   if (file == INVALID_HANDLE_VALUE) goto cleanup;
+   if (not output_image.parse(output.data(), output.size())) goto cleanup;
 
-   if (not DetourBinaryWrite(_detour_binary, file)) goto cleanup;
+   if (_edit_imports and not output_image.edit_imports(_dll_name, loaded_size)) goto cleanup;
 
-   CloseHandle(file);
-   file = INVALID_HANDLE_VALUE;
+   if (not output.flush()) goto cleanup;
 
-   DetourBinaryClose(_detour_binary);
-   _detour_binary = nullptr;
+   if (mapped_size == edited_size) {
+      output.close();
+   }
+   else if (not output.close_truncated(edited_size)) {
+      goto cleanup;
+   }
 
-   if (not move_file(temp_file_name, file_path)) goto cleanup;
+   // The target may be the input, which has to be unmapped before it's replaced.
+   _file.close();
 
-   result = true;
+   result = replace_file(temp_path, file_path);
 
 cleanup:
-   if (temp_file_name) {
-      remove(temp_file_name);
-      free(temp_file_name);
-   }
-   if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+   _edit_imports = false;
+
+   _file.close();
+   output.close();
+
+   if (not result) remove(temp_path);
+
+   free(temp_path);
 
    return result;
 }
@@ -131,12 +129,12 @@ cleanup:
 bool exe_patcher::compatible(uint32_t id_address, uint64_t expected_id)
 {
    // Bounds and overflow Checks
-   if (id_address + sizeof(uint64_t) >= _size) return false;
+   if (id_address + sizeof(uint64_t) >= _file.size()) return false;
    if (id_address + sizeof(uint64_t) < id_address) return false;
 
    uint64_t exe_id = 0;
 
-   memcpy(&exe_id, _data + id_address, sizeof(uint64_t));
+   memcpy(&exe_id, _file.data() + id_address, sizeof(uint64_t));
 
    return exe_id == expected_id;
 }
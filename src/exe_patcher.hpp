@@ -1,23 +1,29 @@
 #pragma once
 
+#include "mapped_file.hpp"
+#include "pe_image.hpp"
+
 #include <stdint.h>
 
 struct exe_patcher {
    ~exe_patcher();
 
-   [[nodiscard]] bool load(const char* file_path);
+   /// @brief Map an executable for patching.
+   /// @param not_an_image Set if the file opened but isn't a PE32 image.
+   [[nodiscard]] bool load(const char* file_path, bool* not_an_image = nullptr);
 
    [[nodiscard]] bool add_dll(const char* dll_name);
 
-   [[nodiscard]] bool reset_dlls();
-
    [[nodiscard]] bool save(const char* file_path);
 
    [[nodiscard]] bool compatible(uint32_t id_address, uint64_t expected_id);
 
 private:
-   void* _detour_binary = nullptr;
+   mapped_file _file;
+   pe_image _image;
+
+   char* _file_path = nullptr;
 
-   uint8_t* _data = nullptr;
-   size_t _size = 0;
+   const char* _dll_name = nullptr;
+   bool _edit_imports = false;
 };
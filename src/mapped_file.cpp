@@ -0,0 +1,250 @@
+#include "mapped_file.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+mapped_file::~mapped_file()
+{
+   close();
+}
+
+#ifdef _WIN32
+
+static bool set_file_size(HANDLE file, size_t size)
+{
+   LARGE_INTEGER distance = {};
+   distance.QuadPart = (LONGLONG)size;
+
+   if (not SetFilePointerEx(file, distance, nullptr, FILE_BEGIN)) return false;
+
+   return SetEndOfFile(file) != FALSE;
+}
+
+bool mapped_file::open_read(const char* file_path)
+{
+   close();
+
+   HANDLE file = CreateFileA(file_path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                             FILE_ATTRIBUTE_NORMAL, nullptr);
+
+   if (file == INVALID_HANDLE_VALUE) return false;
+
+   _file = (intptr_t)file;
+
+   LARGE_INTEGER file_size = {};
+
+   if (not GetFileSizeEx(file, &file_size) or file_size.QuadPart > UINT32_MAX) {
+      close();
+
+      return false;
+   }
+
+   _size = (size_t)file_size.QuadPart;
+
+   return map(false);
+}
+
+bool mapped_file::open_write(const char* file_path, size_t size)
+{
+   close();
+
+   HANDLE file = CreateFileA(file_path, GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_ALWAYS,
+                             FILE_ATTRIBUTE_NORMAL, nullptr);
+
+   if (file == INVALID_HANDLE_VALUE) return false;
+
+   _file = (intptr_t)file;
+   _size = size;
+
+   if (not set_file_size(file, size)) {
+      close();
+
+      return false;
+   }
+
+   return map(true);
+}
+
+bool mapped_file::map(bool writable)
+{
+   if (_size == 0) {
+      close();
+
+      return false;
+   }
+
+   _mapping = CreateFileMappingA((HANDLE)_file, nullptr, writable ? PAGE_READWRITE : PAGE_WRITECOPY,
+                                 0, 0, nullptr);
+
+   if (_mapping) {
+      _data = (uint8_t*)MapViewOfFile((HANDLE)_mapping, writable ? FILE_MAP_WRITE : FILE_MAP_COPY,
+                                      0, 0, _size);
+   }
+
+   if (not _data) {
+      close();
+
+      return false;
+   }
+
+   return true;
+}
+
+void mapped_file::unmap()
+{
+   if (_data) UnmapViewOfFile(_data);
+   if (_mapping) CloseHandle((HANDLE)_mapping);
+
+   _data = nullptr;
+   _mapping = nullptr;
+}
+
+bool mapped_file::flush()
+{
+   if (not _data) return false;
+
+   return FlushViewOfFile(_data, _size) and FlushFileBuffers((HANDLE)_file);
+}
+
+void mapped_file::close()
+{
+   unmap();
+
+   if (_file != -1) CloseHandle((HANDLE)_file);
+
+   _file = -1;
+   _size = 0;
+}
+
+bool mapped_file::close_truncated(size_t size)
+{
+   unmap();
+
+   const bool result = _file != -1 and set_file_size((HANDLE)_file, size);
+
+   close();
+
+   return result;
+}
+
+bool replace_file(const char* from, const char* to)
+{
+   return MoveFileExA(from, to, MOVEFILE_REPLACE_EXISTING | MOVEFILE_COPY_ALLOWED) != 0;
+}
+
+#else
+
+bool mapped_file::open_read(const char* file_path)
+{
+   close();
+
+   const int file = open(file_path, O_RDONLY);
+
+   if (file < 0) return false;
+
+   _file = file;
+
+   struct stat file_stat = {};
+
+   if (fstat(file, &file_stat) != 0 or (uint64_t)file_stat.st_size > UINT32_MAX) {
+      close();
+
+      return false;
+   }
+
+   _size = (size_t)file_stat.st_size;
+
+   return map(false);
+}
+
+bool mapped_file::open_write(const char* file_path, size_t size)
+{
+   close();
+
+   const int file = open(file_path, O_RDWR | O_CREAT, 0644);
+
+   if (file < 0) return false;
+
+   _file = file;
+   _size = size;
+
+   if (ftruncate(file, (off_t)size) != 0) {
+      close();
+
+      return false;
+   }
+
+   return map(true);
+}
+
+bool mapped_file::map(bool writable)
+{
+   if (_size == 0) {
+      close();
+
+      return false;
+   }
+
+   void* data = mmap(nullptr, _size, PROT_READ | PROT_WRITE, writable ? MAP_SHARED : MAP_PRIVATE,
+                     (int)_file, 0);
+
+   if (data == MAP_FAILED) {
+      close();
+
+      return false;
+   }
+
+   _data = (uint8_t*)data;
+
+   return true;
+}
+
+void mapped_file::unmap()
+{
+   if (_data) munmap(_data, _size);
+
+   _data = nullptr;
+}
+
+bool mapped_file::flush()
+{
+   if (not _data) return false;
+
+   return msync(_data, _size, MS_SYNC) == 0;
+}
+
+void mapped_file::close()
+{
+   unmap();
+
+   if (_file != -1) ::close((int)_file);
+
+   _file = -1;
+   _size = 0;
+}
+
+bool mapped_file::close_truncated(size_t size)
+{
+   unmap();
+
+   const bool result = _file != -1 and ftruncate((int)_file, (off_t)size) == 0;
+
+   close();
+
+   return result;
+}
+
+bool replace_file(const char* from, const char* to)
+{
+   return rename(from, to) == 0;
+}
+
+#endif
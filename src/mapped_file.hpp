@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/// @brief A file mapped into memory. Windows file mappings or POSIX mmap.
+struct mapped_file {
+   mapped_file() = default;
+   mapped_file(const mapped_file&) = delete;
+   mapped_file& operator=(const mapped_file&) = delete;
+
+   ~mapped_file();
+
+   /// @brief Map a file for reading. Writes to the view stay private to this process.
+   /// @param file_path The file to map.
+   /// @return If mapping the file succeeded or not.
+   [[nodiscard]] bool open_read(const char* file_path);
+
+   /// @brief Map a file for writing, creating it if it doesn't exist.
+   /// @param file_path The file to map.
+   /// @param size The size to grow or shrink the file to before mapping it. Bytes added are zero.
+   /// @return If mapping the file succeeded or not.
+   [[nodiscard]] bool open_write(const char* file_path, size_t size);
+
+   /// @brief Write changes made through the view back to the file.
+   /// @return If flushing succeeded or not.
+   [[nodiscard]] bool flush();
+
+   /// @brief Unmap the file and close it.
+   void close();
+
+   /// @brief Unmap the file and cut it to a smaller size.
+   /// @param size The size to truncate the file to.
+   /// @return If truncating the file succeeded or not.
+   [[nodiscard]] bool close_truncated(size_t size);
+
+   uint8_t* data() const noexcept
+   {
+      return _data;
+   }
+
+   size_t size() const noexcept
+   {
+      return _size;
+   }
+
+private:
+   [[nodiscard]] bool map(bool writable);
+
+   void unmap();
+
+   intptr_t _file = -1; // HANDLE on Windows, file descriptor elsewhere
+   void* _mapping = nullptr;
+
+   uint8_t* _data = nullptr;
+   size_t _size = 0;
+};
+
+/// @brief Move a file over another, replacing it if it exists.
+/// @param from The file to move.
+/// @param to The path to move it to.
+/// @return If moving the file succeeded or not.
+[[nodiscard]] bool replace_file(const char* from, const char* to);
@@ -0,0 +1,396 @@
+#include "pe_image.hpp"
+
+#include <string.h>
+
+// Offsets into the PE headers. See IMAGE_NT_HEADERS32 in winnt.h.
+static constexpr uint32_t dos_nt_headers_offset = 0x3c;
+static constexpr uint32_t nt_optional_header = 24;
+static constexpr uint32_t file_section_count = 4 + 2;
+static constexpr uint32_t file_optional_header_size = 4 + 16;
+
+static constexpr uint32_t optional_magic = 0;
+static constexpr uint32_t optional_section_alignment = 32;
+static constexpr uint32_t optional_file_alignment = 36;
+static constexpr uint32_t optional_image_size = 56;
+static constexpr uint32_t optional_headers_size = 60;
+static constexpr uint32_t optional_directory_count = 92;
+static constexpr uint32_t optional_directories = 96;
+
+static constexpr uint32_t directory_import = 1;
+static constexpr uint32_t directory_bound_import = 11;
+
+static constexpr uint32_t section_header_size = 40;
+static constexpr uint32_t section_virtual_size = 8;
+static constexpr uint32_t section_virtual_address = 12;
+static constexpr uint32_t section_raw_size = 16;
+static constexpr uint32_t section_raw_pointer = 20;
+static constexpr uint32_t section_characteristics = 36;
+
+static constexpr uint32_t section_code = 0x00000020;
+static constexpr uint32_t section_added_characteristics = 0xc0000040; // initialized data, read, write
+
+static constexpr uint32_t descriptor_size = 20;
+static constexpr uint32_t descriptor_original_thunk = 0;
+static constexpr uint32_t descriptor_time_stamp = 4;
+static constexpr uint32_t descriptor_forwarder_chain = 8;
+static constexpr uint32_t descriptor_name = 12;
+static constexpr uint32_t descriptor_thunk = 16;
+static constexpr uint32_t descriptor_max_count = 4096;
+
+static constexpr uint32_t import_by_ordinal_1 = 0x80000001;
+
+// Layout of the added section.
+static constexpr char added_section_name[8] = ".bf2ext";
+static constexpr char added_magic[8] = "BF2GExt";
+static constexpr uint32_t added_import_rva = 8;
+static constexpr uint32_t added_bound_rva = 16;
+static constexpr uint32_t added_descriptors = 32;
+
+static uint32_t read_u16(const uint8_t* at)
+{
+   uint16_t value = 0;
+
+   memcpy(&value, at, sizeof(value));
+
+   return value;
+}
+
+static uint32_t read_u32(const uint8_t* at)
+{
+   uint32_t value = 0;
+
+   memcpy(&value, at, sizeof(value));
+
+   return value;
+}
+
+static void write_u16(uint8_t* at, uint32_t value)
+{
+   const uint16_t value_16 = (uint16_t)value;
+
+   memcpy(at, &value_16, sizeof(value_16));
+}
+
+static void write_u32(uint8_t* at, uint32_t value)
+{
+   memcpy(at, &value, sizeof(value));
+}
+
+static size_t align_up(size_t value, size_t alignment)
+{
+   return (value + alignment - 1) / alignment * alignment;
+}
+
+static bool ascii_iequal(const char* left, const char* right, size_t right_max)
+{
+   for (size_t i = 0; i < right_max; ++i) {
+      char l = left[i];
+      char r = right[i];
+
+      if (l >= 'A' and l <= 'Z') l += 'a' - 'A';
+      if (r >= 'A' and r <= 'Z') r += 'a' - 'A';
+
+      if (l != r) return false;
+      if (l == '\0') return true;
+   }
+
+   return false;
+}
+
+struct added_layout {
+   uint32_t descriptors = 0;
+   uint32_t name_thunks = 0;
+   uint32_t address_thunks = 0;
+   uint32_t name = 0;
+   uint32_t size = 0;
+};
+
+static added_layout layout_added_section(uint32_t original_descriptors, size_t dll_name_length)
+{
+   added_layout layout;
+
+   // The new descriptor, the originals, then the terminator.
+   layout.descriptors = added_descriptors;
+   layout.name_thunks = (uint32_t)align_up(layout.descriptors + (original_descriptors + 2) * descriptor_size, 8);
+   layout.address_thunks = layout.name_thunks + 8;
+   layout.name = layout.address_thunks + 8;
+   layout.size = layout.name + (uint32_t)dll_name_length + 1;
+
+   return layout;
+}
+
+bool pe_image::parse(uint8_t* data, size_t size)
+{
+   *this = pe_image{};
+
+   if (size < 0x40 or size > UINT32_MAX) return false;
+   if (data[0] != 'M' or data[1] != 'Z') return false;
+
+   const uint32_t nt_headers = read_u32(data + dos_nt_headers_offset);
+
+   if ((uint64_t)nt_headers + nt_optional_header + optional_directories > size) return false;
+   if (memcmp(data + nt_headers, "PE\0\0", 4) != 0) return false;
+
+   const uint32_t optional_header = nt_headers + nt_optional_header;
+   const uint32_t optional_header_size = read_u16(data + nt_headers + file_optional_header_size);
+
+   if (read_u16(data + optional_header + optional_magic) != 0x10b) return false; // PE32 only
+   if (read_u32(data + optional_header + optional_directory_count) <= directory_bound_import) return false;
+   if (optional_header_size < optional_directories + (directory_bound_import + 1) * 8) return false;
+
+   _optional_header = optional_header;
+   _section_table = optional_header + optional_header_size;
+   _section_count = read_u16(data + nt_headers + file_section_count);
+   _headers_size = read_u32(data + optional_header + optional_headers_size);
+   _section_alignment = read_u32(data + optional_header + optional_section_alignment);
+   _file_alignment = read_u32(data + optional_header + optional_file_alignment);
+
+   if (_section_count == 0) return false;
+   if (_section_table + (uint64_t)_section_count * section_header_size > size) return false;
+   if (_section_alignment == 0 or _file_alignment == 0) return false;
+
+   _data = data;
+   _size = size;
+
+   return true;
+}
+
+bool pe_image::imports(const char* dll_name) const noexcept
+{
+   const uint8_t* directory = _data + _optional_header + optional_directories + directory_import * 8;
+   const uint32_t import_rva = read_u32(directory);
+
+   for (uint32_t i = 0; i < descriptor_max_count; ++i) {
+      const uint32_t descriptor = rva_to_offset(import_rva + i * descriptor_size, descriptor_size);
+
+      if (descriptor == 0) return false;
+
+      const uint32_t name_rva = read_u32(_data + descriptor + descriptor_name);
+
+      if (name_rva == 0 and read_u32(_data + descriptor + descriptor_thunk) == 0) return false;
+
+      const uint32_t name = rva_to_offset(name_rva, 1);
+
+      if (name != 0 and ascii_iequal(dll_name, (const char*)_data + name, _size - name)) {
+         return true;
+      }
+   }
+
+   return false;
+}
+
+size_t pe_image::edited_size(const char* dll_name) const noexcept
+{
+   return edited_size(dll_name, _size);
+}
+
+size_t pe_image::edited_size(const char* dll_name, size_t file_size) const noexcept
+{
+   const int added = added_section();
+   const size_t end = added >= 0 ? read_u32(_data + section_offset(added) + section_raw_pointer) : file_size;
+
+   if (not dll_name) return end;
+
+   const uint32_t section_count = added >= 0 ? _section_count - 1 : _section_count;
+   const uint32_t new_header = _section_table + section_count * section_header_size;
+
+   // The new section header has to fit between the section table and the first section.
+   if (new_header + section_header_size > _headers_size) return 0;
+
+   for (uint32_t i = 0; i < section_count; ++i) {
+      const uint8_t* section = _data + section_offset(i);
+
+      if (read_u32(section + section_raw_size) != 0 and
+          read_u32(section + section_raw_pointer) < new_header + section_header_size) {
+         return 0;
+      }
+   }
+
+   if (added < 0) {
+      for (uint32_t i = 0; i < section_header_size; ++i) {
+         if (_data[new_header + i] != 0) return 0;
+      }
+   }
+
+   const added_layout layout = layout_added_section(import_descriptor_count(), strlen(dll_name));
+
+   return align_up(end, _file_alignment) + align_up(layout.size, _file_alignment);
+}
+
+bool pe_image::edit_imports(const char* dll_name, size_t file_size) noexcept
+{
+   const size_t new_size = edited_size(dll_name, file_size);
+
+   if (new_size == 0 or new_size > _size) return false;
+
+   const uint32_t original_descriptors = import_descriptor_count();
+
+   remove_added_section();
+
+   if (not dll_name) return true;
+
+   uint8_t* const directories = _data + _optional_header + optional_directories;
+   const uint32_t import_rva = read_u32(directories + directory_import * 8);
+
+   // Place the section after the last one, in both the file and memory.
+   size_t virtual_end = _headers_size;
+
+   for (uint32_t i = 0; i < _section_count; ++i) {
+      const uint8_t* section = _data + section_offset(i);
+      const size_t virtual_size = read_u32(section + section_virtual_size);
+      const size_t raw_size = read_u32(section + section_raw_size);
+      const size_t section_end = read_u32(section + section_virtual_address) +
+                                 (virtual_size > raw_size ? virtual_size : raw_size);
+
+      if (section_end > virtual_end) virtual_end = section_end;
+   }
+
+   const added_layout layout = layout_added_section(original_descriptors, strlen(dll_name));
+   const uint32_t raw_size = (uint32_t)align_up(layout.size, _file_alignment);
+   const uint32_t raw_pointer = (uint32_t)(new_size - raw_size);
+   const uint32_t rva = (uint32_t)align_up(virtual_end, _section_alignment);
+
+   uint8_t* const section = _data + raw_pointer;
+
+   memset(section, 0, raw_size);
+   memcpy(section, added_magic, sizeof(added_magic));
+   memcpy(section + added_import_rva, directories + directory_import * 8, 8);
+   memcpy(section + added_bound_rva, directories + directory_bound_import * 8, 8);
+
+   uint8_t* descriptor = section + layout.descriptors;
+
+   write_u32(descriptor + descriptor_original_thunk, rva + layout.name_thunks);
+   write_u32(descriptor + descriptor_name, rva + layout.name);
+   write_u32(descriptor + descriptor_thunk, rva + layout.address_thunks);
+
+   for (uint32_t i = 0; i < original_descriptors; ++i) {
+      descriptor += descriptor_size;
+
+      memcpy(descriptor, _data + rva_to_offset(import_rva + i * descriptor_size, descriptor_size),
+             descriptor_size);
+
+      // The bound import directory is dropped below, so nothing is prebound any more.
+      write_u32(descriptor + descriptor_time_stamp, 0);
+      write_u32(descriptor + descriptor_forwarder_chain, 0);
+   }
+
+   write_u32(section + layout.name_thunks, import_by_ordinal_1);
+   write_u32(section + layout.address_thunks, import_by_ordinal_1);
+   memcpy(section + layout.name, dll_name, strlen(dll_name) + 1);
+
+   uint8_t* const header = _data + _section_table + _section_count * section_header_size;
+
+   memcpy(header, added_section_name, sizeof(added_section_name));
+   write_u32(header + section_virtual_size, layout.size);
+   write_u32(header + section_virtual_address, rva);
+   write_u32(header + section_raw_size, raw_size);
+   write_u32(header + section_raw_pointer, raw_pointer);
+   write_u32(header + section_characteristics, section_added_characteristics);
+
+   _section_count += 1;
+
+   write_u16(_data + _optional_header - nt_optional_header + file_section_count, _section_count);
+   write_u32(_data + _optional_header + optional_image_size,
+             (uint32_t)align_up(rva + layout.size, _section_alignment));
+
+   write_u32(directories + directory_import * 8, rva + layout.descriptors);
+   write_u32(directories + directory_import * 8 + 4, (original_descriptors + 2) * descriptor_size);
+   write_u32(directories + directory_bound_import * 8, 0);
+   write_u32(directories + directory_bound_import * 8 + 4, 0);
+
+   return true;
+}
+
+uint32_t pe_image::rva_to_offset(uint32_t rva, uint32_t size) const noexcept
+{
+   if (rva == 0) return 0;
+
+   if ((uint64_t)rva + size <= _headers_size) {
+      return (uint64_t)rva + size <= _size ? rva : 0;
+   }
+
+   for (uint32_t i = 0; i < _section_count; ++i) {
+      const uint8_t* section = _data + section_offset(i);
+      const uint32_t virtual_address = read_u32(section + section_virtual_address);
+      const uint32_t raw_size = read_u32(section + section_raw_size);
+      const uint32_t raw_pointer = read_u32(section + section_raw_pointer);
+
+      if (rva < virtual_address or (uint64_t)rva - virtual_address + size > raw_size) continue;
+
+      const uint64_t offset = (uint64_t)raw_pointer + (rva - virtual_address);
+
+      return offset + size <= _size ? (uint32_t)offset : 0;
+   }
+
+   return 0;
+}
+
+uint32_t pe_image::section_offset(uint32_t index) const noexcept
+{
+   return _section_table + index * section_header_size;
+}
+
+int pe_image::added_section() const noexcept
+{
+   const uint32_t index = _section_count - 1;
+   const uint8_t* header = _data + section_offset(index);
+
+   if (memcmp(header, added_section_name, sizeof(added_section_name)) != 0) return -1;
+
+   const uint32_t raw_pointer = read_u32(header + section_raw_pointer);
+
+   if (read_u32(header + section_raw_size) < added_descriptors) return -1;
+   if ((uint64_t)raw_pointer + added_descriptors > _size) return -1;
+   if (memcmp(_data + raw_pointer, added_magic, sizeof(added_magic)) != 0) return -1;
+
+   return (int)index;
+}
+
+uint32_t pe_image::import_descriptor_count() const noexcept
+{
+   const int added = added_section();
+
+   // Count the descriptors the executable had before any edit.
+   const uint8_t* directory =
+      added >= 0 ? _data + read_u32(_data + section_offset(added) + section_raw_pointer) + added_import_rva
+                 : _data + _optional_header + optional_directories + directory_import * 8;
+   const uint32_t import_rva = read_u32(directory);
+
+   uint32_t count = 0;
+
+   for (; count < descriptor_max_count; ++count) {
+      const uint32_t descriptor = rva_to_offset(import_rva + count * descriptor_size, descriptor_size);
+
+      if (descriptor == 0) break;
+
+      if (read_u32(_data + descriptor + descriptor_name) == 0 and
+          read_u32(_data + descriptor + descriptor_thunk) == 0) {
+         break;
+      }
+   }
+
+   return count;
+}
+
+void pe_image::remove_added_section() noexcept
+{
+   const int added = added_section();
+
+   if (added < 0) return;
+
+   uint8_t* const header = _data + section_offset(added);
+   const uint8_t* const section = _data + read_u32(header + section_raw_pointer);
+   uint8_t* const directories = _data + _optional_header + optional_directories;
+
+   memcpy(directories + directory_import * 8, section + added_import_rva, 8);
+   memcpy(directories + directory_bound_import * 8, section + added_bound_rva, 8);
+
+   const uint32_t virtual_address = read_u32(header + section_virtual_address);
+
+   memset(header, 0, section_header_size);
+
+   _section_count -= 1;
+
+   write_u16(_data + _optional_header - nt_optional_header + file_section_count, _section_count);
+   write_u32(_data + _optional_header + optional_image_size, virtual_address);
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/// @brief Import table editing for a PE32 executable, done directly on its mapped bytes.
+///
+/// A DLL is added by appending one section, .bf2ext, holding a copy of the import
+/// descriptors with the new DLL first, importing its ordinal #1 (as Detours' byways
+/// do). The section starts with the original import and bound import directories so
+/// the edit can be undone. Nothing else in the image moves.
+struct pe_image {
+   /// @brief Parse the headers of a mapped executable. Parse again after remapping.
+   /// @param data The file's bytes.
+   /// @param size The file's size.
+   /// @return If the file is a PE32 image this can read or not.
+   [[nodiscard]] bool parse(uint8_t* data, size_t size);
+
+   /// @brief Check if the import table lists a DLL. Names are compared case insensitively.
+   /// @param dll_name The DLL's file name.
+   /// @return If the DLL is imported or not.
+   [[nodiscard]] bool imports(const char* dll_name) const noexcept;
+
+   /// @brief Check if an earlier edit_imports added a .bf2ext section.
+
+   /// @brief The file size once edit_imports has run.
+   /// @param dll_name The DLL to add, or null to only undo an earlier edit.
+   /// @return The size, or 0 if there is no room in the headers for another section.
+   [[nodiscard]] size_t edited_size(const char* dll_name) const noexcept;
+
+   /// @brief Undo an earlier edit and add a DLL import, in place. The mapping must already
+   /// be at least edited_size(dll_name) bytes long (see mapped_file::open_write).
+   /// @param dll_name The DLL to add, or null to only undo an earlier edit.
+   /// @param file_size The file's size before its mapping was grown.
+   /// @return If editing the imports succeeded or not.
+   [[nodiscard]] bool edit_imports(const char* dll_name, size_t file_size) noexcept;
+
+private:
+   [[nodiscard]] size_t edited_size(const char* dll_name, size_t file_size) const noexcept;
+
+   [[nodiscard]] uint32_t rva_to_offset(uint32_t rva, uint32_t size) const noexcept;
+
+   [[nodiscard]] uint32_t section_offset(uint32_t index) const noexcept;
+
+   [[nodiscard]] int added_section() const noexcept;
+
+   [[nodiscard]] uint32_t import_descriptor_count() const noexcept;
+
+   void remove_added_section() noexcept;
+
+   uint8_t* _data = nullptr;
+   size_t _size = 0;
+
+   uint32_t _optional_header = 0;
+   uint32_t _section_table = 0;
+   uint32_t _section_count = 0;
+   uint32_t _headers_size = 0;
+   uint32_t _section_alignment = 0;
+   uint32_t _file_alignment = 0;
+};